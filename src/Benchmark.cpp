@@ -0,0 +1,439 @@
+#include "Template_Library/Basic_Functions.h"
+#include "Template_Library/Basic_Structures.h"
+#include "Primitive_Types/CNF_Formula.h"
+#include "Compilers/CCDD_Compiler.h"
+#include "Counters/KCounter.h"
+#include <map>
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace KCBox;
+
+
+/****************************************************************************************************
+*                                                                                                   *
+*                                         Parameters                                                *
+*                                                                                                   *
+****************************************************************************************************/
+
+struct Benchmark_Parameters: public Tool_Parameters
+{
+	IntOption repeat;
+	IntOption cpu;
+	StringOption phases;
+	FloatOption memo;
+	IntOption samples;
+	StringOption csv;
+	StringOption json;
+	StringOption baseline;
+	FloatOption threshold;
+	FloatOption noise;
+	Benchmark_Parameters( const char * tool_name ): Tool_Parameters( tool_name ),
+		repeat( "--repeat", "the number of runs of each phase on each instance", 3, 1, 1000 ),
+		cpu( "--cpu", "the CPU to which the runs are pinned (-1 means no pinning)", 0, -1, 1023 ),
+		phases( "--phases", "the comma-separated phases among parse, preprocess, count, compile, sample and condition", "parse,preprocess,count,compile,sample,condition" ),
+		memo( "--memo", "the available memory in GB of counting and compiling", 4 ),
+		samples( "--samples", "the number of samples, and also the number of conditions", 100, 1, 1000000 ),
+		csv( "--csv", "the CSV file to which the runs are written", nullptr ),
+		json( "--json", "the JSON file to which the runs are written", nullptr ),
+		baseline( "--baseline", "the CSV file of an earlier run to compare with", nullptr ),
+		threshold( "--threshold", "the tolerated relative slowdown of the median wall time", 0.1 ),
+		noise( "--noise", "the slowdown in seconds which is always tolerated", 0.05 )
+	{
+		Add_Option( &repeat );
+		Add_Option( &cpu );
+		Add_Option( &phases );
+		Add_Option( &memo );
+		Add_Option( &samples );
+		Add_Option( &csv );
+		Add_Option( &json );
+		Add_Option( &baseline );
+		Add_Option( &threshold );
+		Add_Option( &noise );
+	}
+	bool Parse_Parameters( int & i, int argc, const char *argv[] )
+	{
+		if ( !Tool_Parameters::Parse_Parameters( i, argc, argv ) ) return false;
+		if ( threshold < 0 || noise < 0 || memo <= 0 ) {
+			cerr << "ERROR: --threshold and --noise must be nonnegative, and --memo must be positive!" << endl;
+			return false;
+		}
+		return true;
+	}
+} bench_parameters( "kcbox-bench" );
+
+
+/****************************************************************************************************
+*                                                                                                   *
+*                                           Phases                                                  *
+*                                                                                                   *
+****************************************************************************************************/
+
+enum Benchmark_Phase
+{
+	phase_parse = 0,
+	phase_preprocess,
+	phase_count,
+	phase_compile,
+	phase_sample,
+	phase_condition,
+	phase_invalid
+};
+
+const char * phase_names[] = {"parse", "preprocess", "count", "compile", "sample", "condition"};
+
+Benchmark_Phase Parse_Phase( const string & name )
+{
+	for ( unsigned i = 0; i < phase_invalid; i++ ) {
+		if ( name == phase_names[i] ) return Benchmark_Phase( i );
+	}
+	return phase_invalid;
+}
+
+struct Benchmark_Run
+{
+	string instance;
+	Benchmark_Phase phase;
+	unsigned rep;
+	double wall;  // in seconds
+	double cpu;  // in seconds, user plus system
+	size_t peak_rss;  // in KB
+	bool ok;
+};
+
+double CPU_Seconds()
+{
+	struct rusage usage;
+	getrusage( RUSAGE_SELF, &usage );
+	return usage.ru_utime.tv_sec + usage.ru_stime.tv_sec + ( usage.ru_utime.tv_usec + usage.ru_stime.tv_usec ) / 1000000.0;
+}
+
+CDDiagram Compile_CCDD( CCDD_Manager & manager, CNF_Formula & cnf )
+{
+	CCDD_Compiler compiler;
+	compiler.running_options.max_memory = bench_parameters.memo;
+	compiler.running_options.removing_redundant_nodes_trigger *= bench_parameters.memo / 4;
+	compiler.running_options.display_compiling_process = false;
+	compiler.running_options.display_kernelizing_process = false;
+	compiler.running_options.profile_solving = Profiling_Close;
+	compiler.running_options.profile_preprocessing = Profiling_Close;
+	compiler.running_options.profile_compiling = Profiling_Close;
+	return compiler.Compile( manager, cnf, AutomaticalHeur );
+}
+
+void Run_Phase( const char * infile, Benchmark_Phase phase, double & wall, double & cpu )  /// NOTE: only the phase itself is timed, and its prerequisites are not
+{
+	StopWatch watch;
+	double cpu_begin = 0;
+	if ( phase == phase_parse ) {
+		watch.Start();
+		cpu_begin = CPU_Seconds();
+	}
+	ifstream fin( infile );
+	CNF_Formula cnf( fin );
+	fin.close();
+	Random_Generator rand_gen( 0 );
+	if ( phase == phase_parse ) {}
+	else if ( phase == phase_preprocess ) {
+		Preprocessor preprocessor;
+		preprocessor.running_options.display_preprocessing_process = false;
+		preprocessor.running_options.profile_solving = Profiling_Close;
+		preprocessor.running_options.profile_preprocessing = Profiling_Close;
+		vector<Model *> models;
+		watch.Start();
+		cpu_begin = CPU_Seconds();
+		preprocessor.Preprocess( cnf, models );
+	}
+	else if ( phase == phase_count ) {
+		KCounter counter;
+		counter.running_options.max_memory = bench_parameters.memo;
+		counter.running_options.display_counting_process = false;
+		counter.running_options.display_kernelizing_process = false;
+		counter.running_options.profile_solving = Profiling_Close;
+		counter.running_options.profile_preprocessing = Profiling_Close;
+		counter.running_options.profile_counting = Profiling_Close;
+		watch.Start();
+		cpu_begin = CPU_Seconds();
+		counter.Count_Models( cnf, AutomaticalHeur );
+	}
+	else if ( cnf.Max_Var() == Variable::undef ) {  // no variables to compile
+		watch.Start();
+		cpu_begin = CPU_Seconds();
+	}
+	else if ( phase == phase_compile ) {
+		CCDD_Manager manager( cnf.Max_Var(), Fit_Hash_Table_Size( cnf.Num_Vars(), cnf.Num_Clauses(), 0, bench_parameters.memo ) );
+		watch.Start();
+		cpu_begin = CPU_Seconds();
+		Compile_CCDD( manager, cnf );
+	}
+	else {
+		CCDD_Manager manager( cnf.Max_Var(), Fit_Hash_Table_Size( cnf.Num_Vars(), cnf.Num_Clauses(), 0, bench_parameters.memo ) );
+		CDDiagram ccdd = Compile_CCDD( manager, cnf );
+		if ( phase == phase_sample ) {
+			vector<vector<bool>> samples( bench_parameters.samples );
+			watch.Start();
+			cpu_begin = CPU_Seconds();
+			manager.Uniformly_Sample( rand_gen, ccdd, samples );
+		}
+		else {
+			vector<vector<Literal>> terms( bench_parameters.samples );
+			for ( vector<Literal> & term: terms ) {  // each condition assigns a random variable
+				Variable var( rand_gen.Generate_Int( Variable::start, manager.Max_Var() ) );
+				term.push_back( Literal( var, rand_gen.Generate_Bool( 0.5 ) ) );
+			}
+			watch.Start();
+			cpu_begin = CPU_Seconds();
+			for ( vector<Literal> & term: terms ) {
+				manager.Count_Models_With_Condition( ccdd, term );
+			}
+		}
+	}
+	wall = watch.Get_Elapsed_Seconds();
+	cpu = CPU_Seconds() - cpu_begin;
+}
+
+bool Fork_Run( const char * infile, Benchmark_Phase phase, Benchmark_Run & run )
+{
+	/* NOTE:
+	* Each run takes a fresh process, so the runs do not share memory or caches, the peak RSS is that of
+	* the run only (including its prerequisites such as parsing), and a crash does not stop the benchmark
+	*/
+	int fds[2];
+	if ( pipe( fds ) != 0 ) {
+		cerr << "ERROR[kcbox-bench]: cannot create a pipe!" << endl;
+		exit( 1 );
+	}
+	cout.flush();
+	pid_t pid = fork();
+	if ( pid < 0 ) {
+		cerr << "ERROR[kcbox-bench]: cannot fork!" << endl;
+		exit( 1 );
+	}
+	if ( pid == 0 ) {
+		close( fds[0] );
+		if ( freopen( "/dev/null", "w", stdout ) == nullptr ) _exit( 1 );
+		double values[3];
+		Run_Phase( infile, phase, values[0], values[1] );
+		values[2] = Peak_Used_Memory() / 1024;  // in KB
+		ssize_t written = write( fds[1], values, sizeof(values) );
+		close( fds[1] );
+		_exit( written == sizeof(values) ? 0 : 1 );
+	}
+	close( fds[1] );
+	double values[3];
+	ssize_t num_read = read( fds[0], values, sizeof(values) );
+	close( fds[0] );
+	int status;
+	waitpid( pid, &status, 0 );
+	run.ok = num_read == sizeof(values) && WIFEXITED( status ) && WEXITSTATUS( status ) == 0;
+	run.wall = run.ok ? values[0] : 0;
+	run.cpu = run.ok ? values[1] : 0;
+	run.peak_rss = run.ok ? values[2] : 0;
+	return run.ok;
+}
+
+
+/****************************************************************************************************
+*                                                                                                   *
+*                                          Reports                                                  *
+*                                                                                                   *
+****************************************************************************************************/
+
+void Write_CSV( ostream & out, vector<Benchmark_Run> & runs )
+{
+	out << "instance,phase,rep,wall,cpu,peak_rss_kb,ok" << endl;
+	for ( Benchmark_Run & run: runs ) {
+		out << run.instance << "," << phase_names[run.phase] << "," << run.rep << ",";
+		out << run.wall << "," << run.cpu << "," << run.peak_rss << "," << run.ok << endl;
+	}
+}
+
+void Write_JSON( ostream & out, vector<Benchmark_Run> & runs )
+{
+	out << "[" << endl;
+	for ( unsigned i = 0; i < runs.size(); i++ ) {
+		Benchmark_Run & run = runs[i];
+		out << "  {\"instance\": \"" << run.instance << "\", \"phase\": \"" << phase_names[run.phase] << "\", \"rep\": " << run.rep;
+		out << ", \"wall\": " << run.wall << ", \"cpu\": " << run.cpu << ", \"peak_rss_kb\": " << run.peak_rss;
+		out << ", \"ok\": " << ( run.ok ? "true" : "false" ) << "}" << ( i + 1 < runs.size() ? "," : "" ) << endl;
+	}
+	out << "]" << endl;
+}
+
+bool Read_CSV( const char * file, vector<Benchmark_Run> & runs )
+{
+	ifstream fin( file );
+	if ( !fin.is_open() ) return false;
+	string line;
+	getline( fin, line );  // header
+	while ( getline( fin, line ) ) {
+		if ( line.empty() ) continue;
+		vector<string> fields;
+		size_t begin = 0, end;
+		while ( ( end = line.find( ',', begin ) ) != string::npos ) {
+			fields.push_back( line.substr( begin, end - begin ) );
+			begin = end + 1;
+		}
+		fields.push_back( line.substr( begin ) );
+		if ( fields.size() != 7 || Parse_Phase( fields[1] ) == phase_invalid ) return false;
+		Benchmark_Run run;
+		run.instance = fields[0];
+		run.phase = Parse_Phase( fields[1] );
+		run.rep = atoi( fields[2].c_str() );
+		run.wall = atof( fields[3].c_str() );
+		run.cpu = atof( fields[4].c_str() );
+		run.peak_rss = atol( fields[5].c_str() );
+		run.ok = fields[6] == "1";
+		runs.push_back( run );
+	}
+	return true;
+}
+
+map<pair<string, unsigned>, double> Median_Wall_Times( vector<Benchmark_Run> & runs )
+{
+	map<pair<string, unsigned>, vector<double>> times;
+	for ( Benchmark_Run & run: runs ) {
+		if ( run.ok ) times[make_pair( run.instance, (unsigned) run.phase )].push_back( run.wall );
+	}
+	map<pair<string, unsigned>, double> medians;
+	for ( auto & item: times ) {
+		vector<double> & values = item.second;
+		sort( values.begin(), values.end() );
+		unsigned mid = values.size() / 2;
+		medians[item.first] = values.size() % 2 == 1 ? values[mid] : ( values[mid - 1] + values[mid] ) / 2;
+	}
+	return medians;
+}
+
+unsigned Compare_With_Baseline( vector<Benchmark_Run> & runs, vector<Benchmark_Run> & baseline_runs )  // return the number of regressions
+{
+	map<pair<string, unsigned>, double> current = Median_Wall_Times( runs );
+	map<pair<string, unsigned>, double> baseline = Median_Wall_Times( baseline_runs );
+	unsigned num_regressions = 0;
+	cout << "instance phase baseline current ratio" << endl;
+	for ( auto & item: current ) {
+		auto itr = baseline.find( item.first );
+		if ( itr == baseline.end() ) continue;
+		double ratio = itr->second > 0 ? item.second / itr->second : 1;
+		bool regression = item.second > itr->second * ( 1 + bench_parameters.threshold ) + bench_parameters.noise;
+		cout << item.first.first << " " << phase_names[item.first.second] << " " << itr->second << " " << item.second << " " << ratio;
+		if ( regression ) cout << " REGRESSION";
+		cout << endl;
+		num_regressions += regression;
+	}
+	return num_regressions;
+}
+
+
+/****************************************************************************************************
+*                                                                                                   *
+*                                            Main                                                   *
+*                                                                                                   *
+****************************************************************************************************/
+
+vector<string> Read_Manifest( const char * manifest )  /// NOTE: one cnf file per line, '#' starts a comment, and relative paths are relative to the manifest
+{
+	ifstream fin( manifest );
+	if ( !fin.is_open() ) {
+		cerr << "ERROR[kcbox-bench]: cannot open " << manifest << "!" << endl;
+		exit( 1 );
+	}
+	string dir( manifest );
+	size_t pos = dir.find_last_of( '/' );
+	dir = pos == string::npos ? "" : dir.substr( 0, pos + 1 );
+	vector<string> instances;
+	string line;
+	while ( getline( fin, line ) ) {
+		line = line.substr( 0, line.find( '#' ) );
+		size_t begin = line.find_first_not_of( " \t\r" );
+		if ( begin == string::npos ) continue;
+		line = line.substr( begin, line.find_last_not_of( " \t\r" ) - begin + 1 );
+		instances.push_back( line[0] == '/' ? line : dir + line );
+	}
+	return instances;
+}
+
+vector<Benchmark_Phase> Parse_Phases( const char * names )
+{
+	vector<Benchmark_Phase> phases;
+	string list( names );
+	size_t begin = 0, end;
+	do {
+		end = list.find( ',', begin );
+		string name = list.substr( begin, end == string::npos ? string::npos : end - begin );
+		Benchmark_Phase phase = Parse_Phase( name );
+		if ( phase == phase_invalid ) {
+			cerr << "ERROR[kcbox-bench]: invalid phase \"" << name << "\"!" << endl;
+			exit( 1 );
+		}
+		phases.push_back( phase );
+		begin = end + 1;
+	} while ( end != string::npos );
+	return phases;
+}
+
+void Pin_CPU( int cpu )
+{
+#ifdef __linux__
+	cpu_set_t set;
+	CPU_ZERO( &set );
+	CPU_SET( cpu, &set );
+	if ( sched_setaffinity( 0, sizeof(set), &set ) != 0 ) {
+		cerr << "Warning[kcbox-bench]: cannot pin to CPU " << cpu << "!" << endl;
+	}
+#else
+	cerr << "Warning[kcbox-bench]: pinning CPU is only supported on Linux!" << endl;
+#endif
+}
+
+int main( int argc, const char *argv[] )
+{
+	int i = 1;
+	if ( !bench_parameters.Parse_Parameters( i, argc, argv ) || i + 1 != argc ) {
+		cerr << "The usage of kcbox-bench [options] manifest:" << endl;
+		bench_parameters.Helper( cerr );
+		return 1;
+	}
+	vector<string> instances = Read_Manifest( argv[i] );
+	vector<Benchmark_Phase> phases = Parse_Phases( bench_parameters.phases );
+	if ( bench_parameters.cpu >= 0 ) Pin_CPU( bench_parameters.cpu );  // inherited by the forked runs
+	vector<Benchmark_Run> runs;
+	unsigned num_failed = 0;
+	for ( string & instance: instances ) {
+		for ( Benchmark_Phase phase: phases ) {
+			for ( unsigned rep = 0; rep < (unsigned) bench_parameters.repeat; rep++ ) {
+				Benchmark_Run run;
+				run.instance = instance;
+				run.phase = phase;
+				run.rep = rep;
+				if ( !Fork_Run( instance.c_str(), phase, run ) ) num_failed++;
+				cout << instance << " " << phase_names[phase] << " #" << rep << ": ";
+				if ( run.ok ) cout << run.wall << "s wall, " << run.cpu << "s cpu, " << run.peak_rss << " KB peak" << endl;
+				else cout << "failed" << endl;
+				runs.push_back( run );
+			}
+		}
+	}
+	if ( bench_parameters.csv.Exists() ) {
+		ofstream fout( bench_parameters.csv );
+		Write_CSV( fout, runs );
+	}
+	if ( bench_parameters.json.Exists() ) {
+		ofstream fout( bench_parameters.json );
+		Write_JSON( fout, runs );
+	}
+	unsigned num_regressions = 0;
+	if ( bench_parameters.baseline.Exists() ) {
+		vector<Benchmark_Run> baseline_runs;
+		if ( !Read_CSV( bench_parameters.baseline, baseline_runs ) ) {
+			cerr << "ERROR[kcbox-bench]: cannot read the baseline " << bench_parameters.baseline << "!" << endl;
+			return 1;
+		}
+		num_regressions = Compare_With_Baseline( runs, baseline_runs );
+		cout << num_regressions << " regressions over the baseline" << endl;
+	}
+	if ( num_failed > 0 ) cerr << "ERROR[kcbox-bench]: " << num_failed << " runs failed!" << endl;
+	return num_failed > 0 || num_regressions > 0;
+}
@@ -1,6 +1,8 @@
 #include "BDDC_Compiler.h"
 #include <sstream>
 #include <sys/sysinfo.h>
+#include <thread>
+#include <atomic>
 
 
 namespace KCBox {
@@ -67,6 +69,8 @@ Diagram BDDC_Compiler::Compile( OBDDC_Manager & manager, CNF_Formula & cnf, Heur
 	if ( running_options.display_compiling_process ) cout << running_options.display_prefix << "Compiling..." << endl;
 	Allocate_and_Init_Auxiliary_Memory( cnf.Max_Var() );
 	if ( running_options.profile_compiling >= Profiling_Abstract ) begin_watch.Start();
+	_stats_snapshots.Open( running_options.stats_json_file, running_options.stats_interval );
+	budget.Start();
 	assert( _num_levels == 0 && _num_dec_stack == 0 && _num_comp_stack == 0 );
 	running_options.recover_exterior = true;
 	if ( running_options.display_compiling_process ) cout << running_options.display_prefix << "Begin preprocess..." << endl;
@@ -103,16 +107,27 @@ Diagram BDDC_Compiler::Compile( OBDDC_Manager & manager, CNF_Formula & cnf, Heur
 	Gather_Infor_For_Counting();
 	Choose_Running_Options( heur, vorder );
 	if ( heur != FixedLinearOrder ) Reorder_BDDC_Manager( manager );
-	Create_Init_Level();
-	if ( running_options.imp_strategy != SAT_Imp_Computing ) {
+	NodeID result;
+	if ( running_options.compile_num_threads != 1 && Compile_Components_In_Parallel( manager, result ) ) {
 		Recycle_Models( _models_stack[0] );
-		if ( Large_Scale_Problem() ) _model_pool->Free_Unallocated_Models();
-		Compile_With_Implicite_BCP( manager );
+		if ( !budget.Interrupted() ) result = Make_Node_With_Init_Imp( manager, result );
+		Un_BCP( _dec_offsets[--_num_levels] );
+	}
+	else {
+		Create_Init_Level();
+		if ( running_options.imp_strategy != SAT_Imp_Computing ) {
+			Recycle_Models( _models_stack[0] );
+			if ( Large_Scale_Problem() ) _model_pool->Free_Unallocated_Models();
+			Compile_With_Implicite_BCP( manager );
+		}
+		else Compile_With_SAT_Imp_Computing( manager );
+		if ( _num_rsl_stack == 1 ) {
+			_num_rsl_stack--;
+			result = Make_Node_With_Init_Imp( manager, _rsl_stack[0] );
+		}
+		else result = NodeID::bot;  /// NOTE: interrupted by the budget, which the caller needs to check
+		Backtrack();
 	}
-	else Compile_With_SAT_Imp_Computing( manager );
-	_num_rsl_stack--;
-	NodeID result = Make_Node_With_Init_Imp( manager, _rsl_stack[0] );
-	Backtrack();
 	if ( running_options.display_compiling_process && running_options.profile_compiling >= Profiling_Abstract ) statistics.time_compile = begin_watch.Get_Elapsed_Seconds();
 	if ( debug_options.verify_learnts ) Verify_Learnts( cnf );
 	if ( running_options.display_compiling_process ) {
@@ -124,7 +139,7 @@ Diagram BDDC_Compiler::Compile( OBDDC_Manager & manager, CNF_Formula & cnf, Heur
 		}
 	}
 	Reset();
-	if ( debug_options.verify_compilation ) {
+	if ( debug_options.verify_compilation && !budget.Interrupted() ) {
 //		manager.Display_Stat( cout );  // ToRemove
 		manager.Verify_OBDDC( result );
 		manager.Verify_ROBDDC_Finest( result );
@@ -152,6 +167,90 @@ NodeID BDDC_Compiler::Make_Node_With_Init_Imp( OBDDC_Manager & manager, NodeID n
 	return result;
 }
 
+bool BDDC_Compiler::Compile_Components_In_Parallel( OBDDC_Manager & manager, NodeID & result )
+{
+	/* NOTE:
+	* The components of the root are compiled by independent compilers under the variable order of manager, each
+	* with its own decision stack, component cache and unique table.  The results are hash-consed into manager in the
+	* order of components, and since OBDD[AND] is canonical under a fixed order, the result is the same as in sequence.
+	*/
+	unsigned num_threads = running_options.compile_num_threads;
+	if ( num_threads == 0 ) num_threads = std::max( std::thread::hardware_concurrency(), 1u );
+	if ( num_threads == 1 ) return false;
+	StopWatch begin_watch;
+	if ( running_options.profile_compiling >= Profiling_Abstract ) begin_watch.Start();
+	Component root;
+	Generate_Init_Component( root );
+	vector<Component> comps( root.Vars_Size() / 2 + 1 );
+	unsigned num_comps = Dynamic_Decompose_Component( root, comps.data() );
+	if ( num_comps <= 1 ) return false;
+	if ( num_threads > num_comps ) num_threads = num_comps;
+	vector<CNF_Formula *> cnfs( num_comps );
+	vector<unsigned> order( num_comps );
+	for ( unsigned i = 0; i < num_comps; i++ ) {
+		cnfs[i] = Output_Original_Clauses_In_Component( comps[i] );
+		order[i] = i;
+	}
+	sort( order.begin(), order.end(), [&]( unsigned a, unsigned b ) { return comps[a].Vars_Size() > comps[b].Vars_Size(); } );  // the largest first
+	if ( running_options.display_compiling_process ) {
+		cout << running_options.display_prefix << "Compile " << num_comps << " components of the root on " << num_threads << " threads..." << endl;
+	}
+	Running_Options options = running_options;
+	options.compile_num_threads = 1;
+	options.max_memory /= num_threads;
+	options.removing_redundant_nodes_trigger /= num_threads;
+	options.display_compiling_process = false;
+	options.display_preprocessing_process = false;
+	options.profile_solving = Profiling_Close;
+	options.profile_preprocessing = Profiling_Close;
+	options.profile_compiling = Profiling_Close;
+	const Chain & manager_order = manager.Var_Order();
+	vector<OBDDC_Manager *> managers( num_comps );
+	vector<NodeID> roots( num_comps );
+	vector<Run_Status> statuses( num_comps, Run_Done );
+	atomic<unsigned> next( 0 );
+	atomic<bool> stopped( false );
+	auto work = [&]() {
+		for ( unsigned k = next++; k < num_comps && !stopped; k = next++ ) {
+			unsigned i = order[k];
+			BDDC_Compiler compiler;
+			compiler.running_options = options;
+			compiler.debug_options = debug_options;
+			compiler.budget = budget.Share();
+			managers[i] = new OBDDC_Manager( manager_order, LARGE_HASH_TABLE );
+			roots[i] = compiler.Compile( *managers[i], *cnfs[i], FixedLinearOrder, _var_order ).Root();
+			statuses[i] = compiler.budget.Status();
+			if ( compiler.budget.Interrupted() ) stopped = true;
+		}
+	};
+	vector<thread> workers;
+	for ( unsigned i = 0; i < num_threads; i++ ) {
+		workers.emplace_back( work );
+	}
+	for ( thread & worker: workers ) worker.join();
+	if ( stopped ) {  // the components are discarded, and result is bot as in an interrupted search
+		for ( unsigned i = 0; i < num_comps; i++ ) {
+			if ( statuses[i] != Run_Done ) budget.Stop( statuses[i] );
+			delete managers[i];
+			delete cnfs[i];
+		}
+		result = NodeID::bot;
+		return true;
+	}
+	_bddc_rnode.sym = DECOMP_SYMBOL_CONJOIN;
+	_bddc_rnode.ch_size = 0;
+	for ( unsigned i = 0; i < num_comps; i++ ) {
+		_bddc_rnode.Add_Child( manager.Import_Nodes( *managers[i], roots[i] ) );
+		delete managers[i];
+		delete cnfs[i];
+	}
+	result = manager.Add_Decomposition_Node( _bddc_rnode );
+	if ( running_options.display_compiling_process && running_options.profile_compiling >= Profiling_Abstract ) {
+		cout << running_options.display_prefix << "Components compiled in " << begin_watch.Get_Elapsed_Seconds() << "s" << endl;
+	}
+	return true;
+}
+
 void BDDC_Compiler::Reorder_BDDC_Manager( OBDDC_Manager & manager )
 {
 	Chain new_order;
@@ -180,7 +279,7 @@ void BDDC_Compiler::Create_Init_Level()
 	_num_levels = 2;
 	assert( _component_cache.Size() == 0 );
 	if ( running_options.profile_compiling >= Profiling_Abstract ) tmp_watch.Start();
-	_component_cache.Init( _max_var, _old_num_long_clauses, NodeID::undef );
+	_component_cache.Init( _max_var, _old_num_long_clauses, NodeID::undef, Fitted_Table_Size() );
 	_component_cache.Set_Encoding( running_options.cache_encoding );
 	_component_cache.Hit_Component( _comp_stack[0] );
 	if ( running_options.profile_compiling >= Profiling_Abstract ) statistics.time_gen_cnf_cache = tmp_watch.Get_Elapsed_Seconds();
@@ -204,6 +303,7 @@ void BDDC_Compiler::Compile_With_Implicite_BCP( OBDDC_Manager & manager )
 	//		system( "pause" );
 			Display_Comp_And_Decision_Stacks( cerr );  // ToRemove
 		}
+		if ( budget.Active() && budget.Exhausted() ) break;
 		if ( Num_Components_On_Current_Level() <= 1 ) { // decision or preparation
 			switch ( _state_stack[_num_levels - 1] ) {
 			case 0:
@@ -334,7 +434,8 @@ void BDDC_Compiler::Compile_With_Implicite_BCP( OBDDC_Manager & manager )
 			}
 		}
 	}
-	assert( _num_levels == old_num_levels - 1 && _num_rsl_stack == old_num_rsl_stack + 1 );
+	if ( _num_levels == old_num_levels - 1 ) assert( _num_rsl_stack == old_num_rsl_stack + 1 );
+	else Terminate_Compiling();
 }
 
 void BDDC_Compiler::Backjump_Decision( unsigned num_kept_levels )
@@ -368,6 +469,7 @@ NodeID BDDC_Compiler::Make_Node_With_Imp( OBDDC_Manager & manager, NodeID node )
 
 NodeID BDDC_Compiler::Component_Cache_Map_Current_Component()
 {
+	Trace_Scope trace( Trace_Cache_Lookup );
 	StopWatch tmp_watch;
 	if ( running_options.profile_compiling >= Profiling_Abstract ) tmp_watch.Start();
 	Component & comp = Current_Component();
@@ -375,6 +477,7 @@ NodeID BDDC_Compiler::Component_Cache_Map_Current_Component()
 	if ( _component_cache.Entry_Is_Isolated( comp.caching_loc ) ) {
 		Component_Cache_Connect_Current_Component();
 	}
+	if ( _stats_snapshots.Due() ) _stats_snapshots.Write( *this );
 	if ( running_options.profile_compiling >= Profiling_Abstract ) statistics.time_gen_cnf_cache += tmp_watch.Get_Elapsed_Seconds();
 	return _component_cache.Read_Result( loc );
 }
@@ -394,6 +497,15 @@ void BDDC_Compiler::Backtrack()
 	_num_comp_stack = _comp_offsets[_num_levels];
 }
 
+void BDDC_Compiler::Terminate_Compiling()
+{
+	_num_rsl_stack = 0;
+	while ( _num_levels > 1 ) {
+		Recycle_Models( _models_stack[_num_levels - 1] );
+		Backtrack();
+	}
+}
+
 void BDDC_Compiler::Extend_New_Level()
 {
 	_dec_offsets[_num_levels] = _num_dec_stack;
@@ -434,6 +546,7 @@ NodeID BDDC_Compiler::Make_Decision_Node( OBDDC_Manager & manager, NodeID low, N
 
 void BDDC_Compiler::Component_Cache_Clear()
 {
+	Trace_Scope trace( Trace_Cache_Clear );
 	if ( running_options.display_compiling_process ) cout << running_options.display_prefix << "clear cache" << endl;
 	StopWatch watch;
 	if ( running_options.profile_compiling >= Profiling_Abstract ) watch.Start();
@@ -552,6 +665,7 @@ void BDDC_Compiler::Compile_With_SAT_Imp_Computing( OBDDC_Manager & manager )
 	//		system( "pause" );
 			Display_Comp_And_Decision_Stacks( cerr );  // ToRemove
 		}
+		if ( budget.Active() && budget.Exhausted() ) break;
 		if ( Num_Components_On_Current_Level() <= 1 ) { // decision or preparation
 			switch ( _state_stack[_num_levels - 1] ) {
 			case 0:
@@ -649,7 +763,8 @@ void BDDC_Compiler::Compile_With_SAT_Imp_Computing( OBDDC_Manager & manager )
 			}
 		}
 	}
-	assert( _num_levels == 1 && _num_rsl_stack == 1 );
+	if ( _num_levels != 1 ) Terminate_Compiling();
+	assert( _num_rsl_stack == 1 || budget.Interrupted() );
 }
 
 void BDDC_Compiler::Verify_Result_Component( Component & comp, OBDDC_Manager & manager, NodeID result )
@@ -717,6 +832,14 @@ void BDDC_Compiler::Display_Memory_Status( ostream & out )
 	out << running_options.display_prefix << "Total memory: " << Memory() / (1.0 * 1024 * 1024) << "M" << endl;
 }
 
+void BDDC_Compiler::Write_Statistics_JSON( JSON_Writer & writer )
+{
+	Solver::Write_Statistics_JSON( writer );
+	writer.Begin_Object( "component_cache" );
+	_component_cache.Write_JSON( writer );
+	writer.End_Object();
+}
+
 void BDDC_Compiler::Display_Result_Stack( ostream & out )
 {
 	unsigned num = 0;
@@ -765,6 +888,7 @@ Diagram BDDC_Compiler::Compile( OBDD_Manager & manager, CNF_Formula & cnf, Heuri
 	OBDDC_Manager bddc_manager( cnf.Max_Var() );
 	Diagram bddc = Compile( bddc_manager, cnf, heur, vorder );
 	_component_cache.Shrink_To_Fit();
+	if ( budget.Interrupted() ) return manager.Generate_OBDD( NodeID::bot );
 	if ( running_options.display_compiling_process ) {
 		cout << running_options.display_prefix << "Converting to OBDD..." << endl;
 	}
@@ -882,6 +1006,8 @@ Diagram BDDC_Compiler::Compile( Smooth_OBDDC_Manager & manager, CNF_Formula & cn
 	if ( running_options.display_compiling_process ) cout << running_options.display_prefix << "Compiling..." << endl;
 	Allocate_and_Init_Auxiliary_Memory( cnf.Max_Var() );
 	if ( running_options.profile_compiling >= Profiling_Abstract ) begin_watch.Start();
+	_stats_snapshots.Open( running_options.stats_json_file, running_options.stats_interval );
+	budget.Start();
 	assert( _num_levels == 0 && _num_dec_stack == 0 && _num_comp_stack == 0 );
 	running_options.recover_exterior = true;
 	if ( running_options.display_compiling_process ) cout << running_options.display_prefix << "Begin preprocess..." << endl;
@@ -925,8 +1051,11 @@ Diagram BDDC_Compiler::Compile( Smooth_OBDDC_Manager & manager, CNF_Formula & cn
 		Compile_With_Implicite_BCP( manager );
 	}
 	else Compile_With_SAT_Imp_Computing( manager );
-	_num_rsl_stack--;
-	NodeID result = Make_Node_With_Init_Imp( manager, _rsl_stack[0] );
+	NodeID result = NodeID::bot;  /// NOTE: interrupted by the budget, which the caller needs to check
+	if ( _num_rsl_stack == 1 ) {
+		_num_rsl_stack--;
+		result = Make_Node_With_Init_Imp( manager, _rsl_stack[0] );
+	}
 	Backtrack();
 	if ( running_options.display_compiling_process && running_options.profile_compiling >= Profiling_Abstract ) statistics.time_compile = begin_watch.Get_Elapsed_Seconds();
 	if ( debug_options.verify_learnts ) Verify_Learnts( cnf );
@@ -939,7 +1068,7 @@ Diagram BDDC_Compiler::Compile( Smooth_OBDDC_Manager & manager, CNF_Formula & cn
 		}
 	}
 	Reset();
-	if ( debug_options.verify_compilation ) {
+	if ( debug_options.verify_compilation && !budget.Interrupted() ) {
 //		manager.Display_Stat( cout );  // ToRemove
 		manager.Verify_Smooth_ROBDDC_Finest( result );
 		manager.Verify_Entail_CNF( result, cnf );
@@ -967,6 +1096,7 @@ void BDDC_Compiler::Compile_With_Implicite_BCP( Smooth_OBDDC_Manager & manager )
 	//		system( "pause" );
 			Display_Comp_And_Decision_Stacks( cerr );  // ToRemove
 		}
+		if ( budget.Active() && budget.Exhausted() ) break;
 		if ( Num_Components_On_Current_Level() <= 1 ) { // decision or preparation
 			switch ( _state_stack[_num_levels - 1] ) {
 			case 0:
@@ -1097,7 +1227,8 @@ void BDDC_Compiler::Compile_With_Implicite_BCP( Smooth_OBDDC_Manager & manager )
 			}
 		}
 	}
-	assert( _num_levels == old_num_levels - 1 && _num_rsl_stack == old_num_rsl_stack + 1 );
+	if ( _num_levels == old_num_levels - 1 ) assert( _num_rsl_stack == old_num_rsl_stack + 1 );
+	else Terminate_Compiling();
 }
 
 NodeID BDDC_Compiler::Make_Node_With_Imp( Smooth_OBDDC_Manager & manager, NodeID node )
@@ -1155,6 +1286,7 @@ void BDDC_Compiler::Compile_With_SAT_Imp_Computing( Smooth_OBDDC_Manager & manag
 	//		system( "pause" );
 			Display_Comp_And_Decision_Stacks( cerr );  // ToRemove
 		}
+		if ( budget.Active() && budget.Exhausted() ) break;
 		if ( Num_Components_On_Current_Level() <= 1 ) { // decision or preparation
 			switch ( _state_stack[_num_levels - 1] ) {
 			case 0:
@@ -1252,7 +1384,8 @@ void BDDC_Compiler::Compile_With_SAT_Imp_Computing( Smooth_OBDDC_Manager & manag
 			}
 		}
 	}
-	assert( _num_levels == 1 && _num_rsl_stack == 1 );
+	if ( _num_levels != 1 ) Terminate_Compiling();
+	assert( _num_rsl_stack == 1 || budget.Interrupted() );
 }
 
 void BDDC_Compiler::Verify_Result_Component( Component & comp, Smooth_OBDDC_Manager & manager, NodeID result )
@@ -1276,11 +1409,11 @@ void BDDC_Compiler::Verify_Result_Component( Component & comp, Smooth_OBDDC_Mana
 
 bool BDDC_Compiler::Is_Memory_Exhausted()
 {
-	size_t counterram = Memory();  // int overflows
+	size_t counterram = Memory_Ledger::Total();  // int overflows
 	struct sysinfo info;
 	sysinfo(&info);
 	double free_ratio = 1.0 * info.freeram / info.totalram;
-	static unsigned exhausted = 0.4;
+	const double exhausted = 0.4;
 	if ( counterram > exhausted * info.freeram && free_ratio <= 0.1 ) {
 		return true;
 	}
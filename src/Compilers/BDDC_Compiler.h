@@ -19,11 +19,13 @@ protected:
 	vector<unsigned> _aux_varIDs; // for smoothness
 	const vector<unsigned> ** _aux_var_sets;
 	unsigned _remove_redundancy_trigger;
+	Statistics_Snapshots _stats_snapshots;
 public:
 	BDDC_Compiler();
 	~BDDC_Compiler();
 	void Reset();
 	size_t Memory();
+	void Write_Statistics_JSON( JSON_Writer & writer );  // the statistics together with the cache metrics
 protected:
 	void Allocate_and_Init_Auxiliary_Memory( Variable max_var );
 	void Free_Auxiliary_Memory();
@@ -32,6 +34,7 @@ public:
 protected:
 	NodeID Make_Node_With_Init_Imp( OBDDC_Manager & manager, NodeID node );
 	void Reorder_BDDC_Manager( OBDDC_Manager & manager );
+	bool Compile_Components_In_Parallel( OBDDC_Manager & manager, NodeID & result );
 	void Create_Init_Level();
 protected:
 	void Compile_With_Implicite_BCP( OBDDC_Manager & manager );
@@ -40,6 +43,7 @@ protected:
 	NodeID Component_Cache_Map_Current_Component();
 	void Component_Cache_Connect_Current_Component();
 	void Backtrack();  // backtrack one level without discarding results
+	void Terminate_Compiling();  // discard the levels above the initial one when interrupted by the budget
 	void Extend_New_Level();
 	void Refactor_Current_Level();
 	NodeID Make_Decision_Node( OBDDC_Manager & manager, NodeID low, NodeID high );
@@ -95,7 +99,11 @@ public:
 		compiler.debug_options.verify_compilation = false;
 		compiler.running_options.cache_encoding = Parse_Cache_Encoding_Strategy( parameters.cache_enc );
 		compiler.running_options.max_memory = parameters.memo;
+		compiler.running_options.stats_json_file = parameters.stats_json;
+		compiler.running_options.stats_interval = parameters.stats_interval;
+		compiler.Set_Budget( parameters );
 		compiler.running_options.removing_redundant_nodes_trigger *= parameters.memo / 4;
+		compiler.running_options.compile_num_threads = parameters.threads;
 		Heuristic heur = Parse_Heuristic( parameters.heur );
 		if ( heur != AutomaticalHeur && heur != minfill && heur != LexicographicOrder ) {
 			cerr << "ERROR: the heuristic is not supported yet!" << endl;
@@ -117,6 +125,11 @@ public:
 			}
 			OBDD_Manager manager( cnf.Max_Var() );
 			Diagram bdd = compiler.Compile( manager, cnf, heur );
+			if ( parameters.stats_json.Exists() ) Write_Statistics_File( compiler, parameters.stats_json );
+			if ( compiler.budget.Interrupted() ) {
+				cout << compiler.running_options.display_prefix << "Compilation stopped (" << Run_Status_Name( compiler.budget.Status() ) << "), and the queries are skipped" << endl;
+				return;
+			}
 			vector<double> weights( 2 * cnf.Max_Var() + 2 );
 			BigFloat normalized_factor = compiler.Normalize_Weights( cnf.Weights(), weights );
 			if ( parameters.wCT ) {
@@ -184,6 +197,11 @@ public:
 			}
 			OBDD_Manager manager( cnf.Max_Var() );
 			Diagram bdd = compiler.Compile( manager, cnf, heur );
+			if ( parameters.stats_json.Exists() ) Write_Statistics_File( compiler, parameters.stats_json );
+			if ( compiler.budget.Interrupted() ) {
+				cout << compiler.running_options.display_prefix << "Compilation stopped (" << Run_Status_Name( compiler.budget.Status() ) << "), and the queries are skipped" << endl;
+				return;
+			}
 			if ( parameters.CO ) {
 				if ( !parameters.condition.Exists() ) {
 					cout << compiler.running_options.display_prefix << "Consistency: " << (bdd.Root() != NodeID::bot) << endl;
@@ -297,7 +315,11 @@ public:
 		compiler.debug_options.verify_compilation = false;
 		compiler.running_options.cache_encoding = Parse_Cache_Encoding_Strategy( parameters.cache_enc );
 		compiler.running_options.max_memory = parameters.memo;
+		compiler.running_options.stats_json_file = parameters.stats_json;
+		compiler.running_options.stats_interval = parameters.stats_interval;
+		compiler.Set_Budget( parameters );
 		compiler.running_options.removing_redundant_nodes_trigger *= parameters.memo / 4;
+		compiler.running_options.compile_num_threads = parameters.threads;
 		Heuristic heur = Parse_Heuristic( parameters.heur );
 		if ( heur != AutomaticalHeur && heur != minfill && heur != LexicographicOrder ) {
 			cerr << "ERROR: the heuristic is not supported yet!" << endl;
@@ -319,6 +341,11 @@ public:
 			}
 			OBDDC_Manager manager( cnf.Max_Var() );
 			Diagram bddc = compiler.Compile( manager, cnf, heur );
+			if ( parameters.stats_json.Exists() ) Write_Statistics_File( compiler, parameters.stats_json );
+			if ( compiler.budget.Interrupted() ) {
+				cout << compiler.running_options.display_prefix << "Compilation stopped (" << Run_Status_Name( compiler.budget.Status() ) << "), and the queries are skipped" << endl;
+				return;
+			}
 			compiler._component_cache.Shrink_To_Fit();
 			manager.Remove_Redundant_Nodes();
 			vector<double> weights( 2 * cnf.Max_Var() + 2 );
@@ -388,6 +415,11 @@ public:
 			}
 			OBDDC_Manager manager( cnf.Max_Var() );
 			Diagram bddc = compiler.Compile( manager, cnf, heur );
+			if ( parameters.stats_json.Exists() ) Write_Statistics_File( compiler, parameters.stats_json );
+			if ( compiler.budget.Interrupted() ) {
+				cout << compiler.running_options.display_prefix << "Compilation stopped (" << Run_Status_Name( compiler.budget.Status() ) << "), and the queries are skipped" << endl;
+				return;
+			}
 			if ( parameters.CT || parameters.US.Exists() ) {
 				compiler._component_cache.Shrink_To_Fit();
 				manager.Remove_Redundant_Nodes();
@@ -505,6 +537,9 @@ public:
 		compiler.debug_options.verify_compilation = false;
 		compiler.running_options.cache_encoding = Parse_Cache_Encoding_Strategy( parameters.cache_enc );
 		compiler.running_options.max_memory = parameters.memo;
+		compiler.running_options.stats_json_file = parameters.stats_json;
+		compiler.running_options.stats_interval = parameters.stats_interval;
+		compiler.Set_Budget( parameters );
 		compiler.running_options.removing_redundant_nodes_trigger *= parameters.memo / 4;
 		Heuristic heur = Parse_Heuristic( parameters.heur );
 		if ( heur != AutomaticalHeur && heur != minfill && heur != LexicographicOrder ) {
@@ -527,6 +562,11 @@ public:
 			}
 			Smooth_OBDDC_Manager manager( cnf.Max_Var() );
 			Diagram bddc = compiler.Compile( manager, cnf, heur );
+			if ( parameters.stats_json.Exists() ) Write_Statistics_File( compiler, parameters.stats_json );
+			if ( compiler.budget.Interrupted() ) {
+				cout << compiler.running_options.display_prefix << "Compilation stopped (" << Run_Status_Name( compiler.budget.Status() ) << "), and the queries are skipped" << endl;
+				return;
+			}
 			compiler._component_cache.Shrink_To_Fit();
 			manager.Remove_Redundant_Nodes();
 			vector<double> weights( 2 * cnf.Max_Var() + 2 );
@@ -596,6 +636,11 @@ public:
 			}
 			Smooth_OBDDC_Manager manager( cnf.Max_Var() );
 			Diagram bddc = compiler.Compile( manager, cnf, heur );
+			if ( parameters.stats_json.Exists() ) Write_Statistics_File( compiler, parameters.stats_json );
+			if ( compiler.budget.Interrupted() ) {
+				cout << compiler.running_options.display_prefix << "Compilation stopped (" << Run_Status_Name( compiler.budget.Status() ) << "), and the queries are skipped" << endl;
+				return;
+			}
 			if ( parameters.CT || parameters.US.Exists() ) {
 				compiler._component_cache.Shrink_To_Fit();
 				manager.Remove_Redundant_Nodes();
@@ -2,6 +2,8 @@
 #include "R2D2_Compiler.h"
 #include <sstream>
 #include <sys/sysinfo.h>
+#include <thread>
+#include <atomic>
 
 
 namespace KCBox {
@@ -41,6 +43,28 @@ void CCDD_Compiler::Reset()
 	CDD_Compiler::Reset();
 }
 
+void CCDD_Compiler::Set_Running_Options( Compiler_Parameters & parameters, bool quiet )
+{
+	debug_options.verify_compilation = false;
+	debug_options.verify_component_compilation = false;
+//	running_options.lit_equivalence_detecting_strategy = Literal_Equivalence_Detection_IBCP;
+	running_options.max_kdepth = parameters.kdepth;
+	running_options.mixed_imp_computing = true;
+	running_options.trivial_variable_bound = 128;
+	running_options.display_kernelizing_process = false;
+	running_options.cache_encoding = Parse_Cache_Encoding_Strategy( parameters.cache_enc );
+	running_options.max_memory = parameters.memo;
+	running_options.stats_json_file = parameters.stats_json;
+	running_options.stats_interval = parameters.stats_interval;
+	running_options.removing_redundant_nodes_trigger *= parameters.memo / 4;
+	running_options.compile_num_threads = parameters.threads;
+	if ( quiet ) {
+		running_options.profile_solving = Profiling_Close;
+		running_options.profile_preprocessing = Profiling_Close;
+		running_options.profile_compiling = Profiling_Close;
+	}
+}
+
 CDDiagram CCDD_Compiler::Compile( CCDD_Manager & manager, CNF_Formula & cnf, Heuristic heur, Chain & vorder )
 {
 	StopWatch begin_watch, tmp_watch;
@@ -51,6 +75,8 @@ CDDiagram CCDD_Compiler::Compile( CCDD_Manager & manager, CNF_Formula & cnf, Heu
 	if ( running_options.display_compiling_process ) cout << running_options.display_prefix << "Compiling..." << endl;
 	Allocate_and_Init_Auxiliary_Memory( cnf.Max_Var() );
 	if ( running_options.profile_compiling >= Profiling_Abstract ) begin_watch.Start();
+	_stats_snapshots.Open( running_options.stats_json_file, running_options.stats_interval );
+	budget.Start();
 	assert( _num_levels == 0 && _num_dec_stack == 0 && _num_comp_stack == 0 );
 	if ( running_options.display_compiling_process ) cout << running_options.display_prefix << "Begin preprocess..." << endl;
 	bool cnf_sat = Preprocess( cnf, _models_stack[0] );
@@ -87,11 +113,20 @@ CDDiagram CCDD_Compiler::Compile( CCDD_Manager & manager, CNF_Formula & cnf, Heu
 		return manager.Generate_CCDD( result );
 	}
 	Gather_Infor_For_Counting();
-	Choose_Running_Options( heur, vorder );
-	if ( running_options.display_compiling_process && running_options.profile_compiling != Profiling_Close ) running_options.Display( cout );  // ToRemove
-	if ( Is_Linear_Ordering( running_options.var_ordering_heur ) == lbool(true) ) Reorder_Manager( manager );
 	NodeID result;
-	if ( Is_Linear_Ordering( running_options.var_ordering_heur ) ) {
+	bool parallel = running_options.compile_num_threads != 1 && Compile_Components_In_Parallel( manager, heur, vorder, result );
+	if ( !parallel ) {
+		Choose_Running_Options( heur, vorder );
+		if ( running_options.display_compiling_process && running_options.profile_compiling != Profiling_Close ) running_options.Display( cout );  // ToRemove
+		if ( Is_Linear_Ordering( running_options.var_ordering_heur ) == lbool(true) ) Reorder_Manager( manager );
+	}
+	if ( parallel ) {
+		Recycle_Models( _models_stack[0] );
+		if ( !budget.Interrupted() ) result = Make_Root_Node( manager, result );
+		Un_BCP( _dec_offsets[--_num_levels] );
+		_call_stack[0].Clear_Lit_Equivalences();
+	}
+	else if ( Is_Linear_Ordering( running_options.var_ordering_heur ) ) {
 		if ( running_options.display_compiling_process ) cout << running_options.display_prefix << "==== Shift to R2-D2 compilation ====" << endl;
 		manager.Shrink_Nodes();
 		_component_cache.Shrink_To_Fit();
@@ -103,10 +138,12 @@ CDDiagram CCDD_Compiler::Compile( CCDD_Manager & manager, CNF_Formula & cnf, Heu
 		R2D2_Compiler compiler;
 		CDDiagram r2d2 = compiler.Compile_FixedLinearOrder( manager2, *this, _var_order );
 		result = r2d2.Root();
+		if ( compiler.budget.Interrupted() ) budget.Stop( compiler.budget.Status() );
 		if ( running_options.display_compiling_process ) cout << running_options.display_prefix << "==== Finish R2-D2 compilation ====" << endl;
 		manager.Load_Nodes( manager2 );
 	}
 	else {
+		manager.Reserve_Nodes( Fitted_Table_Size() );
 		Set_Current_Level_Kernelized( true );
 		Create_Init_Level();
 		if ( running_options.imp_strategy != SAT_Imp_Computing ) {
@@ -120,8 +157,11 @@ CDDiagram CCDD_Compiler::Compile( CCDD_Manager & manager, CNF_Formula & cnf, Heu
 			assert( _old_num_long_clauses == 0 || _long_clause_ids.back() == _old_num_long_clauses - 1 );
 			Compile_With_SAT_Imp_Computing( manager );
 		}
-		_num_rsl_stack--;
-		result = Make_Root_Node( manager, _rsl_stack[0] );
+		if ( _num_rsl_stack == 1 ) {
+			_num_rsl_stack--;
+			result = Make_Root_Node( manager, _rsl_stack[0] );
+		}
+		else result = NodeID::bot;  /// NOTE: interrupted by the budget, which the caller needs to check
 		Set_Current_Level_Kernelized( false );
 		Backtrack();
 		_call_stack[0].Clear_Lit_Equivalences();
@@ -137,7 +177,7 @@ CDDiagram CCDD_Compiler::Compile( CCDD_Manager & manager, CNF_Formula & cnf, Heu
 		}
 	}
 	Reset();
-	if ( debug_options.verify_compilation ) {
+	if ( debug_options.verify_compilation && !budget.Interrupted() ) {
 //		manager.Display_Stat( cout );  // ToRemove
 //		manager.Verify_CCDD( result );
 		manager.Verify_Entail_CNF( result, cnf );
@@ -164,6 +204,118 @@ NodeID CCDD_Compiler::Make_Root_Node( CCDD_Manager & manager, NodeID node )
 	return result;
 }
 
+bool CCDD_Compiler::Compile_Components_In_Parallel( CCDD_Manager & manager, Heuristic heur, Chain & vorder, NodeID & result )
+{
+	/* NOTE:
+	* The search never decomposes the root, so its components are compiled here by independent compilers, each with
+	* its own manager and inprocessor state.  The results are hash-consed into manager in the order of components,
+	* and the variables of manager are reordered such that each component keeps the order of its own compiler.
+	*/
+	unsigned num_threads = running_options.compile_num_threads;
+	if ( num_threads == 0 ) num_threads = std::max( std::thread::hardware_concurrency(), 1u );
+	if ( num_threads == 1 ) return false;
+	StopWatch begin_watch;
+	if ( running_options.profile_compiling >= Profiling_Abstract ) begin_watch.Start();
+	Component root;
+	Generate_Init_Component( root );
+	vector<Component> comps( root.Vars_Size() / 2 + 1 );
+	unsigned num_comps = Dynamic_Decompose_Component( root, comps.data() );
+	if ( num_comps <= 1 ) return false;
+	if ( num_threads > num_comps ) num_threads = num_comps;
+	vector<CNF_Formula *> cnfs( num_comps );
+	vector<unsigned> order( num_comps );
+	for ( unsigned i = 0; i < num_comps; i++ ) {
+		cnfs[i] = Output_Original_Clauses_In_Component( comps[i] );
+		order[i] = i;
+	}
+	sort( order.begin(), order.end(), [&]( unsigned a, unsigned b ) { return comps[a].Vars_Size() > comps[b].Vars_Size(); } );  // the largest first
+	if ( running_options.display_compiling_process ) {
+		cout << running_options.display_prefix << "Compile " << num_comps << " components of the root on " << num_threads << " threads..." << endl;
+	}
+	Running_Options options = running_options;
+	options.compile_num_threads = 1;
+	options.max_memory /= num_threads;
+	options.removing_redundant_nodes_trigger /= num_threads;
+	options.display_compiling_process = false;
+	options.display_preprocessing_process = false;
+	options.display_kernelizing_process = false;
+	options.display_counting_process = false;
+	options.profile_solving = Profiling_Close;
+	options.profile_preprocessing = Profiling_Close;
+	options.profile_compiling = Profiling_Close;
+	Chain manager_order = manager.Var_Order();
+	vector<CCDD_Manager *> managers( num_comps );
+	vector<NodeID> roots( num_comps );
+	vector<Run_Status> statuses( num_comps, Run_Done );
+	atomic<unsigned> next( 0 );
+	atomic<bool> stopped( false );
+	auto work = [&]() {
+		for ( unsigned k = next++; k < num_comps && !stopped; k = next++ ) {
+			unsigned i = order[k];
+			CCDD_Compiler compiler;
+			compiler.running_options = options;
+			compiler.debug_options = debug_options;
+			compiler.budget = budget.Share();
+			managers[i] = new CCDD_Manager( manager_order );
+			roots[i] = compiler.Compile( *managers[i], *cnfs[i], heur, vorder ).Root();
+			statuses[i] = compiler.budget.Status();
+			if ( compiler.budget.Interrupted() ) stopped = true;
+		}
+	};
+	vector<thread> workers;
+	for ( unsigned i = 0; i < num_threads; i++ ) {
+		workers.emplace_back( work );
+	}
+	for ( thread & worker: workers ) worker.join();
+	if ( stopped ) {  // the components are discarded, and result is bot as in an interrupted search
+		for ( unsigned i = 0; i < num_comps; i++ ) {
+			if ( statuses[i] != Run_Done ) budget.Stop( statuses[i] );
+			delete managers[i];
+			delete cnfs[i];
+		}
+		result = NodeID::bot;
+		return true;
+	}
+	/// each component keeps the variable order of its compiler, and the other variables follow
+	vector<unsigned> comp_of( _max_var + 1, UNSIGNED_UNDEF );
+	vector<bool> ordered( _max_var + 1, false );
+	for ( unsigned i = 0; i < num_comps; i++ ) {
+		for ( unsigned j = 0; j < comps[i].Vars_Size(); j++ ) {
+			comp_of[comps[i].Vars( j )] = i;
+		}
+	}
+	Chain new_order;
+	for ( unsigned i = 0; i < num_comps; i++ ) {
+		const Chain & comp_order = managers[i]->Var_Order();
+		for ( unsigned j = 0; j < comp_order.Size(); j++ ) {
+			Variable x = Variable( comp_order[j] );
+			if ( x > _max_var || comp_of[x] != i || ordered[x] ) continue;
+			new_order.Append( x );
+			ordered[x] = true;
+		}
+	}
+	for ( unsigned j = 0; j < manager_order.Size(); j++ ) {
+		Variable x = Variable( manager_order[j] );
+		if ( Variable::start <= x && x <= _max_var && !ordered[x] ) {
+			new_order.Append( x );
+			ordered[x] = true;
+		}
+	}
+	manager.Reorder( new_order );
+	_cdd_rnode.sym = CDD_SYMBOL_DECOMPOSE;
+	_cdd_rnode.ch_size = 0;
+	for ( unsigned i = 0; i < num_comps; i++ ) {
+		_cdd_rnode.Add_Child( manager.Import_Nodes( *managers[i], roots[i] ) );
+		delete managers[i];
+		delete cnfs[i];
+	}
+	result = manager.Add_Decomposition_Node( _cdd_rnode );
+	if ( running_options.display_compiling_process && running_options.profile_compiling >= Profiling_Abstract ) {
+		cout << running_options.display_prefix << "Components compiled in " << begin_watch.Get_Elapsed_Seconds() << "s" << endl;
+	}
+	return true;
+}
+
 NodeID CCDD_Compiler::Make_Kernelized_Conjunction_Node( CCDD_Manager & manager, NodeID node )
 {
 	StopWatch begin_watch;
@@ -229,7 +381,7 @@ void CCDD_Compiler::Choose_Running_Options( Heuristic heur, Chain & vorder )
 		if ( _call_stack[0].Lit_Equivalences_Size() == 0 ) running_options.max_kdepth = 2;
 	}
 	if ( running_options.var_ordering_heur == DLCP ) {
-//		running_options.lit_equivalence_detecting_strategy = Literal_Equivalence_Detection_IBCP;
+//	running_options.lit_equivalence_detecting_strategy = Literal_Equivalence_Detection_IBCP;
 	}
 }
 
@@ -295,6 +447,7 @@ void CCDD_Compiler::Compile_With_Implicite_BCP( CCDD_Manager & manager )
 	//		system( "pause" );
 			Display_Comp_And_Decision_Stacks( cerr );  // ToRemove
 		}
+		if ( budget.Active() && budget.Exhausted() ) break;
 		if ( Num_Components_On_Current_Level() <= 1 ) { // decision or preparation
 			switch ( _state_stack[_num_levels - 1] ) {
 			case 0:
@@ -425,7 +578,8 @@ void CCDD_Compiler::Compile_With_Implicite_BCP( CCDD_Manager & manager )
 			}
 		}
 	}
-	assert( _num_levels == old_num_levels - 1 && _num_rsl_stack == old_num_rsl_stack + 1 );
+	if ( _num_levels == old_num_levels - 1 ) assert( _num_rsl_stack == old_num_rsl_stack + 1 );
+	else Terminate_Compiling();
 }
 
 NodeID CCDD_Compiler::Make_Node_With_Imp( CCDD_Manager & manager, NodeID node  )
@@ -457,6 +611,7 @@ NodeID CCDD_Compiler::Make_Decision_Node( CCDD_Manager & manager, NodeID low, No
 	}
 	if ( high != NodeID::bot ) _component_cache.Write_Result( Current_Component().caching_loc, result );
 	if ( Cache_Clear_Applicable( manager ) ) Component_Cache_Clear();
+	if ( _stats_snapshots.Due() ) _stats_snapshots.Write( *this );
 	if ( manager.Num_Nodes() >= _node_redundancy_factor * running_options.removing_redundant_nodes_trigger ) {
 		if ( high == NodeID::bot ) _rsl_stack[_num_rsl_stack++] = result;
 		unsigned old_size = manager.Num_Nodes();
@@ -504,6 +659,7 @@ void CCDD_Compiler::Compile_With_SAT_Imp_Computing( CCDD_Manager & manager )
 	//		system( "pause" );
 			Display_Comp_And_Decision_Stacks( cerr );  // ToRemove
 		}
+		if ( budget.Active() && budget.Exhausted() ) break;
 		if ( Num_Components_On_Current_Level() <= 1 ) { // decision or preparation
 			switch ( _state_stack[_num_levels - 1] ) {
 			case 0:
@@ -611,7 +767,8 @@ void CCDD_Compiler::Compile_With_SAT_Imp_Computing( CCDD_Manager & manager )
 			}
 		}
 	}
-	assert( _num_levels == 1 && _num_rsl_stack == 1 );
+	if ( _num_levels != 1 ) Terminate_Compiling();
+	assert( _num_rsl_stack == 1 || budget.Interrupted() );  // a nested search may have terminated already
 }
 
 bool CCDD_Compiler::Try_Shift_To_Implicite_BCP( CCDD_Manager & manager )
@@ -638,7 +795,7 @@ bool CCDD_Compiler::Try_Shift_To_Implicite_BCP( CCDD_Manager & manager )
 	}
 	if ( false && comp.Vars_Size() > running_options.trivial_variable_bound / 1 ) system( "./pause" );  // ToRemove
 	running_options.imp_strategy = SAT_Imp_Computing;
-	Leave_Final_Kernelization( manager );
+	if ( _num_rsl_stack > 0 ) Leave_Final_Kernelization( manager );
 	return true;
 }
 
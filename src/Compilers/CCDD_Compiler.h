@@ -21,10 +21,12 @@ protected:
 	void Allocate_and_Init_Auxiliary_Memory( Variable max_var );
 	void Free_Auxiliary_Memory();
 public:
+	void Set_Running_Options( Compiler_Parameters & parameters, bool quiet );  // the options of Panini for CCDD
 	CDDiagram Compile( CCDD_Manager & manager, CNF_Formula & cnf, Heuristic heur = AutomaticalHeur, Chain & vorder = Chain::default_empty_chain );  // Reset outside
 protected:
 	NodeID Make_Root_Node( CCDD_Manager & manager, NodeID node );
 	NodeID Make_Kernelized_Conjunction_Node( CCDD_Manager & manager, NodeID node );
+	bool Compile_Components_In_Parallel( CCDD_Manager & manager, Heuristic heur, Chain & vorder, NodeID & result );  // return false if the root is not decomposable
 	void Choose_Running_Options( Heuristic heur, Chain & vorder );
 	void Compute_Var_Order_Automatical();
 	void Choose_Implicate_Computing_Strategy();
@@ -104,26 +106,13 @@ public:
 	static void Test_CCDD_Compiler( const char * infile, Compiler_Parameters & parameters, bool quiet )
 	{
 		CCDD_Compiler compiler;
-		compiler.debug_options.verify_compilation = false;
-		compiler.debug_options.verify_component_compilation = false;
-//		compiler.running_options.lit_equivalence_detecting_strategy = Literal_Equivalence_Detection_IBCP;
-		compiler.running_options.max_kdepth = parameters.kdepth;
-		compiler.running_options.mixed_imp_computing = true;
-		compiler.running_options.trivial_variable_bound = 128;
-		compiler.running_options.display_kernelizing_process = false;
-		compiler.running_options.cache_encoding = Parse_Cache_Encoding_Strategy( parameters.cache_enc );
-		compiler.running_options.max_memory = parameters.memo;
-		compiler.running_options.removing_redundant_nodes_trigger *= parameters.memo / 4;
+		compiler.Set_Running_Options( parameters, quiet );
+		compiler.Set_Budget( parameters );
 		Heuristic heur = Parse_Heuristic( parameters.heur );
 		if ( heur != AutomaticalHeur && heur != minfill && heur != LinearLRW && heur != DLCP && heur != dynamic_minfill ) {
 			cerr << "ERROR: the heuristic is not supported yet!" << endl;
 			exit( 0 );
 		}
-		if ( quiet ) {
-			compiler.running_options.profile_solving = Profiling_Close;
-			compiler.running_options.profile_preprocessing = Profiling_Close;
-			compiler.running_options.profile_compiling = Profiling_Close;
-		}
 		ifstream fin( infile );
 		CNF_Formula cnf( fin );
 		fin.close();
@@ -132,8 +121,15 @@ public:
 			if ( parameters.CT ) cout << compiler.running_options.display_prefix << "Number of models: " << cnf.Known_Count() << endl;
 			return;
 		}
-		CCDD_Manager manager( cnf.Max_Var() );
+		CCDD_Manager manager( cnf.Max_Var(), Fit_Hash_Table_Size( cnf.Num_Vars(), cnf.Num_Clauses(), 0, parameters.memo ) );  // reserved further once the treewidth is known
+		if ( parameters.stream ) manager.Open_Stream( parameters.out_file );
 		CDDiagram ccdd = compiler.Compile( manager, cnf, heur );
+		if ( parameters.stats_json.Exists() ) Write_Statistics_File( compiler, parameters.stats_json );
+		if ( compiler.budget.Interrupted() ) {
+			cout << compiler.running_options.display_prefix << "Compilation stopped (" << Run_Status_Name( compiler.budget.Status() ) << "), and the queries are skipped" << endl;
+			return;
+		}
+		if ( parameters.stream ) manager.Close_Stream( ccdd.Root() );
 		if ( parameters.CT || parameters.US.Exists() ) {
 			compiler._component_cache.Shrink_To_Fit();
 			manager.Remove_Redundant_Nodes();
@@ -233,7 +229,7 @@ public:
 			fout.close();
 			cout << compiler.running_options.display_prefix << "Samples saved to " << sample_file << endl;
 		}
-		if ( parameters.out_file != nullptr ) {
+		if ( parameters.out_file != nullptr && !parameters.stream ) {
             ofstream fout( parameters.out_file );
             manager.Display( fout );
             fout.close();
@@ -255,6 +251,9 @@ public:
 		compiler.running_options.trivial_variable_bound = 128;
 		compiler.running_options.display_kernelizing_process = false;
 		compiler.running_options.max_memory = parameters.memo;
+		compiler.running_options.stats_json_file = parameters.stats_json;
+		compiler.running_options.stats_interval = parameters.stats_interval;
+		compiler.Set_Budget( parameters );
 		compiler.running_options.removing_redundant_nodes_trigger *= parameters.memo / 4;
 		if ( quiet ) {
 			compiler.running_options.profile_solving = Profiling_Close;
@@ -268,8 +267,13 @@ public:
 			cerr << "ERROR: empty instance!" << endl;
 			return;
 		}
-		CCDD_Manager manager( cnf.Max_Var() );
+		CCDD_Manager manager( cnf.Max_Var(), Fit_Hash_Table_Size( cnf.Num_Vars(), cnf.Num_Clauses(), 0, parameters.memo ) );
 		CDDiagram ccdd = compiler.Compile( manager, cnf, AutomaticalHeur );
+		if ( parameters.stats_json.Exists() ) Write_Statistics_File( compiler, parameters.stats_json );
+		if ( compiler.budget.Interrupted() ) {
+			cout << compiler.running_options.display_prefix << "Compilation stopped (" << Run_Status_Name( compiler.budget.Status() ) << "), and no samples are drawn" << endl;
+			return;
+		}
 		compiler._component_cache.Shrink_To_Fit();
 		Random_Generator rand_gen;
 		vector<vector<bool>> samples( parameters.nsamples );
@@ -76,7 +76,7 @@ bool CDD_Compiler::Create_Init_Level()
 	if ( running_options.profile_compiling >= Profiling_Abstract ) tmp_watch.Start();
 	if ( _current_kdepth <= 1 ) {
 		assert( _component_cache.Size() == 0 );
-		_component_cache.Init( _max_var, _old_num_long_clauses, NodeID::undef );
+		_component_cache.Init( _max_var, _old_num_long_clauses, NodeID::undef, Fitted_Table_Size() );
 		_component_cache.Set_Encoding( running_options.cache_encoding );
 		Component_Cache_Add_Original_Clauses();
 		_component_cache.Hit_Component( _comp_stack[0] );
@@ -142,6 +142,7 @@ void CDD_Compiler::Backjump_Decision( unsigned num_kept_levels )
 
 NodeID CDD_Compiler::Component_Cache_Map( Component & comp )
 {
+	Trace_Scope trace( Trace_Cache_Lookup );
 	StopWatch tmp_watch;
 	if ( running_options.profile_compiling >= Profiling_Abstract ) tmp_watch.Start();
 	if ( _current_kdepth <= 1 ) comp.caching_loc = _component_cache.Hit_Component( comp );
@@ -157,8 +158,12 @@ NodeID CDD_Compiler::Component_Cache_Map( Component & comp )
 	if ( _component_cache.Entry_Is_Isolated( comp.caching_loc ) ) {
 		Component_Cache_Connect( comp );
 	}
-	if ( running_options.profile_compiling >= Profiling_Abstract ) statistics.time_gen_cnf_cache += tmp_watch.Get_Elapsed_Seconds();
-	return _component_cache.Read_Result( comp.caching_loc );
+	NodeID result = _component_cache.Read_Result( comp.caching_loc );
+	if ( running_options.profile_compiling >= Profiling_Abstract ) {
+		statistics.time_gen_cnf_cache += tmp_watch.Get_Elapsed_Seconds();
+		statistics.num_cache_hits += ( result != NodeID::undef );
+	}
+	return result;
 }
 
 void CDD_Compiler::Generate_Incremental_Component( Component & comp )
@@ -209,6 +214,22 @@ void CDD_Compiler::Backtrack()
 	_num_comp_stack = _comp_offsets[_num_levels];
 }
 
+void CDD_Compiler::Terminate_Compiling()
+{
+	_num_rsl_stack = 0;
+	_swap_frame.Clear();
+	while ( _num_levels > 1 ) {
+		if ( _call_stack[_num_levels - 1].Existed() ) {  // otherwise the next run starts with a wrong kdepth and a stale component
+			Set_Current_Level_Kernelized( false );
+			_call_stack[_num_levels - 1].Clear_Component();
+		}
+		_call_stack[_num_levels - 1].Free_Long_Clauses();
+		_call_stack[_num_levels - 1].Clear();
+		Recycle_Models( _models_stack[_num_levels - 1] );
+		Backtrack();
+	}
+}
+
 void CDD_Compiler::Extend_New_Level()
 {
 	_dec_offsets[_num_levels] = _num_dec_stack;
@@ -227,7 +248,7 @@ bool CDD_Compiler::Cache_Clear_Applicable( CDD_Manager & manager )
 	if ( evaluated_mem <= max_mem * 0.3 ) return false;
 	if ( evaluated_mem > max_mem * 0.7 && _component_cache.Memory() > max_mem * 0.1 ) return true;
 	if ( _component_cache.Size() < _component_cache.Capacity() || _component_cache.Hit_Successful() ) return false;
-	size_t mem = Total_Used_Memory();
+	size_t mem = Memory_Ledger::Total();
 	if ( running_options.display_compiling_process && running_options.profile_compiling != Profiling_Close ) {
 		cout << running_options.display_prefix << (float) _component_cache.Memory() / GB << " (cache) /";
 		cout << (float) mem / GB << " (total) in GB" << endl;
@@ -238,6 +259,7 @@ bool CDD_Compiler::Cache_Clear_Applicable( CDD_Manager & manager )
 
 void CDD_Compiler::Component_Cache_Clear()
 {
+	Trace_Scope trace( Trace_Cache_Clear );
 	if ( running_options.display_compiling_process ) cout << running_options.display_prefix << "clear cache" << endl;
 	StopWatch watch;
 	if ( running_options.profile_compiling >= Profiling_Abstract ) watch.Start();
@@ -481,7 +503,7 @@ void CDD_Compiler::Display_Statistics( unsigned option )
 			if ( running_options.imp_strategy == SAT_Imp_Computing ) cout << running_options.display_prefix << "time SAT: " << statistics.time_solve << endl;
 			else cout << running_options.display_prefix << "time IBCP: " << statistics.time_ibcp << endl;
 			cout << running_options.display_prefix << "time dynamic decomposition: " << statistics.time_dynamic_decompose << " (" << statistics.time_dynamic_decompose_sort << " sorting)" << endl;
-			cout << running_options.display_prefix << "time cnf cache: " << statistics.time_gen_cnf_cache << endl;
+			cout << running_options.display_prefix << "time cnf cache: " << statistics.time_gen_cnf_cache << " (" << statistics.num_cache_hits << " hits)" << endl;
 			if ( running_options.max_kdepth > 1 ) cout << running_options.display_prefix << "time kernelize: " << statistics.time_kernelize << endl;
 			cout << running_options.display_prefix << "time generate DAG: " << statistics.time_gen_dag << endl;
 			cout << running_options.display_prefix << "Total time cost: " << statistics.time_compile << endl;
@@ -512,6 +534,14 @@ void CDD_Compiler::Display_Memory_Status( ostream & out )
 	out << running_options.display_prefix << "Total memory: " << Memory() / (1.0 * 1024 * 1024) << "M" << endl;
 }
 
+void CDD_Compiler::Write_Statistics_JSON( JSON_Writer & writer )
+{
+	Solver::Write_Statistics_JSON( writer );
+	writer.Begin_Object( "component_cache" );
+	_component_cache.Write_JSON( writer );
+	writer.End_Object();
+}
+
 void CDD_Compiler::Display_Result_Stack( ostream & out )
 {
 	unsigned num = 0;
@@ -556,11 +586,11 @@ void CDD_Compiler::Display_Result_Statistics( ostream & out, CDD_Manager & manag
 
 bool CDD_Compiler::Is_Memory_Exhausted()
 {
-	size_t counterram = Memory();  // int overflows
+	size_t counterram = Memory_Ledger::Total();  // int overflows
 	struct sysinfo info;
 	sysinfo(&info);
 	double free_ratio = 1.0 * info.freeram / info.totalram;
-	static unsigned exhausted = 0.4;
+	const double exhausted = 0.4;
 	if ( counterram > exhausted * info.freeram && free_ratio <= 0.1 ) {
 		return true;
 	}
@@ -22,11 +22,13 @@ protected:
 	Rough_CDD_Node _cdd_rnode;
 	Component _incremental_comp;
 	double _node_redundancy_factor;
+	Statistics_Snapshots _stats_snapshots;
 public:
 	CDD_Compiler();
 	~CDD_Compiler();
 	void Reset();
 	size_t Memory();
+	void Write_Statistics_JSON( JSON_Writer & writer );  // the statistics together with the cache metrics
 protected:
 	void Allocate_and_Init_Auxiliary_Memory( Variable max_var );
 	void Free_Auxiliary_Memory();
@@ -47,6 +49,7 @@ protected:
 	void Component_Cache_Reconnect_Components();
 	void Backjump_Decomposition( unsigned num_kept_levels );  // backtrack when detect some unsatisfiable component, and tail is decomposition
 	void Backtrack_Halfway();  // backtrack one decomposition level when getting a UNSAT
+	void Terminate_Compiling();  // discard the levels above the initial one when interrupted by the budget
 protected:
 	void Sort_Clauses_For_Caching();
 	void Sort_Long_Clauses_By_IDs();
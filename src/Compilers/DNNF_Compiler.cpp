@@ -1,4 +1,6 @@
 #include "DNNF_Compiler.h"
+#include <thread>
+#include <atomic>
 
 
 namespace KCBox {
@@ -48,6 +50,8 @@ CDDiagram DNNF_Compiler::Compile( DecDNNF_Manager & manager, CNF_Formula & cnf,
 	if ( running_options.display_compiling_process ) cout << running_options.display_prefix << "Compiling..." << endl;
 	Allocate_and_Init_Auxiliary_Memory( cnf.Max_Var() );
 	if ( running_options.profile_compiling >= Profiling_Abstract ) begin_watch.Start();
+	_stats_snapshots.Open( running_options.stats_json_file, running_options.stats_interval );
+	budget.Start();
 	assert( _num_levels == 0 && _num_dec_stack == 0 && _num_comp_stack == 0 );
 	running_options.recover_exterior = true;
 	if ( running_options.display_compiling_process ) cout << running_options.display_prefix << "Begin preprocess..." << endl;
@@ -84,18 +88,31 @@ CDDiagram DNNF_Compiler::Compile( DecDNNF_Manager & manager, CNF_Formula & cnf,
 		return manager.Generate_DNNF( result );
 	}
 	Gather_Infor_For_Counting();
-	Choose_Running_Options( heur, vorder );
-	if ( running_options.display_compiling_process && running_options.profile_compiling != Profiling_Close ) running_options.Display( cout );  // ToRemove
-	Create_Init_Level();
-	if ( running_options.imp_strategy != SAT_Imp_Computing ) {
+	NodeID result;
+	if ( running_options.compile_num_threads != 1 && Compile_In_Parallel( manager, heur, vorder, result ) ) {
 		Recycle_Models( _models_stack[0] );
-		if ( Large_Scale_Problem() ) _model_pool->Free_Unallocated_Models();
-		Compile_With_Implicite_BCP( manager );
+		if ( !budget.Interrupted() ) result = Make_Root_Node( manager, result );
+		Un_BCP( _dec_offsets[--_num_levels] );
+		_call_stack[0].Clear_Lit_Equivalences();
+	}
+	else {
+		Choose_Running_Options( heur, vorder );
+		if ( running_options.display_compiling_process && running_options.profile_compiling != Profiling_Close ) running_options.Display( cout );  // ToRemove
+		manager.Reserve_Nodes( Fitted_Table_Size() );
+		Create_Init_Level();
+		if ( running_options.imp_strategy != SAT_Imp_Computing ) {
+			Recycle_Models( _models_stack[0] );
+			if ( Large_Scale_Problem() ) _model_pool->Free_Unallocated_Models();
+			Compile_With_Implicite_BCP( manager );
+		}
+		else Compile_With_SAT_Imp_Computing( manager );
+		if ( _num_rsl_stack == 1 ) {
+			_num_rsl_stack--;
+			result = Make_Root_Node( manager, _rsl_stack[0] );
+		}
+		else result = NodeID::bot;  /// NOTE: interrupted by the budget, which the caller needs to check
+		Backtrack();
 	}
-	else Compile_With_SAT_Imp_Computing( manager );
-	_num_rsl_stack--;
-	NodeID result = Make_Root_Node( manager, _rsl_stack[0] );
-	Backtrack();
 	if ( running_options.profile_compiling >= Profiling_Abstract ) statistics.time_compile = begin_watch.Get_Elapsed_Seconds();
 	if ( debug_options.verify_learnts ) Verify_Learnts( cnf );
 	if ( running_options.display_compiling_process ) {
@@ -107,7 +124,7 @@ CDDiagram DNNF_Compiler::Compile( DecDNNF_Manager & manager, CNF_Formula & cnf,
 		}
 	}
 	Reset();
-	if ( debug_options.verify_compilation ) {
+	if ( debug_options.verify_compilation && !budget.Interrupted() ) {
 //		manager.Display_Stat( cout );  // ToRemove
 		manager.Verify_DecDNNF( result );
 		manager.Verify_Entail_CNF( result, cnf );
@@ -133,6 +150,154 @@ NodeID DNNF_Compiler::Make_Root_Node( DecDNNF_Manager & manager, NodeID node )
 	return result;
 }
 
+bool DNNF_Compiler::Compile_In_Parallel( DecDNNF_Manager & manager, Heuristic heur, Chain & vorder, NodeID & result )
+{
+	/* NOTE:
+	* The root is split into tasks: one per component, and while there are fewer tasks than threads, the largest one is
+	* split on its most frequent variable into two conditioned tasks, which yields the top decision nodes.  Each task is
+	* compiled by an independent compiler with its own manager, inprocessor state and component cache, since node IDs
+	* and cached clause encodings are private to them.  The results are hash-consed into manager in the order of tasks.
+	*/
+	unsigned num_threads = running_options.compile_num_threads;
+	if ( num_threads == 0 ) num_threads = std::max( std::thread::hardware_concurrency(), 1u );
+	if ( num_threads == 1 ) return false;
+	StopWatch begin_watch;
+	if ( running_options.profile_compiling >= Profiling_Abstract ) begin_watch.Start();
+	Component root;
+	Generate_Init_Component( root );
+	vector<Component> comps( root.Vars_Size() / 2 + 1 );
+	unsigned num_comps = Dynamic_Decompose_Component( root, comps.data() );
+	vector<CNF_Formula *> cnfs( num_comps );
+	vector<Variable> split_vars( num_comps, Variable::undef );  // the decision variable of an inner task, whose branches are the next two tasks
+	vector<unsigned> low_tasks( num_comps, UNSIGNED_UNDEF );
+	for ( unsigned i = 0; i < num_comps; i++ ) {
+		cnfs[i] = Output_Original_Clauses_In_Component( comps[i] );
+	}
+	unsigned num_leaves = num_comps;
+	vector<unsigned> occurrences( _max_var + 1 );
+	while ( num_leaves < num_threads ) {
+		unsigned largest = UNSIGNED_UNDEF;
+		for ( unsigned i = 0; i < cnfs.size(); i++ ) {
+			if ( split_vars[i] != Variable::undef || cnfs[i]->Max_Var() == Variable::undef ) continue;
+			if ( largest == UNSIGNED_UNDEF || cnfs[i]->Num_Clauses() > cnfs[largest]->Num_Clauses() ) largest = i;
+		}
+		if ( largest == UNSIGNED_UNDEF || cnfs[largest]->Num_Clauses() == 0 ) break;
+		occurrences.assign( _max_var + 1, 0 );
+		for ( vector<Clause>::iterator itr = cnfs[largest]->Clause_Begin(); itr < cnfs[largest]->Clause_End(); itr++ ) {
+			for ( unsigned j = 0; j < itr->Size(); j++ ) {
+				occurrences[(*itr)[j].Var()]++;
+			}
+		}
+		Variable x = Variable::start;
+		for ( Variable y = Variable::start; y <= _max_var; y++ ) {
+			if ( occurrences[y] > occurrences[x] ) x = y;
+		}
+		split_vars[largest] = x;
+		low_tasks[largest] = cnfs.size();
+		for ( unsigned sign = 0; sign < 2; sign++ ) {
+			CNF_Formula * branch = new CNF_Formula( *cnfs[largest] );
+			branch->Condition( vector<Literal>( 1, Literal( x, sign ) ) );
+			cnfs.push_back( branch );
+			split_vars.push_back( Variable::undef );
+			low_tasks.push_back( UNSIGNED_UNDEF );
+		}
+		delete cnfs[largest];
+		cnfs[largest] = nullptr;
+		num_leaves++;
+	}
+	if ( num_leaves <= 1 ) {
+		delete cnfs[0];
+		return false;
+	}
+	vector<unsigned> order;
+	for ( unsigned i = 0; i < cnfs.size(); i++ ) {
+		if ( split_vars[i] == Variable::undef ) order.push_back( i );
+	}
+	sort( order.begin(), order.end(), [&]( unsigned a, unsigned b ) { return cnfs[a]->Num_Clauses() > cnfs[b]->Num_Clauses(); } );  // the largest first
+	if ( num_threads > num_leaves ) num_threads = num_leaves;
+	if ( running_options.display_compiling_process ) {
+		cout << running_options.display_prefix << "Compile " << num_comps << " components of the root as " << num_leaves << " tasks on " << num_threads << " threads..." << endl;
+	}
+	Running_Options options = running_options;
+	options.compile_num_threads = 1;
+	options.max_memory /= num_threads;
+	options.removing_redundant_nodes_trigger /= num_threads;
+	options.display_compiling_process = false;
+	options.display_preprocessing_process = false;
+	options.display_kernelizing_process = false;
+	options.display_counting_process = false;
+	options.profile_solving = Profiling_Close;
+	options.profile_preprocessing = Profiling_Close;
+	options.profile_compiling = std::min( running_options.profile_compiling, Profiling_Abstract );  // for the breakdown of workers
+	vector<DecDNNF_Manager *> managers( cnfs.size(), nullptr );
+	vector<NodeID> roots( cnfs.size() );
+	vector<Run_Status> statuses( cnfs.size(), Run_Done );
+	vector<unsigned> worker_tasks( num_threads, 0 ), worker_hits( num_threads, 0 );
+	vector<double> worker_times( num_threads, 0 );
+	atomic<unsigned> next( 0 );
+	atomic<bool> stopped( false );
+	auto work = [&]( unsigned w ) {
+		StopWatch watch;
+		watch.Start();
+		for ( unsigned k = next++; k < order.size() && !stopped; k = next++ ) {
+			unsigned i = order[k];
+			worker_tasks[w]++;
+			if ( cnfs[i]->Max_Var() == Variable::undef ) roots[i] = NodeID::bot;  // conditioning falsified a clause
+			else if ( cnfs[i]->Num_Clauses() == 0 ) roots[i] = NodeID::top;
+			else {
+				DNNF_Compiler compiler;
+				compiler.running_options = options;
+				compiler.debug_options = debug_options;
+				compiler.budget = budget.Share();
+				managers[i] = new DecDNNF_Manager( _max_var );
+				roots[i] = compiler.Compile( *managers[i], *cnfs[i], heur, vorder ).Root();
+				statuses[i] = compiler.budget.Status();
+				if ( compiler.budget.Interrupted() ) stopped = true;
+				if ( options.profile_compiling >= Profiling_Abstract ) worker_hits[w] += compiler.statistics.num_cache_hits;
+			}
+		}
+		worker_times[w] = watch.Get_Elapsed_Seconds();
+	};
+	vector<thread> workers;
+	for ( unsigned w = 0; w < num_threads; w++ ) {
+		workers.emplace_back( work, w );
+	}
+	for ( thread & worker: workers ) worker.join();
+	if ( stopped ) {  // the tasks are discarded, and result is bot as in an interrupted search
+		for ( unsigned i = 0; i < cnfs.size(); i++ ) {
+			if ( statuses[i] != Run_Done ) budget.Stop( statuses[i] );
+			delete managers[i];
+			delete cnfs[i];
+		}
+		result = NodeID::bot;
+		return true;
+	}
+	for ( unsigned i = cnfs.size() - 1; i != UNSIGNED_UNDEF; i-- ) {  /// NOTE: the branches of a task come after it
+		if ( split_vars[i] == Variable::undef ) {
+			if ( managers[i] != nullptr ) roots[i] = manager.Import_Nodes( *managers[i], roots[i] );
+			delete managers[i];
+			delete cnfs[i];
+		}
+		else {
+			Decision_Node bnode( split_vars[i], roots[low_tasks[i]], roots[low_tasks[i] + 1] );
+			roots[i] = manager.Add_Decision_Node( bnode );
+		}
+	}
+	_cdd_rnode.sym = CDD_SYMBOL_DECOMPOSE;
+	_cdd_rnode.ch_size = 0;
+	for ( unsigned i = 0; i < num_comps; i++ ) {
+		_cdd_rnode.Add_Child( roots[i] );
+	}
+	result = manager.Add_Decomposition_Node( _cdd_rnode );
+	if ( running_options.display_compiling_process && running_options.profile_compiling >= Profiling_Abstract ) {
+		for ( unsigned w = 0; w < num_threads; w++ ) {
+			cout << running_options.display_prefix << "Worker " << w << ": " << worker_tasks[w] << " tasks, " << worker_times[w] << "s, " << worker_hits[w] << " cache hits" << endl;
+		}
+		cout << running_options.display_prefix << "Tasks compiled in " << begin_watch.Get_Elapsed_Seconds() << "s" << endl;
+	}
+	return true;
+}
+
 void DNNF_Compiler::Choose_Running_Options( Heuristic heur, Chain & vorder )
 {
 	running_options.var_ordering_heur = heur;
@@ -240,6 +405,7 @@ void DNNF_Compiler::Compile_With_Implicite_BCP( DecDNNF_Manager & manager )
 	//		system( "pause" );
 			Display_Comp_And_Decision_Stacks( cerr );  // ToRemove
 		}
+		if ( budget.Active() && budget.Exhausted() ) break;
 		if ( Num_Components_On_Current_Level() <= 1 ) { // decision or preparation
 			switch ( _state_stack[_num_levels - 1] ) {
 			case 0:
@@ -370,7 +536,8 @@ void DNNF_Compiler::Compile_With_Implicite_BCP( DecDNNF_Manager & manager )
 			}
 		}
 	}
-	assert( _num_levels == old_num_levels - 1 && _num_rsl_stack == old_num_rsl_stack + 1 );
+	if ( _num_levels == old_num_levels - 1 ) assert( _num_rsl_stack == old_num_rsl_stack + 1 );
+	else Terminate_Compiling();
 }
 
 NodeID DNNF_Compiler::Make_Node_With_Imp( DecDNNF_Manager & manager, NodeID node  )
@@ -402,6 +569,7 @@ NodeID DNNF_Compiler::Make_Decision_Node( DecDNNF_Manager & manager, NodeID low,
 	}
 	if ( high != NodeID::bot ) _component_cache.Write_Result( Current_Component().caching_loc, result );
 	if ( Cache_Clear_Applicable( manager ) ) Component_Cache_Clear();
+	if ( _stats_snapshots.Due() ) _stats_snapshots.Write( *this );
 	if ( manager.Num_Nodes() >= _node_redundancy_factor * running_options.removing_redundant_nodes_trigger ) {
 		if ( high == NodeID::bot ) _rsl_stack[_num_rsl_stack++] = result;
 		unsigned old_size = manager.Num_Nodes();
@@ -449,6 +617,7 @@ void DNNF_Compiler::Compile_With_SAT_Imp_Computing( DecDNNF_Manager & manager )
 	//		system( "pause" );
 			Display_Comp_And_Decision_Stacks( cerr );  // ToRemove
 		}
+		if ( budget.Active() && budget.Exhausted() ) break;
 		if ( Num_Components_On_Current_Level() <= 1 ) { // decision or preparation
 			switch ( _state_stack[_num_levels - 1] ) {
 			case 0:
@@ -552,7 +721,8 @@ void DNNF_Compiler::Compile_With_SAT_Imp_Computing( DecDNNF_Manager & manager )
 			}
 		}
 	}
-	assert( _num_levels == 1 && _num_rsl_stack == 1 );
+	if ( _num_levels != 1 ) Terminate_Compiling();
+	assert( _num_rsl_stack == 1 || budget.Interrupted() );
 }
 
 bool DNNF_Compiler::Try_Shift_To_Implicite_BCP( DecDNNF_Manager & manager )
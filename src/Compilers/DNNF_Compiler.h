@@ -22,6 +22,7 @@ public:
 	CDDiagram Compile( DecDNNF_Manager & manager, CNF_Formula & cnf, Heuristic heur = AutomaticalHeur, Chain & vorder = Chain::default_empty_chain );  // Reset outside
 protected:
 	NodeID Make_Root_Node( DecDNNF_Manager & manager, NodeID node );
+	bool Compile_In_Parallel( DecDNNF_Manager & manager, Heuristic heur, Chain & vorder, NodeID & result );
 	void Choose_Running_Options( Heuristic heur, Chain & vorder );
 	void Compute_Var_Order_Automatical();
 	void Choose_Implicate_Computing_Strategy();
@@ -101,7 +102,11 @@ public:
 		compiler.running_options.display_kernelizing_process = false;
 		compiler.running_options.cache_encoding = Parse_Cache_Encoding_Strategy( parameters.cache_enc );
 		compiler.running_options.max_memory = parameters.memo;
+		compiler.running_options.stats_json_file = parameters.stats_json;
+		compiler.running_options.stats_interval = parameters.stats_interval;
+		compiler.Set_Budget( parameters );
 		compiler.running_options.removing_redundant_nodes_trigger *= parameters.memo / 4;
+		compiler.running_options.compile_num_threads = parameters.threads;
 		Heuristic heur = Parse_Heuristic( parameters.heur );
 		if ( heur != AutomaticalHeur && heur != minfill && heur != LinearLRW && heur != DLCP && heur != dynamic_minfill ) {
 			cerr << "ERROR: the heuristic is not supported yet!" << endl;
@@ -121,8 +126,15 @@ public:
 				if ( parameters.CT ) cout << compiler.running_options.display_prefix << "Number of models: " << cnf.Known_Count() << endl;
 				return;
 			}
-			DecDNNF_Manager manager( cnf.Max_Var() );
+			DecDNNF_Manager manager( cnf.Max_Var(), Fit_Hash_Table_Size( cnf.Num_Vars(), cnf.Num_Clauses(), 0, parameters.memo ) );
+			if ( parameters.stream ) manager.Open_Stream( parameters.out_file );
 			CDDiagram dnnf = compiler.Compile( manager, cnf, heur );
+			if ( parameters.stats_json.Exists() ) Write_Statistics_File( compiler, parameters.stats_json );
+			if ( compiler.budget.Interrupted() ) {
+				cout << compiler.running_options.display_prefix << "Compilation stopped (" << Run_Status_Name( compiler.budget.Status() ) << "), and the queries are skipped" << endl;
+				return;
+			}
+			if ( parameters.stream ) manager.Close_Stream( dnnf.Root() );
 			compiler._component_cache.Shrink_To_Fit();
 			manager.Remove_Redundant_Nodes();
 			vector<double> weights( 2 * cnf.Max_Var() + 2 );
@@ -171,7 +183,7 @@ public:
 				fout.close();
 				cout << compiler.running_options.display_prefix << "Samples saved to " << sample_file << endl;
 			}
-			if ( parameters.out_file != nullptr ) {
+			if ( parameters.out_file != nullptr && !parameters.stream ) {
 				ofstream fout( parameters.out_file );
 				manager.Display( fout );
 				fout.close();
@@ -190,8 +202,15 @@ public:
 				if ( parameters.CT ) cout << compiler.running_options.display_prefix << "Number of models: " << cnf.Known_Count() << endl;
 				return;
 			}
-			DecDNNF_Manager manager( cnf.Max_Var() );
+			DecDNNF_Manager manager( cnf.Max_Var(), Fit_Hash_Table_Size( cnf.Num_Vars(), cnf.Num_Clauses(), 0, parameters.memo ) );
+			if ( parameters.stream ) manager.Open_Stream( parameters.out_file );
 			CDDiagram dnnf = compiler.Compile( manager, cnf, heur );
+			if ( parameters.stats_json.Exists() ) Write_Statistics_File( compiler, parameters.stats_json );
+			if ( compiler.budget.Interrupted() ) {
+				cout << compiler.running_options.display_prefix << "Compilation stopped (" << Run_Status_Name( compiler.budget.Status() ) << "), and the queries are skipped" << endl;
+				return;
+			}
+			if ( parameters.stream ) manager.Close_Stream( dnnf.Root() );
 			if ( parameters.CT || parameters.US.Exists() ) {
 				compiler._component_cache.Shrink_To_Fit();
 				manager.Remove_Redundant_Nodes();
@@ -291,7 +310,7 @@ public:
 				fout.close();
 				cout << compiler.running_options.display_prefix << "Samples saved to " << sample_file << endl;
 			}
-			if ( parameters.out_file != nullptr ) {
+			if ( parameters.out_file != nullptr && !parameters.stream ) {
 				ofstream fout( parameters.out_file );
 				manager.Display( fout );
 				fout.close();
@@ -312,6 +331,9 @@ public:
 		compiler.running_options.trivial_variable_bound = 128;
 		compiler.running_options.display_kernelizing_process = false;
 		compiler.running_options.max_memory = parameters.memo;
+		compiler.running_options.stats_json_file = parameters.stats_json;
+		compiler.running_options.stats_interval = parameters.stats_interval;
+		compiler.Set_Budget( parameters );
 		compiler.running_options.removing_redundant_nodes_trigger *= parameters.memo / 4;
 		if ( quiet ) {
 			compiler.running_options.profile_solving = Profiling_Close;
@@ -325,8 +347,13 @@ public:
 			cerr << "ERROR: empty instance!" << endl;
 			return;
 		}
-		DecDNNF_Manager manager( cnf.Max_Var() );
+		DecDNNF_Manager manager( cnf.Max_Var(), Fit_Hash_Table_Size( cnf.Num_Vars(), cnf.Num_Clauses(), 0, parameters.memo ) );
 		CDDiagram dnnf = compiler.Compile( manager, cnf, AutomaticalHeur );
+		if ( parameters.stats_json.Exists() ) Write_Statistics_File( compiler, parameters.stats_json );
+		if ( compiler.budget.Interrupted() ) {
+			cout << compiler.running_options.display_prefix << "Compilation stopped (" << Run_Status_Name( compiler.budget.Status() ) << "), and no samples are drawn" << endl;
+			return;
+		}
 		compiler._component_cache.Shrink_To_Fit();
 		Random_Generator rand_gen;
 		vector<vector<bool>> samples( parameters.nsamples );
@@ -4,11 +4,141 @@
 namespace KCBox {
 
 
+void Parallel_Estimates::Update( unsigned stream, const BigFloat & estimate, unsigned samples )
+{
+	lock_guard<mutex> lock( _mutex );
+	_estimates[stream] = estimate;
+	_samples[stream] = samples;
+}
+
+void Parallel_Estimates::Update_Known( const BigFloat & count )
+{
+	lock_guard<mutex> lock( _mutex );
+	_known = true;
+	_known_count = count;
+	_stopped = true;
+}
+
+unsigned Parallel_Estimates::Combine( BigFloat & mean, double & relative_error, double z )
+{
+	lock_guard<mutex> lock( _mutex );
+	unsigned total = 0;
+	for ( unsigned samples: _samples ) total += samples;
+	relative_error = 0;
+	if ( _known ) {
+		mean = _known_count;
+		return total;
+	}
+	/// Welford's online algorithm over the streams that have sampled
+	BigFloat delta, m2 = 0;
+	unsigned n = 0;
+	mean = 0;
+	for ( unsigned i = 0; i < _estimates.size(); i++ ) {
+		if ( _samples[i] == 0 ) continue;
+		n++;
+		delta = _estimates[i];
+		delta -= mean;
+		mean += delta / n;
+		BigFloat tmp = _estimates[i];
+		tmp -= mean;
+		m2 += delta * tmp;
+	}
+	if ( n >= 2 && mean > 0 ) {
+		BigFloat variance = m2 / ( 1.0 * (n - 1) * n );  // the variance of the mean
+		variance /= mean * mean;
+		relative_error = z * sqrt( variance.TransformDouble() );
+	}
+	return total;
+}
+
+Shared_Known_Counts::Shared_Known_Counts( size_t max_memory ):
+_num_entries( 0 ),
+_memory( 0 ),
+_max_memory( max_memory ),
+_num_hits( 0 )
+{
+	size_t num_slots = 1 << 12;
+	while ( num_slots < ( 1 << 22 ) && num_slots * 1024 < max_memory ) num_slots <<= 1;
+	_slots = new atomic<Entry *> [num_slots];
+	_mask = num_slots - 1;
+	for ( size_t i = 0; i < num_slots; i++ ) {
+		_slots[i].store( nullptr, memory_order_relaxed );
+	}
+}
+
+Shared_Known_Counts::~Shared_Known_Counts()
+{
+	for ( size_t i = 0; i <= _mask; i++ ) {
+		delete _slots[i].load( memory_order_relaxed );
+	}
+	delete [] _slots;
+}
+
+uint64_t Shared_Known_Counts::Encode( CNF_Formula & cnf, vector<unsigned> & code )
+{
+	code.clear();
+	code.push_back( cnf.Max_Var() );
+	for ( unsigned i = 0; i < cnf.Num_Clauses(); i++ ) {
+		Clause & clause = cnf[i];
+		for ( unsigned j = 0; j < clause.Size(); j++ ) {
+			code.push_back( clause[j] );
+		}
+		code.push_back( UNSIGNED_UNDEF );
+	}
+	uint64_t key = 0xcbf29ce484222325ULL;  // FNV-1a
+	for ( unsigned item: code ) {
+		key ^= item;
+		key *= 0x100000001b3ULL;
+	}
+	return key;
+}
+
+bool Shared_Known_Counts::Find( const vector<unsigned> & code, uint64_t key, BigInt & count )
+{
+	for ( unsigned i = 0; i < _max_probes; i++ ) {
+		Entry * entry = _slots[(key + i) & _mask].load( memory_order_acquire );
+		if ( entry == nullptr ) return false;
+		if ( entry->key == key && entry->code == code ) {
+			entry->hits.fetch_add( 1, memory_order_relaxed );
+			_num_hits.fetch_add( 1, memory_order_relaxed );
+			count = entry->count;
+			return true;
+		}
+	}
+	return false;
+}
+
+void Shared_Known_Counts::Insert( vector<unsigned> & code, uint64_t key, const BigInt & count )
+{
+	size_t mem = sizeof(Entry) + code.size() * sizeof(unsigned);
+	if ( _memory.load( memory_order_relaxed ) + mem > _max_memory ) return;
+	if ( 2 * _num_entries.load( memory_order_relaxed ) > _mask ) return;  // keep the probing sequences short
+	Entry * entry = new Entry( key, code, count );
+	for ( unsigned i = 0; i < _max_probes; i++ ) {
+		atomic<Entry *> & slot = _slots[(key + i) & _mask];
+		Entry * expected = slot.load( memory_order_acquire );
+		while ( expected == nullptr ) {
+			if ( slot.compare_exchange_weak( expected, entry, memory_order_release, memory_order_acquire ) ) {
+				_num_entries.fetch_add( 1, memory_order_relaxed );
+				_memory.fetch_add( mem, memory_order_relaxed );
+				return;
+			}
+		}
+		if ( expected->key == key && expected->code == entry->code ) break;  // another stream inserted it
+	}
+	code.swap( entry->code );
+	delete entry;
+}
+
+
 Partial_CCDD_Compiler::Partial_CCDD_Compiler():
 _num_rsl_stack( 0 ),
 _num_pmc_rsl_stack( 0 ),
 _node_redundancy_factor( 1 ),
-_store_one_model( false )
+_store_one_model( false ),
+_parallel_estimates( nullptr ),
+_shared_known_counts( nullptr ),
+_stream_id( 0 )
 {
 }
 
@@ -302,7 +432,7 @@ void Partial_CCDD_Compiler::Create_Init_Level( bool initial )
 		_active_comps[1] = 0;
 		_num_levels = 2;
 		if ( running_options.profile_compiling >= Profiling_Abstract ) tmp_watch.Start();
-		_component_cache.Init( _max_var, _old_num_long_clauses, NodeID::undef );
+		_component_cache.Init( _max_var, _old_num_long_clauses, NodeID::undef, Fitted_Table_Size() );
 		Component_Cache_Add_Original_Clauses();
 		_component_cache.Hit_Component( _comp_stack[0] );
 		if ( running_options.profile_compiling >= Profiling_Abstract ) statistics.time_gen_cnf_cache = tmp_watch.Get_Elapsed_Seconds();
@@ -455,6 +585,7 @@ NodeID Partial_CCDD_Compiler::Make_Node_With_Imp( Partial_CCDD_Manager & manager
 
 NodeID Partial_CCDD_Compiler::Component_Cache_Map( Component & comp )
 {
+	Trace_Scope trace( Trace_Cache_Lookup );
 	StopWatch tmp_watch;
 	if ( running_options.profile_compiling >= Profiling_Abstract ) tmp_watch.Start();
 	if ( _current_kdepth <= 1 ) comp.caching_loc = _component_cache.Hit_Component( comp );
@@ -678,6 +809,16 @@ BigInt Partial_CCDD_Compiler::Count_Models_Simple_Component( Component & comp, v
 {
 	assert( !models.empty() );
 	CNF_Formula * cnf = Output_Renamed_Clauses_In_Component( comp );
+	vector<unsigned> code;
+	uint64_t key = 0;
+	if ( _shared_known_counts != nullptr ) {
+		key = Shared_Known_Counts::Encode( *cnf, code );
+		BigInt count;
+		if ( _shared_known_counts->Find( code, key, count ) ) {
+			delete cnf;
+			return count;
+		}
+	}
 	vector<Model *> borrowed_models;
 	_exact_counter.Set_Max_Var( cnf->Max_Var() );
 	_exact_counter.Lend_Models( borrowed_models, models.size() );  // transforming models
@@ -688,6 +829,7 @@ BigInt Partial_CCDD_Compiler::Count_Models_Simple_Component( Component & comp, v
 	}
 	BigInt result = _exact_counter.Count_Models( *cnf, borrowed_models, timeout );
 	delete cnf;
+	if ( _shared_known_counts != nullptr && !( result < 0 ) ) _shared_known_counts->Insert( code, key, result );
 	return result;
 }
 
@@ -1092,7 +1234,7 @@ double Partial_CCDD_Compiler::Estimate_Posterior_Probability( Variable var, Comp
 	_state_stack[_num_levels - 1] = 1;
 	_comp_stack[_num_comp_stack++] = comp;
 	if ( running_options.profile_compiling >= Profiling_Abstract ) tmp_watch.Start();
-	_pmc_component_cache.Init( _max_var, _old_num_long_clauses, -1 );
+	_pmc_component_cache.Init( _max_var, _old_num_long_clauses, -1, Fitted_Table_Size() );
 	_pmc_component_cache.Hit_Component( _comp_stack[_num_comp_stack - 1] );
 	if ( running_options.profile_compiling >= Profiling_Abstract ) statistics.time_gen_cnf_cache += tmp_watch.Get_Elapsed_Seconds();
 	if ( DEBUG_OFF ) debug_options.verify_component_count = comp.Vars_Size() <= _projected_vars.size();
@@ -1452,7 +1594,14 @@ void Partial_CCDD_Compiler::Estimate_Posterior_Probability_With_Implicite_BCP_Op
 				Backtrack_True_PMC();
 				break;
 			}
-			else if ( Is_Current_Level_Decision() ) _state_stack[_num_levels - 1]++;
+			else if ( Is_Current_Level_Decision() ) {
+				double cached_result = Component_Cache_Map_PMC( Current_Component() );  /// NOTE: Backtrack_Decision_PMC writes back to caching_loc
+				if ( cached_result != -1 ) {
+					Backtrack_Known_PMC( cached_result );
+					break;
+				}
+				_state_stack[_num_levels - 1]++;
+			}
 			else _state_stack[_num_levels - 1] = 0;
 			Estimate_Posterior_Probability_With_Implicite_BCP();
 			break;
@@ -1870,6 +2019,17 @@ void Partial_CCDD_Compiler::Display_Memory_Status( ostream & out )
 	out << running_options.display_prefix << "Total memory: " << Memory() / (1.0 * 1024 * 1024) << "M" << endl;
 }
 
+void Partial_CCDD_Compiler::Write_Statistics_JSON( JSON_Writer & writer )
+{
+	Solver::Write_Statistics_JSON( writer );
+	writer.Begin_Object( "component_cache" );
+	_component_cache.Write_JSON( writer );
+	writer.End_Object();
+	writer.Begin_Object( "pmc_component_cache" );
+	_pmc_component_cache.Write_JSON( writer );
+	writer.End_Object();
+}
+
 void Partial_CCDD_Compiler::Display_Result_Stack( ostream & out )
 {
 	unsigned num = 0;
@@ -1922,6 +2082,7 @@ BigFloat Partial_CCDD_Compiler::Count_Models_Approximately( CNF_Formula & cnf, H
 	if ( running_options.display_compiling_process ) cout << running_options.display_prefix << "Counting models..." << endl;
 	if ( running_options.profile_partial_kc >= Profiling_Abstract ) begin_watch.Start();
 	Allocate_and_Init_Auxiliary_Memory( cnf.Max_Var() );
+	budget.Start();
 	assert( _num_levels == 0 && _num_dec_stack == 0 && _num_comp_stack == 0 );
 	assert( running_options.sampling_count > 0 );
 	if ( running_options.display_compiling_process ) cout << running_options.display_prefix << "Begin preprocess..." << endl;
@@ -1937,7 +2098,8 @@ BigFloat Partial_CCDD_Compiler::Count_Models_Approximately( CNF_Formula & cnf, H
 			if ( running_options.profile_compiling >= Profiling_Abstract ) {
 				Display_Statistics( 0 );
 			}
-			cout << running_options.display_prefix << "The final model count: " << 0 << endl;
+			if ( budget.Interrupted() ) cout << running_options.display_prefix << "The final model count: unknown (" << Run_Status_Name( budget.Status() ) << ")" << endl;
+			else cout << running_options.display_prefix << "The final model count: " << 0 << endl;
 		}
 		Reset();
 		return 0;
@@ -1985,6 +2147,76 @@ BigFloat Partial_CCDD_Compiler::Count_Models_Approximately( CNF_Formula & cnf, H
 		if ( running_options.profile_partial_kc >= Profiling_Abstract ) {
 			Display_Statistics( 1 );
 		}
+		if ( _parallel_estimates == nullptr ) cout << running_options.display_prefix << "The final model count: " << final_result << endl;
+	}
+	return final_result;
+}
+
+BigFloat Partial_CCDD_Compiler::Count_Models_Approximately_In_Parallel( CNF_Formula & cnf, Heuristic heur )
+{
+	unsigned num_streams = running_options.sampling_num_threads;
+	if ( num_streams == 0 ) num_streams = std::max( std::thread::hardware_concurrency(), 1u );
+	if ( num_streams == 1 ) return Count_Models_Approximately( cnf, heur );
+	Parallel_Estimates estimates( num_streams );
+	Shared_Known_Counts known_counts( running_options.max_memory * 1024 * 1024 * 1024 / 16 );
+	vector<Partial_CCDD_Compiler *> helpers( num_streams - 1 );
+	vector<CNF_Formula *> cnfs( num_streams - 1 );
+	vector<BigFloat> results( num_streams );
+	/// NOTE: the streams share the sampling budget and the memory, but each one draws from its own random sequence
+	if ( running_options.sampling_count != UNSIGNED_UNDEF ) {
+		running_options.sampling_count = ( running_options.sampling_count + num_streams - 1 ) / num_streams;
+	}
+	running_options.max_memory /= num_streams;
+	running_options.removing_redundant_nodes_trigger /= num_streams;
+	for ( unsigned i = 0; i < num_streams - 1; i++ ) {
+		helpers[i] = new Partial_CCDD_Compiler;
+		helpers[i]->running_options = running_options;
+		helpers[i]->debug_options = debug_options;
+		helpers[i]->running_options.display_compiling_process = false;
+		helpers[i]->running_options.display_preprocessing_process = false;
+		helpers[i]->running_options.display_kernelizing_process = false;
+		helpers[i]->running_options.display_counting_process = false;
+		helpers[i]->running_options.profile_solving = Profiling_Close;
+		helpers[i]->running_options.profile_preprocessing = Profiling_Close;
+		helpers[i]->running_options.profile_compiling = Profiling_Close;
+		helpers[i]->running_options.stats_json_file = nullptr;  // only the first stream writes the statistics
+		helpers[i]->_rand_gen.Reset( _rand_gen.Generate_Int() );
+		helpers[i]->_parallel_estimates = &estimates;
+		helpers[i]->_shared_known_counts = &known_counts;
+		helpers[i]->_stream_id = i + 1;
+		cnfs[i] = new CNF_Formula( cnf );
+	}
+	budget.Start();
+	for ( unsigned i = 0; i < num_streams - 1; i++ ) {
+		helpers[i]->budget = budget.Share();
+	}
+	_parallel_estimates = &estimates;
+	_shared_known_counts = &known_counts;
+	_stream_id = 0;
+	vector<thread> workers;
+	for ( unsigned i = 0; i < num_streams - 1; i++ ) {
+		workers.emplace_back( [&, i]() { results[i + 1] = helpers[i]->Count_Models_Approximately( *cnfs[i], heur ); } );
+	}
+	results[0] = Count_Models_Approximately( cnf, heur );
+	for ( thread & worker: workers ) worker.join();
+	_parallel_estimates = nullptr;
+	_shared_known_counts = nullptr;
+	for ( unsigned i = 0; i < num_streams - 1; i++ ) {
+		if ( helpers[i]->budget.Interrupted() && !budget.Interrupted() ) budget.Stop( helpers[i]->budget.Status() );
+		delete helpers[i];
+		delete cnfs[i];
+	}
+	BigFloat final_result;
+	double error;
+	unsigned total = estimates.Combine( final_result, error );
+	if ( total == 0 ) final_result = results[0];  // solved without sampling
+	if ( running_options.display_compiling_process ) {
+		cout << running_options.display_prefix << "Number of streams: " << num_streams << endl;
+		cout << running_options.display_prefix << "Number of samples: " << total << endl;
+		cout << running_options.display_prefix << "Number of shared known counts: " << known_counts.Size() << " (" << known_counts.Num_Hits() << " hits)" << endl;
+		if ( total > 0 && error > 0 ) {
+			cout << running_options.display_prefix << "The 95% confidence interval: " << final_result << " +/- " << error * 100 << "%" << endl;
+		}
 		cout << running_options.display_prefix << "The final model count: " << final_result << endl;
 	}
 	return final_result;
@@ -2059,9 +2291,15 @@ BigFloat Partial_CCDD_Compiler::Count_With_One_Round( Partial_CCDD_Manager & man
 {
 	if ( _component_cache.Empty() ) Copy_Models( _models_stack[0], _stored_models );
 	BigFloat pre_result = 0, current_result, final_result;
-	unsigned previous_sample, current_sample;
+	unsigned previous_sample = 0, current_sample = 1;
 	unsigned interval = running_options.sampling_display_interval;
-	for ( previous_sample = 0, current_sample = 1; current_sample <= running_options.sampling_count; current_sample++ ) {
+	double resumed_elapsed = 0;  // the sampling time before resuming
+	unsigned checkpointed_sample = 0;
+	if ( running_options.checkpoint_file != nullptr ) {
+		Open_Checkpoint( manager, pre_result, current_result, previous_sample, current_sample, interval, resumed_elapsed );
+	}
+	_stats_snapshots.Open( running_options.stats_json_file, running_options.stats_interval );
+	for ( ; current_sample <= running_options.sampling_count; current_sample++ ) {
 		unsigned old_cache_size = _component_cache.Size();
 		Create_Init_Level( _component_cache.Empty() );
 		Microcompile_Opt( manager );
@@ -2074,7 +2312,11 @@ BigFloat Partial_CCDD_Compiler::Count_With_One_Round( Partial_CCDD_Manager & man
 		}
 		current_result = manager.Node( _rsl_stack[0] ).weight;
 		current_result.Div_2exp( _fixed_num_vars + _call_stack[0].Lit_Equivalences_Size() );
-		if ( _store_one_model && Is_Memory_Tight( manager, old_cache_size ) ) {
+		bool frozen_root = _rsl_stack[0] < manager.Num_Nodes() && manager.Node( _rsl_stack[0] ).frozen;  // every sampled branch has been evicted
+		if ( _store_one_model && !frozen_root && Is_Memory_Tight( manager, old_cache_size ) ) {
+			if ( !running_options.evict_cold_nodes || !Evict_Cold_Nodes( manager, _rsl_stack[0] ) ) frozen_root = true;
+		}
+		if ( frozen_root ) {
 			if ( running_options.display_compiling_process ) cout << running_options.display_prefix << "Out of memory and restart" << endl;
 //			cout << previous_sample << " * " << pre_result << " vs " << current_sample - previous_sample << " * " << nr_stack[0]->weight;  // ToRemove
 			pre_result.Mean( pre_result, current_result, 1.0 * previous_sample / current_sample );
@@ -2087,26 +2329,161 @@ BigFloat Partial_CCDD_Compiler::Count_With_One_Round( Partial_CCDD_Manager & man
 			Copy_Models( _stored_models, _models_stack[0] );
 			_store_one_model = false;
 		}
+		if ( _parallel_estimates != nullptr ) {
+			final_result.Mean( pre_result, current_result, 1.0 * previous_sample / current_sample );
+			Publish_Estimate( manager, final_result, current_sample, begin_watch );
+		}
 		if ( running_options.display_compiling_process && current_sample % interval == 0 ) {
 			final_result.Mean( pre_result, current_result, 1.0 * previous_sample / current_sample );
-			cout << running_options.display_prefix << current_sample << "(" << begin_watch.Get_Elapsed_Seconds() << "s): " << final_result << endl;
+			cout << running_options.display_prefix << current_sample << "(" << begin_watch.Get_Elapsed_Seconds() << "s): " << final_result;
+			if ( _parallel_estimates != nullptr ) {
+				BigFloat combined;
+				double error;
+				unsigned total = _parallel_estimates->Combine( combined, error );
+				cout << ", combined " << total << ": " << combined << " +/- " << error * 100 << "%";
+			}
+			cout << endl;
 			if ( current_sample >= interval * 1000 ) interval *= 10;
 		}
-		if ( _rsl_stack[0] < manager.Num_Nodes() && manager.Node( _rsl_stack[0] ).sym == SEARCH_KNOWN ) {
+		if ( _checkpoint_writer.Due() ) {
+			Write_Checkpoint( manager, pre_result, previous_sample, current_sample, interval, resumed_elapsed + begin_watch.Get_Elapsed_Seconds() );
+			checkpointed_sample = current_sample;
+		}
+		if ( _stats_snapshots.Due() ) _stats_snapshots.Write( *this );
+		if ( _rsl_stack[0] < manager.Num_Nodes() && manager.Node( _rsl_stack[0] ).sym == SEARCH_KNOWN && !manager.Node( _rsl_stack[0] ).frozen ) {
 			if ( running_options.display_compiling_process ) cout << running_options.display_prefix << "Converged" << endl;
 			break;
 		}
-		if ( Timeout_Possibly( current_sample, begin_watch.Get_Elapsed_Seconds() ) ) break;
+		if ( _parallel_estimates != nullptr && _parallel_estimates->Stopped() ) break;  // another stream converged
+		if ( Timeout_Possibly( current_sample, resumed_elapsed + begin_watch.Get_Elapsed_Seconds() ) ) break;
+		if ( budget.Active() && budget.Exhausted( 0 ) ) break;  // a sample is long, so the clock is read after each one
+	}
+	if ( _checkpoint_writer.Opened() ) {  // the final state, so that a later run with a larger budget goes on from here
+		unsigned num_samples = current_sample > running_options.sampling_count ? current_sample - 1 : current_sample;  // the loop ends normally or breaks
+		if ( num_samples != checkpointed_sample ) {
+			Write_Checkpoint( manager, pre_result, previous_sample, num_samples, interval, resumed_elapsed + begin_watch.Get_Elapsed_Seconds() );
+		}
+		_checkpoint_writer.Close();
 	}
-	if ( _rsl_stack[0] < manager.Num_Nodes() && manager.Node( _rsl_stack[0] ).sym == SEARCH_KNOWN ) {
+	if ( _rsl_stack[0] < manager.Num_Nodes() && manager.Node( _rsl_stack[0] ).sym == SEARCH_KNOWN && !manager.Node( _rsl_stack[0] ).frozen ) {
 		final_result = manager.Node( _rsl_stack[0] ).weight;
 		final_result.Div_2exp( _fixed_num_vars + _call_stack[0].Lit_Equivalences_Size() );
 	}
 	else final_result.Mean( pre_result, current_result, 1.0 * previous_sample / current_sample );
+	if ( _parallel_estimates != nullptr ) Publish_Estimate( manager, final_result, min( current_sample, running_options.sampling_count ), begin_watch );
 	if ( _component_cache.Empty() ) Recycle_Models( _stored_models );
 	return final_result;
 }
 
+void Partial_CCDD_Compiler::Open_Checkpoint( Partial_CCDD_Manager & manager, BigFloat & pre_result, BigFloat & current_result, unsigned & previous_sample, \
+	unsigned & current_sample, unsigned & interval, double & elapsed )
+{
+	assert( _parallel_estimates == nullptr && _component_cache.Empty() );
+	_checkpoint_fingerprint = Fingerprint_Original_Clauses();
+	unsigned num_samples;
+	if ( running_options.resume_from_checkpoint && Load_Checkpoint( manager, pre_result, previous_sample, num_samples, interval, elapsed ) ) {
+		current_sample = num_samples + 1;
+		if ( _component_cache.Empty() ) current_result = 0;
+		else {
+			current_result = manager.Node( _rsl_stack[0] ).weight;
+			current_result.Div_2exp( _fixed_num_vars + _call_stack[0].Lit_Equivalences_Size() );
+		}
+		if ( running_options.display_compiling_process ) {
+			cout << running_options.display_prefix << "Resume from " << running_options.checkpoint_file << " after " << num_samples << " samples (" << elapsed << "s)";
+			cout << " with " << manager.Num_Nodes() << " nodes" << endl;
+		}
+	}
+	_checkpoint_writer.Open( running_options.checkpoint_file, running_options.checkpoint_interval );
+}
+
+void Partial_CCDD_Compiler::Write_Checkpoint( Partial_CCDD_Manager & manager, const BigFloat & pre_result, unsigned previous_sample, \
+	unsigned num_samples, unsigned interval, double elapsed )
+{
+	assert( _num_levels == 1 && _num_rsl_stack == 0 );  // between two samples
+	ostringstream out;
+	_checkpoint_writer.Write_Header( out, Checkpoint_PartialKC, _checkpoint_fingerprint );
+	Write_Binary( out, pre_result );
+	Write_Binary( out, previous_sample );
+	Write_Binary( out, num_samples );
+	Write_Binary( out, interval );
+	Write_Binary( out, elapsed );
+	Write_Binary( out, _store_one_model );
+	Write_Binary( out, running_options.mem_load_factor );
+	_rand_gen.Write( out );
+	bool has_dag = !_component_cache.Empty();  // empty after a restart
+	Write_Binary( out, has_dag );
+	if ( has_dag ) {
+		Write_Binary( out, _comp_stack[0].caching_loc );
+		Write_Binary( out, _rsl_stack[0] );
+		_component_cache.Write_Checkpoint( out );
+		manager.Write_Checkpoint( out );
+	}
+	string data = out.str();
+	if ( running_options.display_compiling_process ) {
+		cout << running_options.display_prefix << "Checkpoint " << _checkpoint_writer.Num_Written() + 1 << " after " << num_samples << " samples: " << data.size() / 1024 << " KB" << endl;
+	}
+	_checkpoint_writer.Write_Async( data );
+}
+
+bool Partial_CCDD_Compiler::Load_Checkpoint( Partial_CCDD_Manager & manager, BigFloat & pre_result, unsigned & previous_sample, \
+	unsigned & num_samples, unsigned & interval, double & elapsed )
+{
+	stringstream in;
+	if ( !Checkpoint_Writer::Read_File( running_options.checkpoint_file, Checkpoint_PartialKC, _checkpoint_fingerprint, in ) ) return false;
+	BigFloat saved_pre_result;
+	unsigned saved_previous_sample, saved_num_samples, saved_interval;
+	double saved_elapsed;
+	bool store_one_model, has_dag;
+	float mem_load_factor;
+	Random_Generator rand_gen;
+	bool success = Read_Binary( in, saved_pre_result ) && Read_Binary( in, saved_previous_sample ) && Read_Binary( in, saved_num_samples );
+	success = success && Read_Binary( in, saved_interval ) && Read_Binary( in, saved_elapsed ) && Read_Binary( in, store_one_model );
+	success = success && Read_Binary( in, mem_load_factor ) && rand_gen.Read( in ) && Read_Binary( in, has_dag );
+	if ( success && has_dag ) {
+		CacheEntryID root_loc;
+		NodeID root;
+		success = Read_Binary( in, root_loc ) && Read_Binary( in, root );
+		Create_Init_Level( true );
+		success = success && _component_cache.Read_Checkpoint( in ) && root_loc < _component_cache.Size();
+		success = success && manager.Read_Checkpoint( in, _model_pool ) && root < manager.Num_Nodes();
+		Backtrack();
+		Recycle_Models( _models_stack[0] );  // the models are kept in _stored_models and in the nodes
+		if ( success ) {
+			_comp_stack[0].caching_loc = root_loc;
+			_rsl_stack[0] = root;
+			_num_rsl_stack = 0;
+		}
+		else {
+			manager.Clear( _model_pool );
+			_component_cache.Reset();
+			Copy_Models( _stored_models, _models_stack[0] );
+		}
+	}
+	if ( !success ) {
+		cerr << "Warning[Partial_CCDD_Compiler]: " << running_options.checkpoint_file << " is truncated or mismatched, and start from scratch!" << endl;
+		return false;
+	}
+	pre_result = saved_pre_result;
+	previous_sample = saved_previous_sample;
+	num_samples = saved_num_samples;
+	interval = saved_interval;
+	elapsed = saved_elapsed;
+	_store_one_model = store_one_model;
+	running_options.mem_load_factor = mem_load_factor;
+	_rand_gen = rand_gen;
+	return true;
+}
+
+void Partial_CCDD_Compiler::Publish_Estimate( Partial_CCDD_Manager & manager, const BigFloat & estimate, unsigned samples, StopWatch & begin_watch )
+{
+	if ( _rsl_stack[0] < manager.Num_Nodes() && manager.Node( _rsl_stack[0] ).sym == SEARCH_KNOWN && !manager.Node( _rsl_stack[0] ).frozen ) {
+		BigFloat exact = manager.Node( _rsl_stack[0] ).weight;
+		exact.Div_2exp( _fixed_num_vars + _call_stack[0].Lit_Equivalences_Size() );
+		_parallel_estimates->Update_Known( exact );
+	}
+	else _parallel_estimates->Update( _stream_id, estimate, samples );
+}
+
 void Partial_CCDD_Compiler::Microcompile_Opt( Partial_CCDD_Manager & manager )
 {
 	Variable var;
@@ -2318,8 +2695,9 @@ bool Partial_CCDD_Compiler::Is_Memory_Tight( Partial_CCDD_Manager & manager, uns
 	size_t evaluated_mem = _component_cache.Memory() + _model_pool->Memory() + manager.Memory() + _exact_counter.Memory();
 	if ( evaluated_mem < max_mem * (running_options.mem_load_factor - delta) ) return false;
 	if ( evaluated_mem > max_mem * (running_options.mem_load_factor + delta) ) return true;
-	size_t true_mem = Total_Used_Memory();
-	running_options.mem_load_factor = evaluated_mem / true_mem;
+	size_t true_mem = max<size_t>( Memory_Ledger::Total(), 1 );
+	if ( _parallel_estimates != nullptr ) true_mem /= _parallel_estimates->Num_Streams();  // the share of this stream
+	running_options.mem_load_factor = (double) evaluated_mem / true_mem;
 	if ( running_options.mem_load_factor - delta < 0 ) running_options.mem_load_factor = delta;
 	else if ( running_options.mem_load_factor + delta > 1 ) running_options.mem_load_factor = 1 - delta;
 	if ( running_options.profile_compiling != Profiling_Close ) {
@@ -2358,6 +2736,60 @@ void Partial_CCDD_Compiler::Remove_Redundant_Nodes( Partial_CCDD_Manager & manag
 	if ( running_options.profile_compiling >= Profiling_Abstract ) statistics.time_gen_dag += watch.Get_Elapsed_Seconds();
 }
 
+bool Partial_CCDD_Compiler::Evict_Cold_Nodes( Partial_CCDD_Manager & manager, NodeID & root )
+{
+	Trace_Scope trace( Trace_Cache_Clear );
+	assert( _num_rsl_stack == 0 );
+	StopWatch watch;
+	if ( running_options.profile_compiling >= Profiling_Abstract ) watch.Start();
+	unsigned old_num_nodes = manager.Num_Nodes(), old_cache_size = _component_cache.Size();
+	unsigned num_frozen = manager.Freeze_Cold_Nodes( root, running_options.eviction_ratio );
+	if ( num_frozen == 0 || manager.Is_Node_Known( root ) ) return false;
+	/* NOTE:
+	* Only the cache entries of the nodes still reachable from root are kept.
+	* Several versions of a node can share one entry, so an entry whose result was cut off points to the newest reachable version.
+	*/
+	unsigned root_loc = _comp_stack[0].caching_loc;
+	vector<NodeID> roots( 1, root );
+	roots.push_back( _component_cache.Read_Result( root_loc ) );
+	vector<bool> reachable;
+	manager.Mark_Reachable_Nodes( roots, reachable );
+	for ( unsigned i = manager.Num_Nodes(); i > 0; i-- ) {
+		NodeID n = i - 1;
+		unsigned loc = manager.Node( n ).caching_loc;
+		if ( !reachable[n] || loc == UNSIGNED_UNDEF ) continue;
+		NodeID result = _component_cache.Read_Result( loc );
+		if ( result == NodeID::undef || !reachable[result] ) _component_cache.Write_Result( loc, n );
+	}
+	vector<size_t> kept_locs;
+	for ( unsigned i = 0; i < _component_cache.Size(); i++ ) {
+		NodeID result = _component_cache.Read_Result( i );
+		if ( i == root_loc || ( result != NodeID::undef && reachable[result] ) ) kept_locs.push_back( i );
+	}
+	vector<size_t> old_locs( kept_locs );
+	vector<unsigned> new_locs( _component_cache.Size(), UNSIGNED_UNDEF );
+	_component_cache.Clear( kept_locs );
+	for ( unsigned i = 0; i < kept_locs.size(); i++ ) {
+		new_locs[old_locs[i]] = kept_locs[i];
+	}
+	for ( unsigned i = 0; i < manager.Num_Nodes(); i++ ) {
+		unsigned & loc = manager.Cache_Location( i );
+		if ( loc != UNSIGNED_UNDEF ) loc = new_locs[loc];
+	}
+	_comp_stack[0].caching_loc = new_locs[root_loc];
+	manager.Free_Unreachable_Models( reachable, _model_pool );
+	bool display = running_options.display_compiling_process;
+	running_options.display_compiling_process = false;
+	Remove_Redundant_Nodes( manager, root );
+	running_options.display_compiling_process = display;
+	if ( running_options.display_compiling_process ) {
+		cout << running_options.display_prefix << "Evict " << num_frozen << " cold nodes: DAG " << old_num_nodes << " -> " << manager.Num_Nodes();
+		cout << ", cache " << old_cache_size << " -> " << _component_cache.Size() << endl;
+	}
+	if ( running_options.profile_compiling >= Profiling_Abstract ) statistics.time_gen_dag += watch.Get_Elapsed_Seconds();
+	return true;
+}
+
 bool Partial_CCDD_Compiler::Timeout_Possibly( unsigned samples, double elapsed )
 {
     return elapsed + elapsed / samples > 0.999 * running_options.sampling_time;
@@ -2373,6 +2805,7 @@ BigFloat Partial_CCDD_Compiler::Count_Models_Lower_Bound( CNF_Formula & cnf, Heu
 	if ( running_options.display_compiling_process ) cout << running_options.display_prefix << "Counting models..." << endl;
 	if ( running_options.profile_partial_kc >= Profiling_Abstract ) begin_watch.Start();
 	Allocate_and_Init_Auxiliary_Memory( cnf.Max_Var() );
+	budget.Start();
 	assert( _num_levels == 0 && _num_dec_stack == 0 && _num_comp_stack == 0 );
 	assert( running_options.sampling_count > 0 );
 	if ( running_options.display_compiling_process ) cout << running_options.display_prefix << "Begin preprocess..." << endl;
@@ -2388,7 +2821,8 @@ BigFloat Partial_CCDD_Compiler::Count_Models_Lower_Bound( CNF_Formula & cnf, Heu
 			if ( running_options.profile_compiling >= Profiling_Abstract ) {
 				Display_Statistics( 0 );
 			}
-			cout << running_options.display_prefix << "The exact model count: " << 0 << endl;
+			if ( budget.Interrupted() ) cout << running_options.display_prefix << "The exact model count: unknown (" << Run_Status_Name( budget.Status() ) << ")" << endl;
+			else cout << running_options.display_prefix << "The exact model count: " << 0 << endl;
 		}
 		Reset();
 		return 0;
@@ -2427,7 +2861,7 @@ BigFloat Partial_CCDD_Compiler::Count_Models_Lower_Bound( CNF_Formula & cnf, Heu
 		running_options.sampling_time = ( sampling_time - elapsed_time ) / (num_rounds - round + 1.05);
 		tmp_watch.Start();
 		counts[round - 1] = Count_With_One_Round( manager, tmp_watch );
-		if ( _rsl_stack[0] < manager.Num_Nodes() && manager.Node( _rsl_stack[0] ).sym == SEARCH_KNOWN ) {
+		if ( _rsl_stack[0] < manager.Num_Nodes() && manager.Node( _rsl_stack[0] ).sym == SEARCH_KNOWN && !manager.Node( _rsl_stack[0] ).frozen ) {
 			lower_approximation = counts[round - 1];
 			break;
 		}
@@ -2435,6 +2869,7 @@ BigFloat Partial_CCDD_Compiler::Count_Models_Lower_Bound( CNF_Formula & cnf, Heu
 		if ( running_options.display_compiling_process ) {
 			cout << running_options.display_prefix << "A lower bound of count (" << confidence * 100 << "\% confidence): " << lower_approximation << endl;
 		}
+		if ( budget.Interrupted() ) break;  // the bound of the finished rounds
 		Remove_Redundant_Nodes( manager, _rsl_stack[0] );
 		manager.Reset_Frequencies();
 //		manager.Display_Partial_CCDD_With_Weights( cout, _rsl_stack[0] );  // ToRemove
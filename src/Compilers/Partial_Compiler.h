@@ -4,11 +4,74 @@
 #include "../Component_Types/Incremental_Component_Cache.h"
 #include "../Counters/KCounter.h"
 #include "../Weighted_Languages/Partial_CCDD.h"
+#include <thread>
+#include <mutex>
+#include <atomic>
 
 
 namespace KCBox {
 
 
+/* NOTE:
+ * The running estimates of independent PartialKC sampling streams.
+ * Each stream publishes its own estimate after every microcompilation,
+ * and the streams are regarded as i.i.d. replicates when combined
+*/
+class Parallel_Estimates
+{
+protected:
+	mutex _mutex;
+	vector<BigFloat> _estimates;
+	vector<unsigned> _samples;
+	atomic<bool> _stopped;
+	bool _known;  // some stream converged to the exact count
+	BigFloat _known_count;
+public:
+	Parallel_Estimates( unsigned num_streams ): _estimates( num_streams ), _samples( num_streams, 0 ), _stopped( false ), _known( false ) {}
+	unsigned Num_Streams() const { return _samples.size(); }
+	bool Stopped() const { return _stopped; }
+	void Stop() { _stopped = true; }
+	void Update( unsigned stream, const BigFloat & estimate, unsigned samples );
+	void Update_Known( const BigFloat & count );
+	unsigned Combine( BigFloat & mean, double & relative_error, double z = 1.96 );  // return the total number of samples
+};
+
+/* NOTE:
+ * The exact counts of components shared by PartialKC streams (read-mostly).
+ * A component is identified by its renamed clauses, so the table is independent of the variable
+ * numbering and the kernelization of each stream. An entry is immutable after it is published by
+ * CAS into an empty slot; the lookups take no lock. Only exact counts are shared so that the
+ * estimates of the streams remain independent
+*/
+class Shared_Known_Counts
+{
+protected:
+	struct Entry
+	{
+		uint64_t key;
+		vector<unsigned> code;
+		BigInt count;
+		atomic<unsigned> hits;
+		Entry( uint64_t k, vector<unsigned> & c, const BigInt & n ): key( k ), count( n ), hits( 0 ) { code.swap( c ); }
+	};
+	atomic<Entry *> * _slots;
+	size_t _mask;  // the number of slots minus one
+	atomic<size_t> _num_entries;
+	atomic<size_t> _memory;
+	size_t _max_memory;
+	atomic<size_t> _num_hits;
+	static const unsigned _max_probes = 32;
+public:
+	Shared_Known_Counts( size_t max_memory );
+	~Shared_Known_Counts();
+	static uint64_t Encode( CNF_Formula & cnf, vector<unsigned> & code );  // return the hash key of code
+	bool Find( const vector<unsigned> & code, uint64_t key, BigInt & count );
+	void Insert( vector<unsigned> & code, uint64_t key, const BigInt & count );  // code is swapped into the table when inserted
+	size_t Size() const { return _num_entries; }
+	size_t Num_Hits() const { return _num_hits; }
+};
+
+
 class Partial_CCDD_Compiler: public Extensive_Inprocessor
 {
 protected:
@@ -27,11 +90,18 @@ protected:
 	Random_Generator _rand_gen;
 	KCounter _exact_counter;
 	bool * _level_ExactMC_failed;
+	Parallel_Estimates * _parallel_estimates;  // shared by the streams of Count_Models_Approximately_In_Parallel
+	Shared_Known_Counts * _shared_known_counts;  // shared by the streams of Count_Models_Approximately_In_Parallel
+	unsigned _stream_id;
+	Checkpoint_Writer _checkpoint_writer;
+	uint64_t _checkpoint_fingerprint;
+	Statistics_Snapshots _stats_snapshots;
 public:
 	Partial_CCDD_Compiler();
 	~Partial_CCDD_Compiler();
 	void Reset();
 	size_t Memory();
+	void Write_Statistics_JSON( JSON_Writer & writer );  // the statistics together with the cache metrics
 protected:
 	void Allocate_and_Init_Auxiliary_Memory( Variable max_var );
 	void Free_Auxiliary_Memory();
@@ -108,6 +178,7 @@ protected:
 	void Display_Result_Stack( ostream & out );
 public:
 	BigFloat Count_Models_Approximately( CNF_Formula & cnf, Heuristic heur );
+	BigFloat Count_Models_Approximately_In_Parallel( CNF_Formula & cnf, Heuristic heur );  // running_options.sampling_num_threads streams
 protected:
 	void Choose_Counting_Options( Heuristic heur );
 	BigFloat Count_With_One_Round( Partial_CCDD_Manager & manager, StopWatch & begin_watch );
@@ -118,7 +189,12 @@ protected:
 	bool Iterate_Trivial_Possibly( Partial_CCDD_Manager & manager );
 	bool Is_Memory_Tight( Partial_CCDD_Manager & manager, unsigned old_cache_size );
 	void Remove_Redundant_Nodes( Partial_CCDD_Manager & manager, NodeID & root );
+	bool Evict_Cold_Nodes( Partial_CCDD_Manager & manager, NodeID & root );  // return false if nothing is left to sample after eviction
 	bool Timeout_Possibly( unsigned samples, double elapsed );
+	void Publish_Estimate( Partial_CCDD_Manager & manager, const BigFloat & estimate, unsigned samples, StopWatch & begin_watch );
+	void Open_Checkpoint( Partial_CCDD_Manager & manager, BigFloat & pre_result, BigFloat & current_result, unsigned & previous_sample, unsigned & current_sample, unsigned & interval, double & elapsed );  // restore the sampling state first when resuming
+	void Write_Checkpoint( Partial_CCDD_Manager & manager, const BigFloat & pre_result, unsigned previous_sample, unsigned num_samples, unsigned interval, double elapsed );
+	bool Load_Checkpoint( Partial_CCDD_Manager & manager, BigFloat & pre_result, unsigned & previous_sample, unsigned & num_samples, unsigned & interval, double & elapsed );
 public:
 	BigFloat Count_Models_Lower_Bound( CNF_Formula & cnf, Heuristic heur, float confidence );
 protected:
@@ -218,10 +294,19 @@ public:
 		compiler.running_options.trivial_variable_bound = 512;
 		compiler.running_options.display_kernelizing_process = false;
 		compiler.running_options.max_memory = parameters.memo;
+		compiler.running_options.stats_json_file = parameters.stats_json;
+		compiler.running_options.stats_interval = parameters.stats_interval;
+		compiler.Set_Budget( parameters );
 		compiler.running_options.removing_redundant_nodes_trigger *= parameters.memo / 16;
 		compiler.running_options.sampling_time = parameters.time;
 		compiler.running_options.sampling_count = parameters.micro;
+		compiler.running_options.sampling_num_threads = parameters.threads;
 		compiler._rand_gen.Reset( parameters.seed );
+		if ( parameters.checkpoint.Exists() ) {
+			compiler.running_options.checkpoint_file = parameters.checkpoint;
+			compiler.running_options.checkpoint_interval = parameters.checkpoint_interval;
+			compiler.running_options.resume_from_checkpoint = parameters.resume;
+		}
 		Heuristic heur = Parse_Heuristic( parameters.heur );
 		if ( heur != AutomaticalHeur && heur != minfill && heur != LinearLRW && heur != DLCP && heur != dynamic_minfill ) {
 			cerr << "ERROR: the heuristic is not supported yet!" << endl;
@@ -239,8 +324,15 @@ public:
 			cout << compiler.running_options.display_prefix << "Number of models: " << cnf.Known_Count() << endl;
 			return;
 		}
-		if ( !parameters.lower ) compiler.Count_Models_Approximately( cnf, heur );
+		if ( !parameters.lower ) {
+			if ( compiler.running_options.sampling_num_threads != 1 ) compiler.Count_Models_Approximately_In_Parallel( cnf, heur );
+			else compiler.Count_Models_Approximately( cnf, heur );
+		}
 		else compiler.Count_Models_Lower_Bound( cnf, heur, parameters.confidence );
+		if ( compiler.budget.Interrupted() ) {  // the estimate of the finished samples, if any, is already shown
+			cout << compiler.running_options.display_prefix << "Sampling stopped (" << Run_Status_Name( compiler.budget.Status() ) << ")" << endl;
+		}
+		if ( parameters.stats_json.Exists() ) Write_Statistics_File( compiler, parameters.stats_json );
 	}
 };
 
@@ -52,6 +52,8 @@ CDDiagram R2D2_Compiler::Compile( R2D2_Manager & manager, CNF_Formula & cnf, Heu
 	if ( running_options.display_compiling_process ) cout << running_options.display_prefix << "Compiling..." << endl;
 	Allocate_and_Init_Auxiliary_Memory( cnf.Max_Var() );
 	if ( running_options.profile_compiling >= Profiling_Abstract ) begin_watch.Start();
+	_stats_snapshots.Open( running_options.stats_json_file, running_options.stats_interval );
+	budget.Start();
 	assert( _num_levels == 0 && _num_dec_stack == 0 && _num_comp_stack == 0 );
 	if ( running_options.display_compiling_process ) cout << running_options.display_prefix << "Begin preprocess..." << endl;
 	bool cnf_sat = Preprocess( cnf, _models_stack[0] );
@@ -100,11 +102,14 @@ CDDiagram R2D2_Compiler::Compile( R2D2_Manager & manager, CNF_Formula & cnf, Heu
 	else {
 		Compile_With_SAT_Imp_Computing( manager );
 	}
-	_num_rsl_stack--;
-//	ofstream fout( "debug.cdd" );  // ToRemove
-//	manager.Display_Stat( fout );  // ToRemove
-//	fout.close();
-	NodeID result = Make_Root_Node( manager, _rsl_stack[0] );
+	NodeID result = NodeID::bot;  /// NOTE: interrupted by the budget, which the caller needs to check
+	if ( _num_rsl_stack == 1 ) {
+		_num_rsl_stack--;
+//		ofstream fout( "debug.cdd" );  // ToRemove
+//		manager.Display_Stat( fout );  // ToRemove
+//		fout.close();
+		result = Make_Root_Node( manager, _rsl_stack[0] );
+	}
 	Set_Current_Level_Kernelized( false );
 	_call_stack[0].Clear_Lit_Equivalences();
 	Backtrack();
@@ -119,7 +124,7 @@ CDDiagram R2D2_Compiler::Compile( R2D2_Manager & manager, CNF_Formula & cnf, Heu
 		}
 	}
 	Reset();
-	if ( debug_options.verify_compilation ) {
+	if ( debug_options.verify_compilation && !budget.Interrupted() ) {
 //		manager.Display_Stat( cout );  // ToRemove
 		manager.Verify_R2D2( result );
 		manager.Verify_Entail_CNF( result, cnf );
@@ -248,6 +253,7 @@ void R2D2_Compiler::Compile_With_Implicite_BCP( R2D2_Manager & manager )
 	//		system( "pause" );
 //			Display_Comp_And_Decision_Stacks( cerr );  // ToRemove
 		}
+		if ( budget.Active() && budget.Exhausted() ) break;
 		if ( Num_Components_On_Current_Level() <= 1 ) { // decision or preparation
 			switch ( _state_stack[_num_levels - 1] ) {
 			case 0:
@@ -377,7 +383,8 @@ void R2D2_Compiler::Compile_With_Implicite_BCP( R2D2_Manager & manager )
 			}
 		}
 	}
-	assert( _num_levels == 1 && _num_rsl_stack == 1 );
+	if ( _num_levels != 1 ) Terminate_Compiling();
+	assert( _num_rsl_stack == 1 || budget.Interrupted() );
 }
 
 NodeID R2D2_Compiler::Make_Node_With_Imp( R2D2_Manager & manager, NodeID node  )
@@ -408,6 +415,7 @@ NodeID R2D2_Compiler::Make_Decision_Node( R2D2_Manager & manager, NodeID low, No
 	}
 	if ( high != NodeID::bot ) _component_cache.Write_Result( Current_Component().caching_loc, result );
 	if ( Cache_Clear_Applicable( manager ) ) Component_Cache_Clear();
+	if ( _stats_snapshots.Due() ) _stats_snapshots.Write( *this );
 	if ( manager.Num_Nodes() >= _node_redundancy_factor * running_options.removing_redundant_nodes_trigger ) {
 		if ( high == NodeID::bot ) _rsl_stack[_num_rsl_stack++] = result;
 		unsigned old_size = manager.Num_Nodes();
@@ -456,6 +464,7 @@ void R2D2_Compiler::Compile_With_SAT_Imp_Computing( R2D2_Manager & manager )
 	//		system( "pause" );
 			Display_Comp_And_Decision_Stacks( cerr );  // ToRemove
 		}
+		if ( budget.Active() && budget.Exhausted() ) break;
 		if ( Num_Components_On_Current_Level() <= 1 ) { // decision or preparation
 			switch ( _state_stack[_num_levels - 1] ) {
 			case 0:
@@ -559,7 +568,8 @@ void R2D2_Compiler::Compile_With_SAT_Imp_Computing( R2D2_Manager & manager )
 			}
 		}
 	}
-	assert( _num_levels == 1 && _num_rsl_stack == 1 );
+	if ( _num_levels != 1 ) Terminate_Compiling();
+	assert( _num_rsl_stack == 1 || budget.Interrupted() );
 }
 
 bool R2D2_Compiler::Try_Shift_To_Implicite_BCP( R2D2_Manager & manager )
@@ -673,8 +683,11 @@ CDDiagram R2D2_Compiler::Compile_FixedLinearOrder( R2D2_Manager & manager, Prepr
 	else {
 		Compile_With_SAT_Imp_Computing( manager );
 	}
-	_num_rsl_stack--;
-	NodeID result = Make_Root_Node( manager, _rsl_stack[0] );
+	NodeID result = NodeID::bot;  // interrupted by the budget copied from preprocessor
+	if ( _num_rsl_stack == 1 ) {
+		_num_rsl_stack--;
+		result = Make_Root_Node( manager, _rsl_stack[0] );
+	}
 	Set_Current_Level_Kernelized( false );
 	_call_stack[0].Clear_Lit_Equivalences();
 	Backtrack();
@@ -96,6 +96,9 @@ public:
 		compiler.running_options.display_kernelizing_process = false;
 		compiler.running_options.cache_encoding = Parse_Cache_Encoding_Strategy( parameters.cache_enc );
 		compiler.running_options.max_memory = parameters.memo;
+		compiler.running_options.stats_json_file = parameters.stats_json;
+		compiler.running_options.stats_interval = parameters.stats_interval;
+		compiler.Set_Budget( parameters );
 		compiler.running_options.removing_redundant_nodes_trigger *= parameters.memo / 4;
 		Heuristic heur = Parse_Heuristic( parameters.heur );
 		if ( Is_Linear_Ordering( heur ) == lbool(false) ) {
@@ -112,6 +115,11 @@ public:
 		}
 		R2D2_Manager manager( cnf.Max_Var() );
 		CDDiagram r2d2 = compiler.Compile( manager, cnf, heur );
+		if ( parameters.stats_json.Exists() ) Write_Statistics_File( compiler, parameters.stats_json );
+		if ( compiler.budget.Interrupted() ) {
+			cout << compiler.running_options.display_prefix << "Compilation stopped (" << Run_Status_Name( compiler.budget.Status() ) << "), and the queries are skipped" << endl;
+			return;
+		}
 		if ( parameters.CT || parameters.US.Exists() ) {
 			compiler._component_cache.Shrink_To_Fit();
 			manager.Remove_Redundant_Nodes();
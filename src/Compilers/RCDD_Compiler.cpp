@@ -47,6 +47,7 @@ CDDiagram RCDD_Compiler::Compile( RCDD_Manager & manager, CNF_Formula & cnf, Heu
 	if ( running_options.display_compiling_process ) cout << running_options.display_prefix << "Compiling..." << endl;
 	Allocate_and_Init_Auxiliary_Memory( cnf.Max_Var() );
 	if ( running_options.profile_compiling >= Profiling_Abstract ) begin_watch.Start();
+	_stats_snapshots.Open( running_options.stats_json_file, running_options.stats_interval );
 	assert( _num_levels == 0 && _num_dec_stack == 0 && _num_comp_stack == 0 );
 	if ( running_options.display_compiling_process ) cout << running_options.display_prefix << "Begin preprocess..." << endl;
 	bool cnf_sat = Preprocess( cnf, _models_stack[0] );
@@ -406,6 +407,7 @@ NodeID RCDD_Compiler::Make_Decision_Node( RCDD_Manager & manager, NodeID low, No
 	if ( _component_cache.Memory() > running_options.max_memory / 4 * GB ) {
 		Component_Cache_Clear();
 	}
+	if ( _stats_snapshots.Due() ) _stats_snapshots.Write( *this );
 	if ( manager.Num_Nodes() >= running_options.removing_redundant_nodes_trigger ) {
 		if ( high == NodeID::bot ) _rsl_stack[_num_rsl_stack++] = result;
 		Remove_Redundant_Nodes( manager );
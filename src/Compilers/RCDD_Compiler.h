@@ -107,6 +107,8 @@ public:
 		compiler.running_options.trivial_variable_bound = 128;
 		compiler.running_options.display_kernelizing_process = false;
 		compiler.running_options.max_memory = parameters.memo;
+		compiler.running_options.stats_json_file = parameters.stats_json;
+		compiler.running_options.stats_interval = parameters.stats_interval;
 		compiler.running_options.removing_redundant_nodes_trigger *= parameters.memo / 4;
 		ifstream fin( infile );
 		CNF_Formula cnf( fin );
@@ -118,6 +120,7 @@ public:
 		}
 		RCDD_Manager manager( cnf.Max_Var() );
 		CDDiagram rcdd = compiler.Compile( manager, cnf, AutomaticalHeur );
+		if ( parameters.stats_json.Exists() ) Write_Statistics_File( compiler, parameters.stats_json );
 		if ( parameters.CT ) {
 			BigInt count = manager.Count_Models( rcdd );
 			cout << compiler.running_options.display_prefix << "Number of models: " << count << endl;
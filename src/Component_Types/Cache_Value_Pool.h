@@ -0,0 +1,96 @@
+#ifndef _Cache_Value_Pool_h_
+#define _Cache_Value_Pool_h_
+
+#include "../Template_Library/Basic_Structures.h"
+#include "../Template_Library/BigNum.h"
+#include "../Template_Library/Time_Memory.h"
+
+
+namespace KCBox {
+
+
+template <typename T> class Cache_Value_Pool  // by default, the results are stored in the cache entries themselves
+{
+public:
+	typedef T stored_type;
+	enum { interning = false };
+	stored_type Intern( const T & value ) { return value; }
+	T Value( const stored_type & stored ) const { return stored; }
+	void Collect_Garbage( vector<stored_type *> & live ) { UNUSED( live ); }
+	void Clear() {}
+	size_t Size() const { return 0; }
+	size_t Memory() const { return 0; }
+};
+
+struct Compact_Count  // mantissa * 2^exp, where the odd mantissa is interned in Cache_Value_Pool<BigInt>
+{
+	unsigned id;
+	unsigned exp;
+	Compact_Count() {}
+	Compact_Count( unsigned mantissa_id, unsigned exponent ): id( mantissa_id ), exp( exponent ) {}
+	bool operator == ( const Compact_Count & other ) const { return id == other.id && exp == other.exp; }
+	bool operator != ( const Compact_Count & other ) const { return id != other.id || exp != other.exp; }
+	bool operator < ( const Compact_Count & other ) const { return id < other.id || ( id == other.id && exp < other.exp ); }
+	bool operator > ( const Compact_Count & other ) const { return other < *this; }
+};
+
+template <> class Cache_Value_Pool<BigInt>
+{
+	/* NOTE:
+	* Model counts are often a small odd factor times a big power of two, and many components share the
+	* same count. So an entry keeps only the exponent of two and the 32-bit ID of its odd mantissa, which
+	* is hash-consed here. The mantissas no longer referenced are dropped by Collect_Garbage when the
+	* cache is cleared, and the IDs are renumbered then
+	*/
+protected:
+	Hash_Table<BigInt> _mantissas;
+	Memory_Account<Memory_Cache> _memory;  // the limbs of the mantissas are in Memory_Limbs
+public:
+	typedef Compact_Count stored_type;
+	enum { interning = true };
+	Cache_Value_Pool(): _memory( 0 ) {}
+	stored_type Intern( const BigInt & value )
+	{
+		BigInt mantissa = value;
+		unsigned exp = mantissa.Trailing_Zeros();
+		mantissa.Div_2exp( exp );
+		size_t old_size = _mantissas.Size();
+		size_t id = _mantissas.Hit( mantissa );
+		if ( id == old_size ) _memory += sizeof(BigInt) + sizeof(size_t);
+		if ( id >= UNSIGNED_UNDEF ) {
+			cerr << "ERROR[Cache_Value_Pool]: too many distinct results!" << endl;
+			exit( 1 );
+		}
+		return Compact_Count( id, exp );
+	}
+	BigInt Value( const stored_type & stored )
+	{
+		BigInt value = _mantissas[stored.id];
+		value.Mul_2exp( stored.exp );
+		return value;
+	}
+	void Collect_Garbage( vector<stored_type *> & live )  // renumber the mantissas referenced by live
+	{
+		Hash_Table<BigInt> old_mantissas;
+		old_mantissas.Swap( _mantissas );
+		_memory = 0;
+		for ( stored_type * stored: live ) {
+			size_t old_size = _mantissas.Size();
+			stored->id = _mantissas.Hit( old_mantissas[stored->id] );
+			if ( stored->id == old_size ) _memory += sizeof(BigInt) + sizeof(size_t);
+		}
+	}
+	void Clear()
+	{
+		_mantissas.Clear();
+		_memory = 0;
+	}
+	size_t Size() const { return _mantissas.Size(); }
+	size_t Memory() const { return _memory; }
+};
+
+
+}
+
+
+#endif
@@ -4,7 +4,7 @@
 namespace KCBox {
 
 
-Cacheable_Clause_Infor Cacheable_Clause::_infor;
+thread_local Cacheable_Clause_Infor Cacheable_Clause::_infor;
 
 
 }
@@ -22,7 +22,7 @@ class Cacheable_Clause
 {
 	friend class Clause_Cache;
 protected:
-	static Cacheable_Clause_Infor _infor;   /// NOTE: for different Component_Cache, _infor is different, so please adjust it before use
+	static thread_local Cacheable_Clause_Infor _infor;   /// NOTE: for different Component_Cache, _infor is different, so please adjust it before use; thread_local for the caches of concurrent engines
 	unsigned * _bits;
 public:
 	Cacheable_Clause(): _bits( nullptr ) {}
@@ -115,7 +115,7 @@ public:
 		unsigned size = Size();
 		ASSERT( size >= 2 );
 		clause.Resize( size );
-		for ( i = 0, begin = _infor._lit_code_size; i < size; i++, begin += _infor._lit_code_mask ) {
+		for ( i = 0, begin = _infor._lit_code_size; i < size; i++, begin += _infor._lit_code_size ) {
 			unsigned lit = ( _bits[begin / UNSIGNED_SIZE] >> ( begin % UNSIGNED_SIZE ) ) & _infor._lit_code_mask;
 			if ( _infor._lit_code_size > UNSIGNED_SIZE - begin % UNSIGNED_SIZE )
 				lit |= ( _bits[begin / UNSIGNED_SIZE + 1] << ( UNSIGNED_SIZE - begin % UNSIGNED_SIZE ) ) & _infor._lit_code_mask; // NOTE: a == ( a >> UNSIGNED_SIZE )
@@ -171,7 +171,7 @@ protected:
 	Cacheable_Clause_Infor _hit_infor;
 	Hash_Table<Cacheable_Clause> _pool;
 	Cacheable_Clause _big_cacheable_clause;
-	size_t _hash_memory;  // used to record the number of used bytes for storing components
+	Memory_Account<Memory_Cache> _hash_memory;  // used to record the number of used bytes for storing components
 public:
 	Clause_Cache(): _max_var( Variable::undef ), _pool( CLAUSE_CACHE_INIT_SIZE )
 	{
@@ -279,7 +279,11 @@ public:
 		return pos;
 	}
 	bool Hit_Successful() { return _pool.Hit_Successful(); }
-	void Read_Clause( unsigned loc, Big_Clause & clause ) { _pool[loc].Read_Clause( clause ); }
+	void Read_Clause( unsigned loc, Big_Clause & clause )
+	{
+		Cacheable_Clause::_infor = _hit_infor;  /// NOTE: for different Clause_Cache, Cacheable_Clause::_infor is different
+		_pool[loc].Read_Clause( clause );
+	}
 	void Erase( unsigned loc )
 	{
 		_hash_memory -= _pool[loc].Memory() - sizeof(Cacheable_Clause);
@@ -3,6 +3,7 @@
 
 #include "../Parameters.h"
 #include "Component.h"
+#include "Cache_Value_Pool.h"
 #ifdef ACTIVATE_CLHASH
 #include "../clhash/clhash.h"
 #endif
@@ -18,6 +19,7 @@ struct Cacheable_Component_Infor
 	unsigned _vcode_mask;  // used to recover
 	unsigned _ccode_mask;  // used to recover
 	Cache_Encoding_Strategy _encoding = Simple_Cache_Encoding;
+	unsigned _generation = 0;  // the number of extensions of ccode, whose parity is marked in the entries encoded by this
 	void Init( unsigned max_var, unsigned num_long_clauses )
 	{
 		_vcode_size = Ceil_Log2( max_var - Variable::start + 1 );
@@ -30,12 +32,13 @@ struct Cacheable_Component_Infor
 	{
 		_ccode_size += inc;
 		_ccode_mask = UNSIGNED_UNDEF >> ( UNSIGNED_SIZE - _ccode_size );
+		_generation++;
 	}
 	unsigned Max_Num_Clauses() { return 1 << _ccode_size; }
 };
 
 template <typename T> size_t Extra_Memory( const T & data, typename T::int_type ) { return data.Memory() - sizeof(T); }
-template <typename T> size_t Extra_Memory( const T & data, T ) { UNUSED(data);  return 0; }
+template <typename T> size_t Extra_Memory( const T & data, ... ) { UNUSED(data);  return 0; }  // for the types without int_type
 
 template <typename T> class Component_Cache;
 template <typename T> class Incremental_Component_Cache;
@@ -47,7 +50,7 @@ template <typename T> class Cacheable_Component
 	friend class Incremental_Component_Cache<T>;
 	friend class Incremental_Component_Cache_Compressed_Clauses<T>;
 protected:
-	static Cacheable_Component_Infor _infor;   /// NOTE: for different Component_Cache, _infor is different, so please adjust it before use
+	static thread_local Cacheable_Component_Infor _infor;   /// NOTE: for different Component_Cache, _infor is different, so please adjust it before use; thread_local for the caches of concurrent engines
 #ifdef ACTIVATE_CLHASH
 	static clhasher hasher;
 #endif
@@ -55,10 +58,10 @@ protected:
 	unsigned _num_cl;
 	unsigned * _bits;  // NOTE: when a type uses memory beyond the ones sizeof counts, please declare a sub-type int_type, and defines a function Memory
 	uint64_t _key;
-	T _result;
+	typename Cache_Value_Pool<T>::stored_type _result;  // NOTE: the value of _result is decoded by the Cache_Value_Pool of the cache
 public:
-	Cacheable_Component(): _num_var( 0 ) {}
-	Cacheable_Component( unsigned num_var, unsigned num_cl ): _num_var( num_var ), _num_cl( num_cl )
+	Cacheable_Component(): _num_var( 0 ), _hits( 0 ), _generation( 0 ) {}
+	Cacheable_Component( unsigned num_var, unsigned num_cl ): _num_var( num_var ), _num_cl( num_cl ), _hits( 0 ), _generation( 0 )
 	{
 		unsigned i, size = Bits_Max_Size();
 		_bits = new unsigned [size];
@@ -74,6 +77,9 @@ public:
 		_parent = other._parent;
 		_first_child = other._first_child;
 		_next_sibling = other._next_sibling;
+		_hits = other._hits;
+		_priority = other._priority;
+		_generation = other._generation;
 	}
 	void Init( unsigned num_var, unsigned num_cl )
 	{
@@ -110,6 +116,7 @@ public:
 		ASSERT( _infor._vcode_size < UNSIGNED_SIZE );
 		ASSERT( _num_var > 0 );
 		ASSERT( comp.Vars_Size() >= 2 );
+		_generation = _infor._generation & 1;
 		switch ( _infor._encoding ) {
 		case Simple_Cache_Encoding:
 			Assign_Simple( comp );
@@ -305,11 +312,15 @@ public:
 		_parent = other._parent;
 		_first_child = other._first_child;
 		_next_sibling = other._next_sibling;
+		_hits = other._hits;
+		_priority = other._priority;
+		_generation = other._generation;
 		return *this;
 	}
 	bool operator == ( Cacheable_Component & other )
 	{
 		if ( _num_var != other._num_var || _num_cl != other._num_cl || _key != other._key ) return false;
+		if ( _generation != other._generation ) return false;  /// the same bits mean different components under different encodings
 		if ( _bits == other._bits ) return true;  /// used for deciding if the component is equal to itself
 		unsigned i, tmp, size = Bits_Size();
 		if ( _infor._encoding == Difference_Cache_Encoding ) {
@@ -324,7 +335,7 @@ public:
 	uint64_t Key() const { return _key; }
 	size_t Memory() const
 	{
-		size_t result_extra_memo = Extra_Memory<T>( _result, 0 );
+		size_t result_extra_memo = Extra_Memory<typename Cache_Value_Pool<T>::stored_type>( _result, 0 );
 		return sizeof(Cacheable_Component) + Bits_Size() * sizeof(unsigned) + result_extra_memo;
 	}
 protected:
@@ -428,13 +439,16 @@ protected:
 	CacheEntryID _parent = CacheEntryID::undef;
 	CacheEntryID _first_child = CacheEntryID::undef;
 	CacheEntryID _next_sibling = CacheEntryID::undef;
+	unsigned _hits: 31;  // the number of lookups reaching this entry
+	unsigned _generation: 1;  // the parity of _infor._generation when encoded, see Component_Cache::Extend_ClauseID_Encode
+	float _priority = 0;  // GDSF priority: the clock at the latest access plus hits * cost / size
 };
 
 #ifdef ACTIVATE_CLHASH
 template <typename T> clhasher Cacheable_Component<T>::hasher(UINT64_C(0x23a23cf5033c3c81),UINT64_C(0xb3816f6a2c68e530));
 #endif
 
-template <typename T> Cacheable_Component_Infor Cacheable_Component<T>::_infor;
+template <typename T> thread_local Cacheable_Component_Infor Cacheable_Component<T>::_infor;
 
 
 }
@@ -2,6 +2,8 @@
 #define _Component_Cache_h_
 
 #include "Cacheable_Component.h"
+#include "../Template_Library/Checkpoint.h"
+#include "../Template_Library/Statistics_Writer.h"
 
 
 namespace KCBox {
@@ -12,6 +14,8 @@ namespace KCBox {
 #else
 #define COMPONENT_CACHE_INIT_SIZE LARGE_HASH_TABLE
 #endif
+#define COMPONENT_CACHE_MIN_SIZE SMALL_HASH_TABLE
+#define COMPONENT_CACHE_REENCODING 4  // the entries visited by each hit to encode the stale ones again
 
 template <typename T> class Component_Cache
 {
@@ -20,21 +24,38 @@ protected:
 	unsigned _num_long_cl;  // the total number of long clauses
 	Cacheable_Component_Infor _hit_infor;
 	T _default_caching_value;  // for IBCP, we could leave one component without getting result, thus use this notation
+	Cache_Value_Pool<T> _values;
+	typename Cache_Value_Pool<T>::stored_type _default_stored;  // _default_caching_value in _values
 //	Hash_Table<Cacheable_Component<T>> _pool;
 	Large_Hash_Table<Cacheable_Component<T>> _pool;
 	Cacheable_Component<T> _big_cacheable_component;
-	size_t _hash_memory;  // used to record the number of used bytes for storing components
+	Cacheable_Component_Infor _stale_infor;  // the encoding before the latest extension of clause IDs
+	cache_size_t _num_stale;  // the entries still encoded by _stale_infor
+	cache_size_t _stale_cursor;  // the entries before it are not stale
+	Component _reencoded_comp;
+	Memory_Account<Memory_Cache> _hash_memory;  // used to record the number of used bytes for storing components
+	float _clock;  // GDSF aging: the priority of the latest evicted entry
+	size_t _num_lookups;
+	size_t _num_hits;
+	size_t _evicted_memory;
+	unsigned _num_evictions;
+	cache_size_t _max_size;  // the high-water marks, recorded before the entries are dropped
+	size_t _max_memory;
 public:
-	Component_Cache(): _max_var( Variable::undef ), _pool( COMPONENT_CACHE_INIT_SIZE )
+	Component_Cache(): _max_var( Variable::undef ), _pool( COMPONENT_CACHE_MIN_SIZE ), _num_stale( 0 ), _stale_cursor( 0 )  // sized by Init
 	{
 		_hash_memory = _pool.Memory();
+		Reset_Counters();
 	}
 	Component_Cache( Variable max_var, unsigned num_long_clause, T default_value ) :
 		_max_var( max_var ), _num_long_cl( num_long_clause ), _default_caching_value( default_value ), \
-		_pool( COMPONENT_CACHE_INIT_SIZE ), _big_cacheable_component( NumVars( max_var ), num_long_clause )
+		_pool( COMPONENT_CACHE_INIT_SIZE ), _big_cacheable_component( NumVars( max_var ), num_long_clause ), \
+		_num_stale( 0 ), _stale_cursor( 0 )
 	{
 		_hit_infor.Init( max_var, num_long_clause );
+		_default_stored = _values.Intern( _default_caching_value );
 		_hash_memory = _pool.Memory();
+		Reset_Counters();
 	}
 	~Component_Cache()
 	{
@@ -43,17 +64,21 @@ public:
 		}
 		if ( _max_var != Variable::undef ) delete [] _big_cacheable_component._bits;
 	}
-	void Reset()
+	void Reset()  /// NOTE: the counters are kept, so they cover all runs
 	{
+		Record_Peak();
 		for ( cache_size_t i = 0; i < _pool.Size(); i++ ) {
 			delete [] _pool[i]._bits;
 		}
 		_pool.Clear();
+		_num_stale = _stale_cursor = 0;
 		_big_cacheable_component.Reset();
 		_max_var = Variable::undef;
+		_values.Clear();
 		_hash_memory = _pool.Memory();
+		_clock = 0;
 	}
-	void Init( Variable max_var, unsigned num_long_clause, T default_value )
+	void Init( Variable max_var, unsigned num_long_clause, T default_value, size_t num_entries = COMPONENT_CACHE_MIN_SIZE )  // the pool grows from num_entries
 	{
 		if ( _max_var != Variable::undef ) {
 			cerr << "ERROR[Component_Cache]: already initialized!" << endl;
@@ -64,19 +89,27 @@ public:
 		_hit_infor.Init( max_var, num_long_clause );
 		Cacheable_Component<T>::_infor = _hit_infor;
 		_default_caching_value = default_value;
+		_default_stored = _values.Intern( _default_caching_value );
 		_big_cacheable_component.Init( NumVars( max_var ), num_long_clause );
+		_pool.Reset_Entries( num_entries );  /// NOTE: a reused cache fits each instance rather than the largest one
+		_hash_memory = _pool.Memory();
 	}
 	void Set_Encoding( Cache_Encoding_Strategy encoding ) { assert( _pool.Empty() );  _hit_infor.Set_Encoding( encoding ); }
 	void Clear()
 	{
+		Record_Peak();
 		for ( cache_size_t i = 0; i < _pool.Size(); i++ ) {
 			delete [] _pool[i]._bits;
 		}
 		_pool.Clear();
+		_num_stale = _stale_cursor = 0;
+		Collect_Values();
 		_hash_memory = _pool.Memory();
 	}
 	void Clear( vector<size_t> & kept_locs )
 	{
+		Record_Peak();
+		Finish_Reencoding();
 		vector<bool> seen( _pool.Size(), false );
 		for ( cache_size_t i = 0; i < kept_locs.size(); i++ ) {
 			seen[kept_locs[i]] = true;
@@ -85,10 +118,13 @@ public:
 			if ( !seen[i] ) delete [] _pool[i]._bits;
 		}
 		_pool.Clear( kept_locs );
+		Collect_Values();
 		_hash_memory = _pool.Memory();
 	}
 	void Clear_Shrink_Half( vector<size_t> & kept_locs )
 	{
+		Record_Peak();
+		Finish_Reencoding();
 		vector<bool> seen( _pool.Size(), false );
 		for ( cache_size_t i = 0; i < kept_locs.size(); i++ ) {
 			seen[kept_locs[i]] = true;
@@ -97,10 +133,13 @@ public:
 			if ( !seen[i] ) delete [] _pool[i]._bits;
 		}
 		_pool.Clear_Shrink_Half( kept_locs );
+		Collect_Values();
 		_hash_memory = _pool.Memory();
 	}
 	void Clear_Half( vector<size_t> & kept_locs )
 	{
+		Record_Peak();
+		Finish_Reencoding();
 		vector<bool> seen( _pool.Size(), false );
 		for ( cache_size_t i = 0; i < kept_locs.size(); i++ ) {
 			seen[kept_locs[i]] = true;
@@ -112,8 +151,67 @@ public:
 		for ( cache_size_t i = 0; i < _pool.Size(); i++ ) {
 			_pool[i]._parent = _pool[i]._first_child = _pool[i]._next_sibling = CacheEntryID::undef;
 		}
+		Collect_Values();
 		_hash_memory = _pool.Memory();
 	}
+	size_t Evict( vector<size_t> & kept_locs, double kept_ratio )  // return the number of evicted bytes
+	{
+		/* NOTE:
+		* GDSF: the entries in kept_locs are pinned, and the others are evicted in the increasing order of
+		* priority until the entries take at most kept_ratio of their old memory; the capacity shrinks in the
+		* same ratio. The priority of an entry is the clock at its latest access plus hits * cost / size, where
+		* the cost of recomputing is estimated by the number of variables. The clock rises to the priority of
+		* the latest evicted entry, so the entries not accessed for a long time age out
+		*/
+		Record_Peak();
+		Finish_Reencoding();
+		vector<bool> seen( _pool.Size(), false );
+		for ( cache_size_t i = 0; i < kept_locs.size(); i++ ) {
+			seen[kept_locs[i]] = true;
+		}
+		vector<cache_size_t> candidates;
+		for ( cache_size_t i = 0; i < _pool.Size(); i++ ) {
+			if ( !seen[i] ) candidates.push_back( i );
+		}
+		sort( candidates.begin(), candidates.end(), [&]( cache_size_t a, cache_size_t b ) { return _pool[a]._priority < _pool[b]._priority; } );
+		size_t memory = 0, evicted_memory = 0;
+		for ( cache_size_t i = 0; i < _pool.Size(); i++ ) {
+			memory += _pool[i].Memory();
+		}
+		size_t target_memory = memory * kept_ratio;
+		cache_size_t num_evicted = 0;
+		for ( ; num_evicted < candidates.size() && memory > target_memory; num_evicted++ ) {
+			Cacheable_Component<T> & entry = _pool[candidates[num_evicted]];
+			memory -= entry.Memory();
+			evicted_memory += entry.Memory();
+			_clock = entry._priority;
+			seen[candidates[num_evicted]] = true;
+			delete [] entry._bits;
+		}
+		vector<size_t> locs( kept_locs );
+		for ( cache_size_t i = 0; i < _pool.Size(); i++ ) {
+			if ( !seen[i] ) locs.push_back( i );
+		}
+		_pool.Clear_Shrink( locs, max<size_t>( locs.size(), _pool.Capacity() * kept_ratio ) );
+		for ( cache_size_t i = 0; i < kept_locs.size(); i++ ) {
+			kept_locs[i] = locs[i];
+		}
+		for ( cache_size_t i = 0; i < _pool.Size(); i++ ) {
+			_pool[i]._parent = _pool[i]._first_child = _pool[i]._next_sibling = CacheEntryID::undef;
+		}
+		Collect_Values();
+		_hash_memory = _pool.Memory();
+		_evicted_memory += evicted_memory;
+		_num_evictions++;
+		return evicted_memory;
+	}
+	size_t Num_Lookups() const { return _num_lookups; }
+	size_t Num_Hits() const { return _num_hits; }
+	double Hit_Rate() const { return _num_lookups == 0 ? 0 : (double) _num_hits / _num_lookups; }
+	size_t Evicted_Memory() const { return _evicted_memory; }
+	unsigned Num_Evictions() const { return _num_evictions; }
+	cache_size_t Max_Size() const { return max<cache_size_t>( _max_size, _pool.Size() ); }
+	size_t Max_Memory() const { return max<size_t>( _max_memory, Memory() ); }
 	T Default_Caching_Value() const { return _default_caching_value; }
 	cache_size_t Size() const { return _pool.Size(); }
 	cache_size_t Capacity() const { return _pool.Capacity(); }
@@ -126,13 +224,33 @@ public:
 	}
 	void Shrink_To_Fit()
 	{
+		Finish_Reencoding();
 		_pool.Shrink_To_Fit();
 		_hash_memory = _pool.Memory();
 	}
-	size_t Memory() const { return _hash_memory; }
+	size_t Memory() const { return _hash_memory + _values.Memory(); }
+	size_t Num_Distinct_Results() const { return _values.Size(); }
+	void Write_JSON( JSON_Writer & writer ) const
+	{
+		writer.Field( "size", Size() );
+		writer.Field( "capacity", Capacity() );
+		writer.Field( "memory", Memory() );
+		writer.Field( "max_size", Max_Size() );
+		writer.Field( "max_memory", Max_Memory() );
+		writer.Field( "lookups", Num_Lookups() );
+		writer.Field( "hits", Num_Hits() );
+		writer.Field( "hit_rate", Hit_Rate() );
+		writer.Field( "evicted_memory", Evicted_Memory() );
+		writer.Field( "evictions", Num_Evictions() );
+		writer.Field( "distinct_results", Num_Distinct_Results() );
+	}
 	CacheEntryID Hit_Component( Component & comp )
 	{
 		Cacheable_Component<T>::_infor = _hit_infor;  /// NOTE: for different Component_Cache, Cacheable_Component::_infor is different, so update Cacheable_Component::_infor before Hit
+		if ( _num_stale > 0 ) {
+			Hit_Stale_Component( comp );
+			Reencode_Entries( COMPONENT_CACHE_REENCODING );
+		}
 		_big_cacheable_component.Assign( comp );  /// this calling needs to use the right _infor.vcode_size and _infor.ccode_size
 		cache_size_t old_cache_size = _pool.Size();
 		cache_size_t pos = _pool.Hit( _big_cacheable_component, _hash_memory );
@@ -145,17 +263,25 @@ public:
 			_pool[pos]._bits = new unsigned [size];
 			_pool[pos]._bits[0] = _big_cacheable_component._bits[0];  // has at least one 4-bytes
 			for ( unsigned i = 1; i < size; i++ ) _pool[pos]._bits[i] = _big_cacheable_component._bits[i];
-			Write_Result( pos, _default_caching_value );  // the size of _big_cacheable_component._result may be different from that of _pool[pos]._result
+			Write_Stored_Result( pos, _default_stored );  // the size of _big_cacheable_component._result may be different from that of _pool[pos]._result
+			_pool[pos]._hits = 0;
 		}
+		else _num_hits++;
+		_num_lookups++;
+		Cacheable_Component<T> & entry = _pool[pos];
+		entry._hits++;
+		entry._priority = _clock + (float) entry._hits * entry._num_var / entry.Memory();
 		_big_cacheable_component.Un_Assign();
 		comp.caching_loc = pos;
 		return pos;
 	}
 	bool Hit_Successful() { return _pool.Hit_Successful(); }
-	void Read_Component( CacheEntryID loc, Component & comp ) { comp.caching_loc = loc;  _pool[loc].Read_Component( comp ); }
-	void Read_Component_Vars( CacheEntryID loc, Component & comp ) { comp.caching_loc = loc;  _pool[loc].Read_Rough_Component( comp ); }
+	void Read_Component( CacheEntryID loc, Component & comp ) { comp.caching_loc = loc;  Reencode_Entry( loc );  _pool[loc].Read_Component( comp ); }
+	void Read_Component_Vars( CacheEntryID loc, Component & comp ) { comp.caching_loc = loc;  _pool[loc].Read_Rough_Component( comp ); }  // the variables are encoded in the same way in a stale entry
 	void Erase( CacheEntryID loc )
 	{
+		Reencode_Entry( loc );
+		Reencode_Entry( _pool.Size() - 1 );  // keep the entries before _stale_cursor not stale
 		if ( loc == _pool.Size() - 1 ) {
 			_hash_memory -= _pool[loc].Memory();
 			delete [] _pool[loc]._bits;
@@ -171,19 +297,14 @@ public:
 			_hash_memory += sizeof(Cacheable_Component<T>);
 		}
 	}
-	T Read_Result( CacheEntryID pos ) { return _pool[pos]._result; }
-	void Write_Result( CacheEntryID pos, const T result )
-	{
-		_hash_memory -= _pool[pos].Memory();
-		_pool[pos]._result = result;
-		_hash_memory += _pool[pos].Memory();  /// result's memory might not be equal to that of pool[loc]._result
-	}
+	T Read_Result( CacheEntryID pos ) { return _values.Value( _pool[pos]._result ); }
+	void Write_Result( CacheEntryID pos, const T result ) { Write_Stored_Result( pos, _values.Intern( result ) ); }
 	double Duplicate_Rate()
 	{
 		vector<T> elems;
 		for ( cache_size_t i = 0; i < _pool.Size(); i++ ) {
-			if ( _pool[i]._result != _default_caching_value ) {
-				elems.push_back( _pool[i]._result );
+			if ( _pool[i]._result != _default_stored ) {
+				elems.push_back( Read_Result( i ) );
 			}
 		}
 		Quick_Sort( elems );
@@ -197,7 +318,7 @@ public:
 	{
 		cache_size_t num = 0;
 		for ( cache_size_t i = 0; i < _pool.Size(); i++ ) {
-			num += ( _pool[i]._result == _default_caching_value );
+			num += ( _pool[i]._result == _default_stored );
 		}
 		return 1.0 * num / _pool.Size();
 	}
@@ -210,25 +331,91 @@ public:
 		}
 	}
 protected:
-	void Extend_ClauseID_Encode()
+	void Write_Entry( ostream & out, CacheEntryID loc )  // binary, used by checkpoints
 	{
 		Component comp;
-		Cacheable_Component_Infor old_infor = _hit_infor;
+		Reencode_Entry( loc );
+		Cacheable_Component<T>::_infor = _hit_infor;
+		_pool[loc].Read_Component( comp );
+		Write_Binary( out, comp.VarIDs() );
+		Write_Binary( out, comp.ClauseIDs_Size() );
+		for ( unsigned i = 0; i < comp.ClauseIDs_Size(); i++ ) {
+			Write_Binary( out, comp.ClauseIDs( i ) );
+		}
+		Write_Binary( out, Read_Result( loc ) );
+	}
+	bool Read_Entry( istream & in, Component & comp, T & result )
+	{
+		vector<unsigned> ids;
+		comp.Clear();
+		if ( !Read_Binary( in, ids ) ) return false;
+		for ( unsigned id: ids ) {
+			comp.Add_Var( Variable( id ) );
+		}
+		if ( !Read_Binary( in, ids ) ) return false;
+		for ( unsigned id: ids ) {
+			comp.Add_ClauseID( id );
+		}
+		return Read_Binary( in, result );
+	}
+	void Extend_ClauseID_Encode()
+	{
+		/* NOTE:
+		* Encoding all entries again at once pauses the search when the cache is huge. Instead, the entries become
+		* stale, which is marked by the parity of the generation of encoding, and each hit encodes a few of them
+		* again. A stale entry is also encoded again when it is accessed, including when a hit finds it under the
+		* old encoding. The stale entries of the previous extension are encoded again first, if any
+		*/
+		Finish_Reencoding();
+		_stale_infor = _hit_infor;
 		_hit_infor.Extend_CCode( 1 );
 		Cacheable_Component<T>::_infor = _hit_infor;  /// update Cacheable_Component::_infor before Update
 		_big_cacheable_component.Update_Bits( NumVars( _max_var ), _num_long_cl );
-		for ( cache_size_t i = 0; i < _pool.Size(); i++ ) {
-			Cacheable_Component<T>::_infor = old_infor;  /// update Cacheable_Component::_infor before Hit
-			_pool[i].Read_Component( comp );  /// this calling needs to use the right _infor.vcode_size and _infor.ccode_size
-			delete [] _pool[i]._bits;
-			unsigned new_size = _pool[i].New_Bits_Size( _hit_infor );
-			_pool[i]._bits = new unsigned [new_size];
-			for ( unsigned j = 1; j < new_size; j++ ) _pool[i]._bits[j] = 0;
-			Cacheable_Component<T>::_infor = _hit_infor;  /// update Cacheable_Component::_infor before Hit
-			_pool[i].Assign( comp );  /// this calling needs to use the right _infor.vcode_size and _infor.ccode_size
+		_num_stale = _pool.Size();
+		_stale_cursor = 0;
+	}
+	void Hit_Stale_Component( Component & comp )  // encode the stale entry of comp again if it exists
+	{
+		for ( unsigned i = 0; i < comp.ClauseIDs_Size(); i++ ) {
+			if ( comp.ClauseIDs( i ) >= _stale_infor.Max_Num_Clauses() ) return;  // cannot be encoded by _stale_infor
 		}
-		_pool.Recompute_Entries();
-		_hash_memory = _pool.Memory();
+		Cacheable_Component<T>::_infor = _stale_infor;
+		_big_cacheable_component.Assign( comp );
+		size_t loc = _pool.Location( _big_cacheable_component );
+		_big_cacheable_component.Un_Assign();
+		Cacheable_Component<T>::_infor = _hit_infor;
+		if ( loc != SIZET_UNDEF ) Reencode_Entry( loc );
+	}
+	void Reencode_Entry( CacheEntryID loc )
+	{
+		Cacheable_Component<T> & entry = _pool[loc];
+		if ( entry._generation == ( _hit_infor._generation & 1 ) ) return;
+		Cacheable_Component<T>::_infor = _stale_infor;  /// reading needs the right _infor.vcode_size and _infor.ccode_size
+		_hash_memory -= entry.Memory();
+		entry.Read_Component( _reencoded_comp );
+		uint64_t old_key = entry.Key();
+		unsigned new_size = entry.New_Bits_Size( _hit_infor );
+		delete [] entry._bits;
+		entry._bits = new unsigned [new_size];
+		for ( unsigned j = 1; j < new_size; j++ ) entry._bits[j] = 0;
+		Cacheable_Component<T>::_infor = _hit_infor;
+		entry.Assign( _reencoded_comp );
+		_hash_memory += entry.Memory();
+		_pool.Rekey( loc, old_key, _hash_memory );
+		_num_stale--;
+	}
+	void Reencode_Entries( cache_size_t num_visited )
+	{
+		for ( ; num_visited > 0 && _num_stale > 0; num_visited-- ) {
+			assert( _stale_cursor < _pool.Size() );
+			Reencode_Entry( _stale_cursor++ );
+		}
+		if ( _num_stale == 0 ) _stale_cursor = 0;
+	}
+	void Finish_Reencoding()
+	{
+		if ( _num_stale > 0 ) Reencode_Entries( _pool.Size() - _stale_cursor );
+		Cacheable_Component<T>::_infor = _hit_infor;
 	}
 	void Verify( CacheEntryID loc, Component & comp )
 	{
@@ -324,7 +511,7 @@ public:
 			CacheEntryID top = node_stack.top();
 			node_stack.pop();
 			_pool[top]._parent = CacheEntryID::undef;
-			_pool[top]._result = _default_caching_value;
+			_pool[top]._result = _default_stored;
 			if ( _pool[top]._next_sibling != CacheEntryID::undef ) {
 				node_stack.push( _pool[top]._next_sibling );
 				_pool[top]._next_sibling = CacheEntryID::undef;
@@ -355,6 +542,36 @@ public:
 		}
 	}
 protected:
+	void Write_Stored_Result( CacheEntryID pos, const typename Cache_Value_Pool<T>::stored_type & stored )
+	{
+		Reencode_Entry( pos );
+		_hash_memory -= _pool[pos].Memory();
+		_pool[pos]._result = stored;
+		_hash_memory += _pool[pos].Memory();  /// result's memory might not be equal to that of pool[loc]._result
+	}
+	void Collect_Values()  // drop the interned results which are no longer referenced
+	{
+		if ( !Cache_Value_Pool<T>::interning || _max_var == Variable::undef ) return;
+		vector<typename Cache_Value_Pool<T>::stored_type *> live( 1, &_default_stored );
+		for ( cache_size_t i = 0; i < _pool.Size(); i++ ) {
+			live.push_back( &_pool[i]._result );
+		}
+		_values.Collect_Garbage( live );
+	}
+	void Reset_Counters()
+	{
+		_clock = 0;
+		_num_lookups = _num_hits = 0;
+		_evicted_memory = 0;
+		_num_evictions = 0;
+		_max_size = 0;
+		_max_memory = 0;
+	}
+	void Record_Peak()
+	{
+		_max_size = Max_Size();
+		_max_memory = Max_Memory();
+	}
 	bool Entry_Valid( CacheEntryID loc ) { return loc < _pool.Size(); }
 	CacheEntryID Entry_Previous_Sibling( CacheEntryID loc )
 	{
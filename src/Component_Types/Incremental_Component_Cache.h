@@ -32,9 +32,9 @@ public:
 		_original_binary_clauses.Clear();
 		_other_clauses.Clear();
 	}
-	void Init( Variable max_var, unsigned num_long_clause, T default_value )
+	void Init( Variable max_var, unsigned num_long_clause, T default_value, size_t num_entries = COMPONENT_CACHE_MIN_SIZE )
 	{
-		Component_Cache<T>::Init( max_var, num_long_clause, default_value );
+		Component_Cache<T>::Init( max_var, num_long_clause, default_value, num_entries );
 		_original_binary_clauses.Clear();
 		_original_binary_clauses.Enlarge_Fullset( max_var );
 		_other_clauses.Clear();
@@ -91,6 +91,48 @@ public:
 		return Component_Cache<T>::Hit_Component( comp );
 	}
 	const SortedSet<Literal> Read_Clause( SetID id ) { return _other_clauses.Elements( id + 1 ); }
+	void Write_Checkpoint( ostream & out )  // the clause sets in the order of IDs, followed by all entries
+	{
+		Write_Binary( out, _other_clauses.Size() );
+		for ( SetID id = 1; id < _other_clauses.Size(); id++ ) {  // not consider the empty set
+			const SortedSet<Literal> clause = _other_clauses.Elements( id );
+			Write_Binary( out, clause.size );
+			for ( unsigned j = 0; j < clause.size; j++ ) {
+				Write_Binary( out, clause.elems[j] );
+			}
+		}
+		Write_Binary( out, (cache_size_t) this->_pool.Size() );
+		for ( cache_size_t i = 0; i < this->_pool.Size(); i++ ) {
+			this->Write_Entry( out, i );
+		}
+	}
+	bool Read_Checkpoint( istream & in )  /// NOTE: replace all entries, and keep the locations of the writer
+	{
+		unsigned num_sets, size;
+		if ( !Read_Binary( in, num_sets ) ) return false;
+		vector<Literal> lits( NumVars( this->_max_var ) );
+		for ( SetID id = 1; id < num_sets; id++ ) {
+			if ( !Read_Binary( in, size ) || size < 2 || size > lits.size() ) return false;
+			for ( unsigned j = 0; j < size; j++ ) {
+				if ( !Read_Binary( in, lits[j] ) ) return false;
+			}
+			SetID set;
+			if ( size == 2 ) set = Encode_Binary_Clause( lits[0], lits[1] );
+			else set = Encode_Long_Clause( lits.data(), size );
+			if ( set != id - 1 ) return false;
+		}
+		cache_size_t num;
+		if ( !Read_Binary( in, num ) ) return false;
+		this->Clear();
+		Component comp;
+		T result;
+		for ( cache_size_t i = 0; i < num; i++ ) {
+			if ( !this->Read_Entry( in, comp, result ) ) return false;
+			if ( Hit_Component( comp ) != i ) return false;
+			this->Write_Result( i, result );
+		}
+		return true;
+	}
 };
 
 
@@ -33,11 +33,10 @@ public:
 		Component_Cache<T>::Reset();
 		_original_binary_clauses.Clear();
 		_other_clauses.Reset();
-		_hit_count = _hit_failed_count = 0;
 	}
-	void Init( Variable max_var, unsigned num_long_clause, T default_value )
+	void Init( Variable max_var, unsigned num_long_clause, T default_value, size_t num_entries = COMPONENT_CACHE_MIN_SIZE )
 	{
-		Component_Cache<T>::Init( max_var, num_long_clause, default_value );
+		Component_Cache<T>::Init( max_var, num_long_clause, default_value, num_entries );
 		_original_binary_clauses.Clear();
 		_original_binary_clauses.Enlarge_Fullset( max_var );
 		_other_clauses.Clear();
@@ -50,6 +49,14 @@ public:
 //		Display( cerr );  // ToRemove
 		return this->_hash_memory;
 	}
+	void Write_JSON( JSON_Writer & writer ) const
+	{
+		Component_Cache<T>::Write_JSON( writer );
+		writer.Field( "clauses", _other_clauses.Size() );
+		writer.Field( "clause_memory", _other_clauses.Memory() );
+		writer.Field( "hit_count", _hit_count );
+		writer.Field( "hit_failed_count", _hit_failed_count );
+	}
 	void Add_Original_Binary_Clause( Literal lit, Literal lit2 )
 	{
 		_original_binary_clauses.Binary_Set( lit, lit2 );
@@ -100,6 +107,52 @@ public:
 		_hit_failed_count += !this->_pool.Hit_Successful();
 		return pos;
 	}
+	void Write_Checkpoint( ostream & out )  // the encoded clauses in the order of IDs, followed by the entries with known results
+	{
+		Big_Clause clause( this->_max_var );
+		Write_Binary( out, _other_clauses.Size() );
+		for ( unsigned i = 0; i < _other_clauses.Size(); i++ ) {
+			_other_clauses.Read_Clause( i, clause );
+			Write_Binary( out, clause.Size() );
+			for ( unsigned j = 0; j < clause.Size(); j++ ) {
+				Write_Binary( out, clause[j] );
+			}
+		}
+		cache_size_t num = 0;
+		for ( cache_size_t i = 0; i < this->_pool.Size(); i++ ) {
+			num += ( this->_pool[i]._result != this->_default_stored );
+		}
+		Write_Binary( out, num );
+		for ( cache_size_t i = 0; i < this->_pool.Size(); i++ ) {
+			if ( this->_pool[i]._result != this->_default_stored ) this->Write_Entry( out, i );
+		}
+	}
+	bool Read_Checkpoint( istream & in )  /// NOTE: the clauses encoded before must be the same as those of the writer
+	{
+		unsigned num_clauses, size;
+		if ( !Read_Binary( in, num_clauses ) ) return false;
+		vector<Literal> lits( NumVars( this->_max_var ) );
+		for ( unsigned i = 0; i < num_clauses; i++ ) {
+			if ( !Read_Binary( in, size ) || size < 2 || size > lits.size() ) return false;
+			for ( unsigned j = 0; j < size; j++ ) {
+				if ( !Read_Binary( in, lits[j] ) ) return false;
+			}
+			SetID id;
+			if ( size == 2 ) id = Encode_Binary_Clause( lits[0], lits[1] );
+			else id = Encode_Long_Clause( lits.data(), size );
+			if ( id != i ) return false;
+		}
+		cache_size_t num;
+		if ( !Read_Binary( in, num ) ) return false;
+		Component comp;
+		T result;
+		for ( cache_size_t i = 0; i < num; i++ ) {
+			if ( !this->Read_Entry( in, comp, result ) ) return false;
+			CacheEntryID pos = Hit_Component( comp );
+			this->Write_Result( pos, result );
+		}
+		return true;
+	}
 };
 
 
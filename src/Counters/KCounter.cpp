@@ -1,5 +1,9 @@
 #include "KCounter.h"
 #include <sstream>
+#include <thread>
+#include <mutex>
+#include <dirent.h>
+#include <sys/stat.h>
 #include <sys/sysinfo.h>
 
 
@@ -46,6 +50,45 @@ void KCounter::Reset()
 	_component_cache.Reset();
 }
 
+void KCounter::Set_Running_Options( Counter_Parameters & parameters, bool quiet )
+{
+	debug_options.verify_learnts = false;
+	debug_options.verify_count = false;
+	debug_options.verify_component_count = false;
+	debug_options.verify_kernelization = false;
+	running_options.phase_selecting = false;
+	running_options.sat_filter_long_learnts = false;
+	running_options.detect_AND_gates = false;
+	running_options.block_lits_external = true;
+	running_options.static_heur = parameters.static_heur;
+	running_options.max_kdepth = parameters.kdepth;
+	running_options.mixed_imp_computing = true;
+	running_options.trivial_variable_bound = 128;
+	running_options.display_kernelizing_process = false;
+	running_options.max_memory = parameters.memo;
+	running_options.clear_half_of_cache = parameters.clear_half;
+	running_options.evict_cache = parameters.evict_cache;
+	running_options.treed_time_budget = parameters.treed_time;
+	if ( parameters.checkpoint.Exists() ) {
+		running_options.checkpoint_file = parameters.checkpoint;
+		running_options.checkpoint_interval = parameters.checkpoint_interval;
+		running_options.resume_from_checkpoint = parameters.resume;
+	}
+	if ( parameters.threads.Exists() ) {
+		running_options.minfill_num_threads = parameters.threads;
+		running_options.treed_num_threads = parameters.threads;
+		running_options.lit_equivalence_num_threads = parameters.threads;
+	}
+	if ( quiet ) {
+		running_options.profile_solving = Profiling_Close;
+		running_options.profile_preprocessing = Profiling_Close;
+		running_options.profile_counting = Profiling_Close;
+	}
+	if ( parameters.competition ) running_options.display_prefix = "c o ";
+	running_options.stats_json_file = parameters.stats_json;
+	running_options.stats_interval = parameters.stats_interval;
+}
+
 size_t KCounter::Memory()
 {
 	if ( _max_var == Variable::undef ) return 0;
@@ -67,6 +110,8 @@ BigInt KCounter::Count_Models( CNF_Formula & cnf, Heuristic heur )
 	if ( running_options.display_counting_process ) cout << running_options.display_prefix << "Counting models..." << endl;
 	Allocate_and_Init_Auxiliary_Memory( cnf.Max_Var() );
 	if ( running_options.profile_counting >= Profiling_Abstract ) begin_watch.Start();
+	_stats_snapshots.Open( running_options.stats_json_file, running_options.stats_interval );
+	budget.Start();
 	assert( _num_levels == 0 && _num_dec_stack == 0 && _num_comp_stack == 0 );
 	if ( running_options.display_counting_process ) cout << running_options.display_prefix << "Begin preprocess..." << endl;
 	running_options.detect_lit_equivalence = ( running_options.max_kdepth > 0 );
@@ -108,6 +153,7 @@ BigInt KCounter::Count_Models( CNF_Formula & cnf, Heuristic heur )
 	if ( running_options.imp_strategy != SAT_Imp_Computing ) {  // ToModify
 		Recycle_Models( _models_stack[0] );
 		if ( Large_Scale_Problem() ) _model_pool->Free_Unallocated_Models();
+		Open_Checkpoint();
 		Count_With_Implicite_BCP();
 	}
 	else {
@@ -115,13 +161,17 @@ BigInt KCounter::Count_Models( CNF_Formula & cnf, Heuristic heur )
 			if ( Is_Linear_Ordering( running_options.var_ordering_heur ) ) _lit_equivalency.Reorder( _var_order );
 			Encode_Long_Clauses();
 		}
+		Open_Checkpoint();
 		Count_With_SAT_Imp_Computing();
 	}
+	_checkpoint_writer.Close();
 	Set_Current_Level_Kernelized( false );
 	_fixed_num_vars += _and_gates.size();
 	Load_Lit_Equivalences( _call_stack[0] );
 	_call_stack[0].Clear_Lit_Equivalences();
-	BigInt count = Backtrack_Init();
+	BigInt count;
+	if ( _num_rsl_stack == 1 ) count = Backtrack_Init();
+	else count = Backtrack_Failure();  // interrupted by the budget
 	if ( running_options.profile_counting >= Profiling_Abstract ) statistics.time_count = begin_watch.Get_Elapsed_Seconds();
 	if ( debug_options.verify_learnts ) Verify_Learnts( cnf );
 	if ( running_options.display_counting_process ) {
@@ -168,7 +218,8 @@ void KCounter::Choose_Running_Options( Heuristic heur )
 		break;
 	case FlowCutter:
 		Compute_Var_Order_Flow_Cutter();
-		if ( running_options.display_compiling_process ) cout << running_options.display_prefix << "The flow cutter treewidth: " << running_options.treewidth << endl;
+		if ( running_options.display_counting_process ) cout << running_options.display_prefix << "The flow cutter treewidth: " << running_options.treewidth << endl;
+		break;
 	case LinearLRW:
 		Compute_Var_Order_Single_Cluster();
 		break;
@@ -252,7 +303,8 @@ void KCounter::Choose_Running_Options_Static( Heuristic heur )
 		break;
 	case FlowCutter:
 		Compute_Var_Order_Flow_Cutter();
-		if ( running_options.display_compiling_process ) cout << running_options.display_prefix << "The flow cutter treewidth: " << running_options.treewidth << endl;
+		if ( running_options.display_counting_process ) cout << running_options.display_prefix << "The flow cutter treewidth: " << running_options.treewidth << endl;
+		break;
 	case LexicographicOrder:
 		Compute_Var_Order_Lexicographic();
 		break;
@@ -331,7 +383,7 @@ void KCounter::Create_Init_Level()
 	_num_levels = 2;
 	assert( _component_cache.Size() == 0 );
 	if ( running_options.profile_counting >= Profiling_Abstract ) tmp_watch.Start();
-	_component_cache.Init( _max_var, _old_num_long_clauses, -1 );
+	_component_cache.Init( _max_var, _old_num_long_clauses, -1, Fitted_Table_Size() );
 	Component_Cache_Add_Original_Clauses();
 	_component_cache.Hit_Component( _comp_stack[0] );
 	if ( running_options.profile_counting >= Profiling_Abstract ) statistics.time_gen_cnf_cache = tmp_watch.Get_Elapsed_Seconds();
@@ -367,6 +419,39 @@ void KCounter::Component_Cache_Add_Original_Clauses()
 	if ( DEBUG_OFF ) _unified_comp.Verify_Orderness();  // ToRemove
 }
 
+void KCounter::Open_Checkpoint()
+{
+	if ( running_options.checkpoint_file == nullptr ) return;
+	_checkpoint_fingerprint = Fingerprint_Original_Clauses();
+	if ( running_options.resume_from_checkpoint ) Load_Checkpoint();
+	_checkpoint_writer.Open( running_options.checkpoint_file, running_options.checkpoint_interval );
+}
+
+void KCounter::Write_Checkpoint()  /// NOTE: the known results of components are exact, so they are all that is needed to resume
+{
+	ostringstream out;
+	_checkpoint_writer.Write_Header( out, Checkpoint_ExactMC, _checkpoint_fingerprint );
+	_component_cache.Write_Checkpoint( out );
+	string data = out.str();
+	if ( running_options.display_counting_process ) {
+		cout << running_options.display_prefix << "Checkpoint " << _checkpoint_writer.Num_Written() + 1 << ": " << data.size() / 1024 << " KB" << endl;
+	}
+	_checkpoint_writer.Write_Async( data );
+}
+
+void KCounter::Load_Checkpoint()
+{
+	stringstream in;
+	if ( !Checkpoint_Writer::Read_File( running_options.checkpoint_file, Checkpoint_ExactMC, _checkpoint_fingerprint, in ) ) return;
+	cache_size_t old_size = _component_cache.Size();
+	if ( !_component_cache.Read_Checkpoint( in ) ) {
+		cerr << "Warning[KCounter]: " << running_options.checkpoint_file << " is truncated or mismatched, and only its valid prefix is loaded!" << endl;
+	}
+	if ( running_options.display_counting_process ) {
+		cout << running_options.display_prefix << "Resume from " << running_options.checkpoint_file << " with " << _component_cache.Size() - old_size << " known components" << endl;
+	}
+}
+
 void KCounter::Count_With_Implicite_BCP()
 {
 	unsigned old_num_levels = _num_levels;
@@ -384,6 +469,7 @@ void KCounter::Count_With_Implicite_BCP()
 	//		system( "pause" );
 //			Display_Comp_And_Decision_Stacks( cerr );  // ToRemove
 		}
+		if ( budget.Active() && budget.Exhausted() ) break;
 		if ( Num_Components_On_Current_Level() <= 1 ) { // decision or preparation
 			switch ( _state_stack[_num_levels - 1] ) {
 			case 0:
@@ -485,7 +571,8 @@ void KCounter::Count_With_Implicite_BCP()
 			}
 		}
 	}
-	assert( _num_levels == old_num_levels - 1 && _num_rsl_stack == old_num_rsl_stack + 1 );
+	if ( _num_levels == old_num_levels - 1 ) assert( _num_rsl_stack == old_num_rsl_stack + 1 );
+	else Terminate_Counting();
 }
 
 void KCounter::Backjump_Decision( unsigned num_kept_levels )
@@ -522,6 +609,7 @@ void KCounter::Backtrack_Known( BigInt cached_result )
 
 BigInt KCounter::Component_Cache_Map_Current_Component()
 {
+	Trace_Scope trace( Trace_Cache_Lookup );
 	StopWatch begin_watch;
 	if ( running_options.profile_counting >= Profiling_Abstract ) begin_watch.Start();
 	Component & comp = Current_Component();
@@ -539,6 +627,8 @@ BigInt KCounter::Component_Cache_Map_Current_Component()
 		Component_Cache_Connect_Current_Component();
 	}
 	if ( Cache_Clear_Applicable() ) Component_Cache_Clear();
+	if ( _checkpoint_writer.Due() ) Write_Checkpoint();
+	if ( _stats_snapshots.Due() ) _stats_snapshots.Write( *this );
 	if ( running_options.profile_counting >= Profiling_Abstract ) statistics.time_gen_cnf_cache += begin_watch.Get_Elapsed_Seconds();
 	return _component_cache.Read_Result( comp.caching_loc );
 }
@@ -632,7 +722,7 @@ bool KCounter::Cache_Clear_Applicable()
 	if ( _component_cache.Memory() <= max_mem * 0.3 ) return false;
 	if ( _component_cache.Memory() > max_mem * 0.7 ) return true;
 	if ( _component_cache.Size() < _component_cache.Capacity() || _component_cache.Hit_Successful() ) return false;
-	size_t mem = Total_Used_Memory();
+	size_t mem = Memory_Ledger::Total();
 	if ( running_options.display_counting_process && running_options.profile_counting != Profiling_Close ) {
 		cout << running_options.display_prefix << (float) _component_cache.Memory() / GB << " (cache) / ";
 		cout << (float) mem / GB << " (total) in GB" << endl;
@@ -643,7 +733,8 @@ bool KCounter::Cache_Clear_Applicable()
 
 void KCounter::Component_Cache_Clear()
 {
-	if ( running_options.display_counting_process ) cout << running_options.display_prefix << "clear cache" << endl;
+	Trace_Scope trace( Trace_Cache_Clear );
+	if ( running_options.display_counting_process && !running_options.evict_cache ) cout << running_options.display_prefix << "clear cache" << endl;
 	vector<size_t> kept_locs;
 	for ( unsigned i = 1; i < _num_levels; i++ ) {
 		kept_locs.push_back( _comp_stack[_comp_offsets[i]].caching_loc );
@@ -654,7 +745,13 @@ void KCounter::Component_Cache_Clear()
 	for ( unsigned i = 1; i < _num_levels; i++ ) {
 		if ( _call_stack[i].Existed() ) kept_locs.push_back( _call_stack[i].Get_Caching_Loc() );
 	}
-	if ( !running_options.clear_half_of_cache ) _component_cache.Clear_Shrink_Half( kept_locs );
+	if ( running_options.evict_cache ) {
+		size_t evicted = _component_cache.Evict( kept_locs, 0.6 );  /// NOTE: keep the entries of the highest priority, so that the hot ones survive
+		if ( running_options.display_counting_process ) {
+			cout << running_options.display_prefix << "evict cache: " << evicted / (1.0 * 1024 * 1024) << " M" << endl;
+		}
+	}
+	else if ( !running_options.clear_half_of_cache ) _component_cache.Clear_Shrink_Half( kept_locs );
 	else _component_cache.Clear_Half( kept_locs );
 	unsigned index = 0;
 	for ( unsigned i = 1; i < _num_levels; i++ ) {
@@ -799,6 +896,7 @@ void KCounter::Count_With_SAT_Imp_Computing()
 	//		system( "pause" );
 			Display_Comp_And_Decision_Stacks( cerr );  // ToRemove
 		}
+		if ( budget.Active() && budget.Exhausted() ) break;
 		if ( Num_Components_On_Current_Level() <= 1 ) { // decision or preparation
 			switch ( _state_stack[_num_levels - 1] ) {
 			case 0:
@@ -879,7 +977,8 @@ void KCounter::Count_With_SAT_Imp_Computing()
 			}
 		}
 	}
-	assert( _num_levels == 1 && _num_rsl_stack == 1 );
+	if ( _num_levels != 1 ) Terminate_Counting();
+	assert( _num_rsl_stack == 1 || budget.Interrupted() );  // a nested search may have terminated already
 }
 
 bool KCounter::Try_Shift_To_Implicite_BCP()
@@ -906,7 +1005,7 @@ bool KCounter::Try_Shift_To_Implicite_BCP()
 	}
 	if ( false && comp.Vars_Size() > running_options.trivial_variable_bound / 1 ) system( "./pause" );  // ToRemove
 	running_options.imp_strategy = SAT_Imp_Computing;
-	Leave_Final_Kernelization();
+	if ( _num_rsl_stack > 0 ) Leave_Final_Kernelization();
 	return true;
 }
 
@@ -1570,6 +1669,10 @@ void KCounter::Terminate_Counting()
 	_num_rsl_stack = 0;
 	_swap_frame.Clear();
 	while ( _num_levels > 1 ) {
+		if ( _call_stack[_num_levels - 1].Existed() ) {  // otherwise the next run starts with a wrong kdepth and a stale component
+			Set_Current_Level_Kernelized( false );
+			_call_stack[_num_levels - 1].Clear_Component();
+		}
 		_call_stack[_num_levels - 1].Free_Long_Clauses();
 		_call_stack[_num_levels - 1].Clear();
 		Recycle_Models( _models_stack[_num_levels - 1] );
@@ -1795,6 +1898,9 @@ void KCounter::Display_Statistics( unsigned option )
 			cout << running_options.display_prefix << "time IBCP: " << statistics.time_ibcp << endl;
 			cout << running_options.display_prefix << "time dynamic decomposition: " << statistics.time_dynamic_decompose << " (" << statistics.time_dynamic_decompose_sort << " sorting)" << endl;
 			cout << running_options.display_prefix << "time cnf cache: " << statistics.time_gen_cnf_cache << endl;
+			cout << running_options.display_prefix << "cache hit rate: " << _component_cache.Hit_Rate()
+				<< " (" << _component_cache.Num_Hits() << "/" << _component_cache.Num_Lookups() << " lookups; evicted "
+				<< _component_cache.Evicted_Memory() / (1.0 * 1024 * 1024) << " M in " << _component_cache.Num_Evictions() << " rounds)" << endl;
 			cout << running_options.display_prefix << "time kernelize: " << statistics.time_kernelize
 				<< " (block lits: " << statistics.time_kernelize_block_lits
 				<< "; vivi: " << statistics.time_kernelize_vivification
@@ -1822,24 +1928,152 @@ void KCounter::Display_Memory_Status( ostream & out )
 		mem += _long_clauses[i].Size() * sizeof(unsigned) + sizeof(unsigned *) + sizeof(unsigned);
 	}
 	out << running_options.display_prefix << "#clauses: " << Num_Clauses() << " (" << mem / (1.0 * 1024 * 1024) << " M)" << endl;
-	out << running_options.display_prefix << "#components: " << _component_cache.Size() << " (" << _component_cache.Memory() / (1.0 * 1024 * 1024) << " M)" << endl;
+	out << running_options.display_prefix << "#components: " << _component_cache.Size() << " (" << _component_cache.Memory() / (1.0 * 1024 * 1024) << " M";
+	out << "; " << _component_cache.Num_Distinct_Results() << " distinct results)" << endl;
 	if ( DEBUG_OFF ) out << running_options.display_prefix << "    Where the duplicate rate is " << _component_cache.Duplicate_Rate() << " and the useless ratio is " << _component_cache.Useless_Rate() << endl;
 	out << running_options.display_prefix << "#models: " << _model_pool->Size() << "/" << _model_pool->Capacity() << " (" << _model_pool->Memory() / (1.0 * 1024 * 1024) << " M)" << endl;
 	out << running_options.display_prefix << "Total memory: " << Memory() / (1.0 * 1024 * 1024) << "M" << endl;
 }
 
+void KCounter::Write_Statistics_JSON( JSON_Writer & writer )
+{
+	Solver::Write_Statistics_JSON( writer );
+	writer.Begin_Object( "component_cache" );
+	_component_cache.Write_JSON( writer );
+	writer.End_Object();
+}
+
 bool KCounter::Is_Memory_Exhausted()
 {
-	size_t counterram = Memory();  // int overflows
+	size_t counterram = Memory_Ledger::Total();  // int overflows
 	struct sysinfo info;
 	sysinfo(&info);
 	double free_ratio = 1.0 * info.freeram / info.totalram;
-	static unsigned exhausted = 0.4;
+	const double exhausted = 0.4;
 	if ( counterram > exhausted * info.freeram && free_ratio <= 0.1 ) {
 		return true;
 	}
 	else return false;
 }
 
+bool Read_Batch_Instances( const char * infile, vector<string> & instances )  // a directory of cnf files, or a list with one path per line
+{
+	struct stat status;
+	if ( stat( infile, &status ) != 0 ) return false;
+	string dir( infile );
+	if ( S_ISDIR( status.st_mode ) ) {
+		DIR * entries = opendir( infile );
+		if ( entries == nullptr ) return false;
+		while ( dirent * entry = readdir( entries ) ) {
+			string path = dir + "/" + entry->d_name;
+			if ( entry->d_name[0] != '.' && stat( path.c_str(), &status ) == 0 && S_ISREG( status.st_mode ) ) instances.push_back( path );
+		}
+		closedir( entries );
+		sort( instances.begin(), instances.end() );
+		return true;
+	}
+	size_t slash = dir.find_last_of( '/' );
+	dir = ( slash == string::npos ) ? "" : dir.substr( 0, slash + 1 );
+	ifstream fin( infile );
+	string line;
+	while ( getline( fin, line ) ) {
+		size_t begin = line.find_first_not_of( " \t\r" );
+		if ( begin == string::npos || line[begin] == '#' ) continue;
+		string path = line.substr( begin, line.find_last_not_of( " \t\r" ) - begin + 1 );
+		instances.push_back( path[0] == '/' ? path : dir + path );  // relative to the list
+	}
+	return !fin.bad();
+}
+
+void KCounter::Test_Batch( const char * infile, Counter_Parameters & parameters )
+{
+	/* NOTE:
+	* Each worker counts its share of the instances with one counter, which is reset rather than rebuilt
+	* between them and sizes its component cache to each instance, so an instance costs neither a process
+	* nor a cache of LARGE_HASH_TABLE entries. The time limit holds for each instance; the memory ledger is
+	* shared by the workers, so with k jobs an instance stops when they hold over k times the memory limit
+	*/
+	vector<string> instances;
+	if ( !Read_Batch_Instances( infile, instances ) ) {
+		cerr << "ERROR[KCounter]: the batch \"" << infile << "\" cannot be read!" << endl;
+		exit( 1 );
+	}
+	unsigned num_jobs = parameters.jobs > 0 ? (unsigned) parameters.jobs : max( thread::hardware_concurrency(), 1u );
+	num_jobs = max( min<unsigned>( num_jobs, instances.size() ), 1u );
+	ofstream fout;
+	if ( parameters.jsonl.Exists() ) {
+		fout.open( parameters.jsonl );
+		if ( fout.fail() ) {
+			cerr << "ERROR[KCounter]: the file \"" << parameters.jsonl << "\" cannot be written!" << endl;
+			exit( 1 );
+		}
+	}
+	ostream & out = parameters.jsonl.Exists() ? fout : cout;
+	mutex out_mutex;
+	atomic<size_t> next( 0 );
+	vector<unsigned> num_status( Run_Memory_Out + 1, 0 );
+	unsigned num_errors = 0;
+	Heuristic heur = Parse_Heuristic( parameters.heur );
+	auto worker = [&]() {
+		KCounter counter;
+		counter.Set_Running_Options( parameters, true );
+		counter.running_options.display_counting_process = false;
+		counter.running_options.display_preprocessing_process = false;
+		counter.running_options.stats_json_file = nullptr;
+		counter.Set_Budget( parameters );
+		counter.budget.memory_limit *= num_jobs;
+		for ( size_t i = next++; i < instances.size() && !Interrupt_Signal().load(); i = next++ ) {
+			StopWatch watch;
+			watch.Start();
+			ostringstream line;
+			JSON_Writer writer( line );
+			writer.Field( "instance", instances[i].c_str() );
+			ifstream fin( instances[i] );
+			bool readable = !fin.fail();
+			Run_Status status = Run_Done;
+			if ( !readable ) {
+				writer.Field( "status", "error" );
+				writer.Field( "error", "cannot be opened" );
+			}
+			else {
+				CNF_Formula cnf( fin );
+				fin.close();
+				writer.Field( "variables", cnf.Num_Vars() );
+				writer.Field( "clauses", cnf.Num_Clauses() );
+				BigInt count;
+				if ( cnf.Max_Var() == Variable::undef ) count = cnf.Known_Count();
+				else {
+					count = counter.Count_Models( cnf, heur );
+					status = counter.budget.Status();
+				}
+				writer.Field( "status", Run_Status_Name( status ) );
+				ostringstream count_str;  // a string, since counts overflow the numbers of most JSON readers
+				count_str << count;
+				if ( status == Run_Done ) writer.Field( "count", count_str.str().c_str() );
+				else writer.Field( "count", (const char *) nullptr );
+			}
+			writer.Field( "seconds", watch.Get_Elapsed_Seconds() );
+			writer.End_Object();
+			lock_guard<mutex> lock( out_mutex );
+			if ( readable ) num_status[status]++;
+			else num_errors++;
+			out << line.str() << flush;
+		}
+	};
+	vector<thread> helpers;
+	for ( unsigned j = 1; j < num_jobs; j++ ) {
+		helpers.push_back( thread( worker ) );
+	}
+	worker();
+	for ( thread & helper: helpers ) {
+		helper.join();
+	}
+	if ( parameters.jsonl.Exists() ) {
+		cout << "Batch of " << instances.size() << " instances with " << num_jobs << " jobs: " << num_status[Run_Done] << " done, ";
+		cout << num_status[Run_Timeout] << " timeout, " << num_status[Run_Memory_Out] << " memory out, ";
+		cout << num_status[Run_Cancelled] << " cancelled, " << num_errors << " unreadable" << endl;
+	}
+}
+
 
 }
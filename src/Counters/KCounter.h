@@ -17,16 +17,21 @@ protected:
 	Incremental_Component_Cache_Compressed_Clauses<BigInt> _component_cache;
 	Component _incremental_comp;
 	vector<Literal> _equivalent_lit_pairs;
+	Checkpoint_Writer _checkpoint_writer;
+	uint64_t _checkpoint_fingerprint;
+	Statistics_Snapshots _stats_snapshots;
 public:
 	KCounter();
 	~KCounter();
 	void Reset();
 	size_t Memory();
+	void Write_Statistics_JSON( JSON_Writer & writer );  // the statistics together with the cache metrics
 	void Set_Max_Var( Variable max_var ) { Allocate_and_Init_Auxiliary_Memory( max_var ); }
 protected:
 	void Allocate_and_Init_Auxiliary_Memory( Variable max_var );
 	void Free_Auxiliary_Memory();
 public:
+	void Set_Running_Options( Counter_Parameters & parameters, bool quiet );  // the options of ExactMC
 	BigInt Count_Models( CNF_Formula & cnf, Heuristic heur = AutomaticalHeur );
 protected:
 	BigInt Backtrack_Init();
@@ -38,6 +43,9 @@ protected:
 	void Choose_Implicate_Computing_Strategy_Static();
 	void Create_Init_Level();
 	void Component_Cache_Add_Original_Clauses();
+	void Open_Checkpoint();  // load the checkpoint first when resuming
+	void Write_Checkpoint();
+	void Load_Checkpoint();
 protected:
 	void Count_With_Implicite_BCP();
 	void Backjump_Decision( unsigned num_kept_levels );  // backtrack when detect some unsatisfiable component, and tail is decision
@@ -128,28 +136,9 @@ public:
 	static void Test( const char * infile, Counter_Parameters parameters, bool quiet )
 	{
 		KCounter counter;
-		counter.debug_options.verify_learnts = false;
-		counter.debug_options.verify_count = false;
-		counter.debug_options.verify_component_count = false;
-		counter.debug_options.verify_kernelization = false;
-		counter.running_options.phase_selecting = false;
-		counter.running_options.sat_filter_long_learnts = false;
-		counter.running_options.detect_AND_gates = false;
-		counter.running_options.block_lits_external = true;
-		counter.running_options.static_heur = parameters.static_heur;
-		counter.running_options.max_kdepth = parameters.kdepth;
-		counter.running_options.mixed_imp_computing = true;
-		counter.running_options.trivial_variable_bound = 128;
-		counter.running_options.display_kernelizing_process = false;
-		counter.running_options.max_memory = parameters.memo;
-		counter.running_options.clear_half_of_cache = parameters.clear_half;
+		counter.Set_Running_Options( parameters, quiet );
+		counter.Set_Budget( parameters );
 		Heuristic heur = Parse_Heuristic( parameters.heur );
-		if ( quiet ) {
-			counter.running_options.profile_solving = Profiling_Close;
-			counter.running_options.profile_preprocessing = Profiling_Close;
-			counter.running_options.profile_counting = Profiling_Close;
-		}
-		if ( parameters.competition ) counter.running_options.display_prefix = "c o ";
 		if ( !parameters.condition.Exists() ) {
 			ifstream fin( infile );
 			CNF_Formula cnf( fin );
@@ -161,8 +150,12 @@ public:
 				else cout << "s UNSATISFIABLE" << endl;
 			}
 			else count = counter.Count_Models( cnf, heur );
-			cout << counter.running_options.display_prefix << "Number of models: " << count << endl;
-			if ( parameters.competition ) {  // for model counting competition
+			if ( counter.budget.Interrupted() ) {
+				cout << counter.running_options.display_prefix << "Number of models: unknown (" << Run_Status_Name( counter.budget.Status() ) << ")" << endl;
+				if ( parameters.competition ) cout << "s UNKNOWN" << endl;
+			}
+			else cout << counter.running_options.display_prefix << "Number of models: " << count << endl;
+			if ( parameters.competition && !counter.budget.Interrupted() ) {  // for model counting competition
 				cout << "c s type mc" << endl;
 				cout << "c o The solver log10-estimates a solution of " << count << endl;
 				long exp;
@@ -178,6 +171,7 @@ public:
 			Read_Assignments( fin_cond, terms );
 			fin_cond.close();
 			vector<BigInt> counts( terms.size() );
+			unsigned num_known = terms.size();  // the counts from the interrupted one on are unknown
 			if ( access("B+E_linux", X_OK ) == 0 || access("solvers/B+E_linux", X_OK ) == 0 ) {
 				for ( unsigned i = 0; i < terms.size(); i++ ) {
 					ifstream fin( infile );
@@ -205,6 +199,10 @@ public:
 					fin2.close();
 					if ( cnf2.Max_Var() == Variable::undef ) counts[i] = cnf2.Known_Count();
 					else counts[i] = counter.Count_Models( cnf2, heur );
+					if ( counter.budget.Interrupted() ) {
+						num_known = i;
+						break;
+					}
 				}
 			}
 			else {
@@ -216,13 +214,22 @@ public:
 					cnf.Condition( terms[i] );
 					if ( cnf.Max_Var() == Variable::undef ) counts[i] = cnf.Known_Count();
 					else counts[i] = counter.Count_Models( cnf, heur );
+					if ( counter.budget.Interrupted() ) {
+						num_known = i;
+						break;
+					}
 				}
 			}
 			for ( unsigned i = 0; i < counts.size(); i++ ) {
-				cout << counter.running_options.display_prefix << "Number of models: " << counts[i] << endl;
+				if ( i >= num_known ) {
+					cout << counter.running_options.display_prefix << "Number of models: unknown (" << Run_Status_Name( counter.budget.Status() ) << ")" << endl;
+				}
+				else cout << counter.running_options.display_prefix << "Number of models: " << counts[i] << endl;
 			}
 		}
+		if ( parameters.stats_json.Exists() ) Write_Statistics_File( counter, parameters.stats_json );
 	}
+	static void Test_Batch( const char * infile, Counter_Parameters & parameters );  // one JSON line per instance
 };
 
 
@@ -66,6 +66,8 @@ BigFloat WCounter::Count_Models( WCNF_Formula & cnf, Heuristic heur )
 	if ( running_options.display_counting_process ) cout << running_options.display_prefix << "Counting models..." << endl;
 	Allocate_and_Init_Auxiliary_Memory( cnf.Max_Var() );
 	if ( running_options.profile_counting >= Profiling_Abstract ) begin_watch.Start();
+	_stats_snapshots.Open( running_options.stats_json_file, running_options.stats_interval );
+	budget.Start();
 	assert( _num_levels == 0 && _num_dec_stack == 0 && _num_comp_stack == 0 );
 	if ( running_options.display_counting_process ) cout << running_options.display_prefix << "Begin preprocess..." << endl;
 	bool cnf_sat;
@@ -108,7 +110,9 @@ BigFloat WCounter::Count_Models( WCNF_Formula & cnf, Heuristic heur )
 		Count_With_Implicite_BCP();  // ToModify
 	}
 	else Count_With_SAT_Imp_Computing();
-	BigFloat count = Backtrack_Init();
+	BigFloat count;
+	if ( _num_rsl_stack == 1 ) count = Backtrack_Init();
+	else count = Backtrack_Failure();  // interrupted by the budget
 	if ( running_options.profile_counting >= Profiling_Abstract ) statistics.time_compile = begin_watch.Get_Elapsed_Seconds();
 	if ( debug_options.verify_learnts ) Verify_Learnts( cnf );
 	if ( running_options.display_counting_process ) {
@@ -159,7 +163,8 @@ void WCounter::Choose_Running_Options( Heuristic heur )
 		break;
 	case FlowCutter:
 		Compute_Var_Order_Flow_Cutter();
-		if ( running_options.display_compiling_process ) cout << running_options.display_prefix << "The flow cutter treewidth: " << running_options.treewidth << endl;
+		if ( running_options.display_counting_process ) cout << running_options.display_prefix << "The flow cutter treewidth: " << running_options.treewidth << endl;
+		break;
 	case LexicographicOrder:
 		Compute_Var_Order_Lexicographic();
 		break;
@@ -204,7 +209,8 @@ void WCounter::Choose_Running_Options_Static( Heuristic heur )
 		break;
 	case FlowCutter:
 		Compute_Var_Order_Flow_Cutter();
-		if ( running_options.display_compiling_process ) cout << running_options.display_prefix << "The flow cutter treewidth: " << running_options.treewidth << endl;
+		if ( running_options.display_counting_process ) cout << running_options.display_prefix << "The flow cutter treewidth: " << running_options.treewidth << endl;
+		break;
 	case LexicographicOrder:
 		Compute_Var_Order_Lexicographic();
 		break;
@@ -265,7 +271,7 @@ void WCounter::Create_Init_Level()
 	_num_levels = 2;
 	assert( _component_cache.Size() == 0 );
 	if ( running_options.profile_counting >= Profiling_Abstract ) tmp_watch.Start();
-	_component_cache.Init( _max_var, _old_num_long_clauses, -1 );
+	_component_cache.Init( _max_var, _old_num_long_clauses, -1, Fitted_Table_Size() );
 	_component_cache.Hit_Component( _comp_stack[0] );
 	if ( running_options.profile_counting >= Profiling_Abstract ) statistics.time_gen_cnf_cache = tmp_watch.Get_Elapsed_Seconds();
 }
@@ -287,6 +293,7 @@ void WCounter::Count_With_Implicite_BCP()
 	//		system( "pause" );
 //			Display_Comp_And_Decision_Stacks( cerr );  // ToRemove
 		}
+		if ( budget.Active() && budget.Exhausted() ) break;
 		if ( Num_Components_On_Current_Level() <= 1 ) { // decision or preparation
 			switch ( _state_stack[_num_levels - 1] ) {
 			case 0:
@@ -388,7 +395,8 @@ void WCounter::Count_With_Implicite_BCP()
 			}
 		}
 	}
-	assert( _num_levels == old_num_levels - 1 && _num_rsl_stack == old_num_rsl_stack + 1 );
+	if ( _num_levels == old_num_levels - 1 ) assert( _num_rsl_stack == old_num_rsl_stack + 1 );
+	else Terminate_Counting();
 }
 
 void WCounter::Backjump_Decision( unsigned num_kept_levels )
@@ -431,6 +439,7 @@ void WCounter::Backtrack_Known( BigFloat cached_result )
 
 BigFloat WCounter::Component_Cache_Map_Current_Component()
 {
+	Trace_Scope trace( Trace_Cache_Lookup );
 	StopWatch tmp_watch;
 	if ( running_options.profile_counting >= Profiling_Abstract ) tmp_watch.Start();
 	Component & comp = Current_Component();
@@ -439,6 +448,7 @@ BigFloat WCounter::Component_Cache_Map_Current_Component()
 		Component_Cache_Connect_Current_Component();
 	}
 	if ( Cache_Clear_Applicable() ) Component_Cache_Clear();
+	if ( _stats_snapshots.Due() ) _stats_snapshots.Write( *this );
 	if ( running_options.profile_counting >= Profiling_Abstract ) statistics.time_gen_cnf_cache += tmp_watch.Get_Elapsed_Seconds();
 	return _component_cache.Read_Result( comp.caching_loc );
 }
@@ -468,7 +478,7 @@ bool WCounter::Cache_Clear_Applicable()
 	if ( _component_cache.Memory() <= max_mem * 0.3 ) return false;
 	if ( _component_cache.Memory() > max_mem * 0.7 ) return true;
 	if ( _component_cache.Size() < _component_cache.Capacity() || _component_cache.Hit_Successful() ) return false;
-	size_t mem = Total_Used_Memory();
+	size_t mem = Memory_Ledger::Total();
 	if ( running_options.display_counting_process && running_options.profile_counting != Profiling_Close ) {
 		cout << running_options.display_prefix << (float) _component_cache.Memory() / GB << " (cache) / ";
 		cout << (float) mem / GB << " (total) in GB" << endl;
@@ -479,7 +489,8 @@ bool WCounter::Cache_Clear_Applicable()
 
 void WCounter::Component_Cache_Clear()
 {
-	if ( running_options.display_counting_process ) cout << running_options.display_prefix << "clear cache" << endl;
+	Trace_Scope trace( Trace_Cache_Clear );
+	if ( running_options.display_counting_process && !running_options.evict_cache ) cout << running_options.display_prefix << "clear cache" << endl;
 	vector<size_t> kept_locs;
 	for ( unsigned i = 1; i < _num_levels; i++ ) {
 		kept_locs.push_back( _comp_stack[_comp_offsets[i]].caching_loc );
@@ -487,7 +498,13 @@ void WCounter::Component_Cache_Clear()
 			kept_locs.push_back( _comp_stack[j].caching_loc );
 		}
 	}
-	if ( !running_options.clear_half_of_cache ) _component_cache.Clear_Shrink_Half( kept_locs );
+	if ( running_options.evict_cache ) {
+		size_t evicted = _component_cache.Evict( kept_locs, 0.6 );  /// NOTE: keep the entries of the highest priority, so that the hot ones survive
+		if ( running_options.display_counting_process ) {
+			cout << running_options.display_prefix << "evict cache: " << evicted / (1.0 * 1024 * 1024) << " M" << endl;
+		}
+	}
+	else if ( !running_options.clear_half_of_cache ) _component_cache.Clear_Shrink_Half( kept_locs );
 	else _component_cache.Clear_Half( kept_locs );
 	unsigned index = 0;
 	for ( unsigned i = 1; i < _num_levels; i++ ) {
@@ -629,6 +646,7 @@ void WCounter::Count_With_SAT_Imp_Computing()
 	//		system( "pause" );
 			Display_Comp_And_Decision_Stacks( cerr );  // ToRemove
 		}
+		if ( budget.Active() && budget.Exhausted() ) break;
 		if ( Num_Components_On_Current_Level() <= 1 ) { // decision or preparation
 			switch ( _state_stack[_num_levels - 1] ) {
 			case 0:
@@ -703,7 +721,8 @@ void WCounter::Count_With_SAT_Imp_Computing()
 			}
 		}
 	}
-	assert( _num_levels == 1 && _num_rsl_stack == 1 );
+	if ( _num_levels != 1 ) Terminate_Counting();
+	assert( _num_rsl_stack == 1 || budget.Interrupted() );  // a nested search may have terminated already
 }
 
 bool WCounter::Try_Shift_To_Implicite_BCP()
@@ -1225,6 +1244,9 @@ void WCounter::Display_Statistics( unsigned option )
 			else cout << running_options.display_prefix << "time IBCP: " << statistics.time_ibcp << endl;
 			cout << running_options.display_prefix << "time dynamic decomposition: " << statistics.time_dynamic_decompose << " (" << statistics.time_dynamic_decompose_sort << " sorting)" << endl;
 			cout << running_options.display_prefix << "time cnf cache: " << statistics.time_gen_cnf_cache << endl;
+			cout << running_options.display_prefix << "cache hit rate: " << _component_cache.Hit_Rate()
+				<< " (" << _component_cache.Num_Hits() << "/" << _component_cache.Num_Lookups() << " lookups; evicted "
+				<< _component_cache.Evicted_Memory() / (1.0 * 1024 * 1024) << " M in " << _component_cache.Num_Evictions() << " rounds)" << endl;
 			cout << running_options.display_prefix << "Total time cost: " << statistics.time_compile << endl;
 			cout << running_options.display_prefix << "number of (binary) learnt clauses: " << statistics.num_binary_learnt << "/" << statistics.num_learnt << endl;
 			cout << running_options.display_prefix << "number of (useful) sat calls: " << statistics.num_unsat_solve << "/" << statistics.num_solve << endl;
@@ -1253,13 +1275,21 @@ void WCounter::Display_Memory_Status( ostream & out )
 	out << running_options.display_prefix << "Total memory: " << Memory() / (1.0 * 1024 * 1024) << "M" << endl;
 }
 
+void WCounter::Write_Statistics_JSON( JSON_Writer & writer )
+{
+	Solver::Write_Statistics_JSON( writer );
+	writer.Begin_Object( "component_cache" );
+	_component_cache.Write_JSON( writer );
+	writer.End_Object();
+}
+
 bool WCounter::Is_Memory_Exhausted()
 {
-	size_t counterram = Memory();  // int overflows
+	size_t counterram = Memory_Ledger::Total();  // int overflows
 	struct sysinfo info;
 	sysinfo(&info);
 	double free_ratio = 1.0 * info.freeram / info.totalram;
-	static unsigned exhausted = 0.4;
+	const double exhausted = 0.4;
 	if ( counterram > exhausted * info.freeram && free_ratio <= 0.1 ) {
 		return true;
 	}
@@ -17,11 +17,13 @@ protected:
 	unsigned _num_rsl_stack;  // recording the number of temporary results
 	Component_Cache<BigFloat> _component_cache;
 	vector<Literal> _equivalent_lit_pairs;
+	Statistics_Snapshots _stats_snapshots;
 public:
 	WCounter();
 	~WCounter();
 	void Reset();
 	size_t Memory();
+	void Write_Statistics_JSON( JSON_Writer & writer );  // the statistics together with the cache metrics
 	void Set_Max_Var( Variable max_var ) { Allocate_and_Init_Auxiliary_Memory( max_var ); }
 protected:
 	void Allocate_and_Init_Auxiliary_Memory( Variable max_var );
@@ -127,6 +129,13 @@ public:
 		counter.running_options.static_heur = parameters.static_heur;
 		counter.running_options.max_memory = parameters.memo;
 		counter.running_options.clear_half_of_cache = parameters.clear_half;
+		counter.running_options.evict_cache = parameters.evict_cache;
+		counter.running_options.treed_time_budget = parameters.treed_time;
+		if ( parameters.threads.Exists() ) {
+			counter.running_options.minfill_num_threads = parameters.threads;
+			counter.running_options.treed_num_threads = parameters.threads;
+			counter.running_options.lit_equivalence_num_threads = parameters.threads;
+		}
 		Heuristic heur = Parse_Heuristic( parameters.heur );
 		if ( quiet ) {
 			counter.running_options.profile_solving = Profiling_Close;
@@ -134,6 +143,9 @@ public:
 			counter.running_options.profile_counting = Profiling_Close;
 		}
 		if ( parameters.competition ) counter.running_options.display_prefix = "c o ";
+		counter.running_options.stats_json_file = parameters.stats_json;
+		counter.running_options.stats_interval = parameters.stats_interval;
+		counter.Set_Budget( parameters );
 		if ( !parameters.condition.Exists() ) {
 			ifstream fin( infile );
 			WCNF_Formula cnf( fin, parameters.format );
@@ -145,8 +157,12 @@ public:
 				count = cnf.Known_Count();
 			}
 			else count = counter.Count_Models( cnf, heur );
-			cout << counter.running_options.display_prefix << "Weighted model count: " << count << endl;
-			if ( parameters.competition ) {  // for model counting competition
+			if ( counter.budget.Interrupted() ) {
+				cout << counter.running_options.display_prefix << "Weighted model count: unknown (" << Run_Status_Name( counter.budget.Status() ) << ")" << endl;
+				if ( parameters.competition ) cout << "s UNKNOWN" << endl;
+			}
+			else cout << counter.running_options.display_prefix << "Weighted model count: " << count << endl;
+			if ( parameters.competition && !counter.budget.Interrupted() ) {  // for model counting competition
 				cout << "c s type wmc" << endl;
 				cout << "c o This file describes that the weighted model count is " << count << endl;
 				cout << "c o " << endl;
@@ -165,6 +181,7 @@ public:
 			Read_Assignments( fin_cond, terms );
 			fin_cond.close();
 			vector<BigFloat> counts( terms.size() );
+			unsigned num_known = terms.size();  // the counts from the interrupted one on are unknown
 			for ( unsigned i = 0; i < terms.size(); i++ ) {
 				ifstream fin( infile );
 				WCNF_Formula cnf( fin );
@@ -172,11 +189,19 @@ public:
 				cnf.Condition( terms[i] );
 				if ( cnf.Max_Var() == Variable::undef ) counts[i] = cnf.Known_Count();
 				else counts[i] = counter.Count_Models( cnf, heur );
+				if ( counter.budget.Interrupted() ) {
+					num_known = i;
+					break;
+				}
 			}
 			for ( unsigned i = 0; i < counts.size(); i++ ) {
-				cout << counter.running_options.display_prefix << "Weighted model count: " << counts[i] << endl;
+				if ( i >= num_known ) {
+					cout << counter.running_options.display_prefix << "Weighted model count: unknown (" << Run_Status_Name( counter.budget.Status() ) << ")" << endl;
+				}
+				else cout << counter.running_options.display_prefix << "Weighted model count: " << counts[i] << endl;
 			}
 		}
+		if ( parameters.stats_json.Exists() ) Write_Statistics_File( counter, parameters.stats_json );
 	}
 };
 
@@ -50,6 +50,10 @@ void Extensive_Inprocessor::Free_Auxiliary_Memory()
 void Extensive_Inprocessor::Reset()
 {
 	Inprocessor::Reset();
+	for ( Variable i = Variable::start; i <= _max_var; i++ ) {  // left over when a search is terminated
+		_cached_binary_clauses[i + i].clear();
+		_cached_binary_clauses[i + i + 1].clear();
+	}
 }
 
 void Extensive_Inprocessor::Open_Oracle_Mode( Variable var_bound )
@@ -80,6 +84,7 @@ size_t Extensive_Inprocessor::Memory()
 
 void Extensive_Inprocessor::Get_All_Imp_Component( Component & comp, vector<Model *> & models )
 {
+	Trace_Scope trace( Trace_SAT_Imp );
 	StopWatch begin_watch;
 	Literal lit;
 	assert( !models.empty() );
@@ -134,7 +139,7 @@ void Extensive_Inprocessor::Filter_Long_Learnts()
 			_clause_stack[itr - begin] = i;
 			_long_clauses[i++] = *itr;
 		}
-		else if ( itr->Size() <= fixed_len ) _long_clauses[i++] = *itr;
+		else if ( Keep_Long_Learnt( *itr ) ) _long_clauses[i++] = *itr;
 		else {
 			if ( !SHIELD_OPTIMIZATION ) itr->Free();  // ToModify
 			else {
@@ -251,6 +256,7 @@ bool Extensive_Inprocessor::Estimate_Kernelization_Effect_Enough_Decisions( unsi
 
 void Extensive_Inprocessor::Kernelize_Without_Imp()
 {
+	Trace_Scope trace( Trace_Kernelize );
 	if ( DEBUG_OFF ) {
 		static unsigned num_visited = 0;  // ToRemove
 		if ( ++num_visited == 13 ) {
@@ -560,6 +566,7 @@ bool Extensive_Inprocessor::Detect_Lit_Equivalence_Component( Component & comp )
 
 bool Extensive_Inprocessor::Detect_Lit_Equivalence_Tarjan_Component( Component & comp )
 {
+	Generate_Implication_Graph( comp.VarIDs_Begin(), comp.VarIDs_End() );
 	for ( unsigned i = 0; i < comp.Vars_Size(); i++ ) {
 		Variable var = comp.Vars( i );
 		if ( _lit_search_state[var + var] != UNSIGNED_UNDEF || _lit_search_state[var + var + 1] != UNSIGNED_UNDEF ) continue;
@@ -571,6 +578,7 @@ bool Extensive_Inprocessor::Detect_Lit_Equivalence_Tarjan_Component( Component &
 		_lit_search_state[var + var] = UNSIGNED_UNDEF;
 		_lit_search_state[var + var + 1] = UNSIGNED_UNDEF;
 	}
+	Clear_Implication_Graph( comp.VarIDs_Begin(), comp.VarIDs_End() );
 	unsigned old_fixed_num_vars = _fixed_num_vars;
 	Cluster_Equivalent_Lits_Component( comp );  // _fixed_num_vars will change in the function
 	return old_fixed_num_vars < _fixed_num_vars;
@@ -591,15 +599,17 @@ void Extensive_Inprocessor::Cluster_Equivalent_Lits_Component( Component & comp
 			_lit_equivalences[var + var + 1] = ~root;
 		}
 		if ( _lit_equivalences[var + var] != var + var ) {  // NOTE: lit may be changed, so we need to use _lit_equivalences[i + i]
-			unsigned j;
-			for ( j = 0; _lit_equivalences[var + var] != _equivalent_lit_sets[j][0]; j++ ) {}  // find the old entry
+			unsigned j = _lit_index[_lit_equivalences[var + var]];  // find the old entry
+			assert( _lit_equivalences[var + var] == _equivalent_lit_sets[j][0] );
 			_equivalent_lit_sets[j].push_back( Literal( var, false ) );
 			_equivalent_lit_sets[j ^ 0x01].push_back( Literal( var, true ) );
 			_fixed_num_vars++;
 		}
 		else {  // create new entries
+			_lit_index[var + var] = _equivalent_lit_cluster_size;  /// NOTE: _lit_index records the entries of roots
 			singleton[0] = Literal( var, false );
 			_equivalent_lit_sets[_equivalent_lit_cluster_size++] = singleton;
+			_lit_index[var + var + 1] = _equivalent_lit_cluster_size;
 			singleton[0] = Literal( var, true );
 			_equivalent_lit_sets[_equivalent_lit_cluster_size++] = singleton;
 		}
@@ -960,6 +970,7 @@ void Extensive_Inprocessor::Clear_Membership_Lists_Subdivision_Binary_Component(
 
 void Extensive_Inprocessor::Cancel_Kernelization_Without_Imp()
 {
+	Trace_Scope trace( Trace_Kernelize );
 	StopWatch begin_watch;
 	if ( running_options.profiling_ext_inprocessing >= Profiling_Abstract ) begin_watch.Start();
 	_call_stack[_num_levels - 1].Clear_Lit_Equivalences();
@@ -46,6 +46,8 @@ void Inprocessor::Allocate_and_Init_Auxiliary_Memory( Variable max_var )  // ToD
 	_comp_offsets = new unsigned [2 * max_var + 2];
 	_active_comps = new unsigned [2 * max_var + 2];  // recording the current component which is being compiled
 	_state_stack = new unsigned [2 * max_var + 2];
+	_var_parents = new unsigned [max_var + 2];
+	_var_comp_ids = new unsigned [max_var + 2];
 	_var_projected.assign( max_var + 2, false );
 }
 
@@ -63,11 +65,14 @@ void Inprocessor::Free_Auxiliary_Memory()
 	delete [] _comp_offsets;
 	delete [] _active_comps;
 	delete [] _state_stack;
+	delete [] _var_parents;
+	delete [] _var_comp_ids;
 }
 
 void Inprocessor::Reset()
 {
 	Preprocessor::Reset();
+	running_options.treewidth = UNSIGNED_UNDEF;  // measured again for the next instance
 	for ( Variable i = Variable::start; i <= _max_var; i++ ) {
 		_binary_var_membership_lists[i].clear();
 		_ternary_var_membership_lists[i].clear();
@@ -137,24 +142,22 @@ size_t Inprocessor::Memory()
 	return mem;
 }
 
+size_t Inprocessor::Fitted_Table_Size() const
+{
+	unsigned treewidth = running_options.treewidth;
+	if ( Is_TreeD_Based_Ordering( running_options.var_ordering_heur ) != lbool(true) ) treewidth = UNSIGNED_UNDEF;  // unknown, or too wide to decompose
+	return Fit_Hash_Table_Size( _unsimplifiable_num_vars, _old_num_long_clauses, treewidth, running_options.max_memory );
+}
+
 void Inprocessor::Compute_Var_Order_Min_Fill_Heuristic_Bound( unsigned bound )
 {
 	StopWatch begin_watch;
 	if ( running_options.profiling_inprocessing >= Profiling_Detail ) begin_watch.Start();
-	Greedy_Graph * pg = Create_Primal_Graph();
-	if ( _unsimplifiable_num_vars == _max_var ) {
-		Simple_TreeD treed( *pg, bound );
-		running_options.treewidth = treed.Width();
-		if ( running_options.treewidth <= bound ) {
-			Generate_Var_Order_From_TreeD( treed );
-		}
-	}
-	else {
-		Simple_TreeD treed( *pg, bound, true );  /// optimized for large-scale problems
-		running_options.treewidth = treed.Width();
-		if ( running_options.treewidth <= bound ) {
-			Generate_Var_Order_From_TreeD( treed );
-		}
+	Min_Fill_Graph * pg = Create_Primal_Graph();
+	Simple_TreeD treed( *pg, bound );
+	running_options.treewidth = treed.Width();
+	if ( running_options.treewidth <= bound ) {
+		Generate_Var_Order_From_TreeD( treed );
 	}
 	delete pg;
 	if ( running_options.profiling_inprocessing >= Profiling_Detail ) statistics.time_tree_decomposition = begin_watch.Get_Elapsed_Seconds();
@@ -162,9 +165,10 @@ void Inprocessor::Compute_Var_Order_Min_Fill_Heuristic_Bound( unsigned bound )
 
 void Inprocessor::Compute_Var_Order_Min_Fill_Heuristic_Opt()
 {
+	Trace_Scope trace( Trace_Var_Order );
 	StopWatch begin_watch;
 	if ( running_options.profiling_inprocessing >= Profiling_Detail ) begin_watch.Start();
-	Greedy_Graph * pg = Create_Primal_Graph();
+	Min_Fill_Graph * pg = Create_Primal_Graph();
 	Simple_TreeD treed( *pg );
 	running_options.treewidth = treed.Width();
 	Generate_Var_Order_From_TreeD( treed );
@@ -172,7 +176,7 @@ void Inprocessor::Compute_Var_Order_Min_Fill_Heuristic_Opt()
 	if ( running_options.profiling_inprocessing >= Profiling_Detail ) statistics.time_tree_decomposition = begin_watch.Get_Elapsed_Seconds();
 }
 
-Greedy_Graph * Inprocessor::Create_Primal_Graph()
+Min_Fill_Graph * Inprocessor::Create_Primal_Graph()
 {
 	if ( running_options.decompose_strategy == Decompose_With_Sorting ) {
 		return Create_Primal_Graph_With_Sorting();
@@ -182,7 +186,7 @@ Greedy_Graph * Inprocessor::Create_Primal_Graph()
 	}
 }
 
-Greedy_Graph * Inprocessor::Create_Primal_Graph_With_Sorting()
+Min_Fill_Graph * Inprocessor::Create_Primal_Graph_With_Sorting()
 {
 	unsigned i, j, size;
 	unsigned * vertices = new unsigned [_max_var - Variable::start + 1];
@@ -224,10 +228,10 @@ Greedy_Graph * Inprocessor::Create_Primal_Graph_With_Sorting()
 		}
 	}
 	delete [] vertices;
-	return new Greedy_Graph( _max_var, edges );
+	return new Min_Fill_Graph( _max_var, edges, false, running_options.minfill_num_threads );
 }
 
-Greedy_Graph * Inprocessor::Create_Primal_Graph_Without_Sorting()
+Min_Fill_Graph * Inprocessor::Create_Primal_Graph_Without_Sorting()
 {
 	unsigned * vertices = new unsigned [_max_var - Variable::start + 1];
 	vector<vector<unsigned>> edges( _max_var + 1 );
@@ -290,7 +294,7 @@ Greedy_Graph * Inprocessor::Create_Primal_Graph_Without_Sorting()
 		}
 	}
 	delete [] vertices;
-	return new Greedy_Graph( _max_var, edges );
+	return new Min_Fill_Graph( _max_var, edges, false, running_options.minfill_num_threads );
 }
 
 void Inprocessor::Var_Weight_For_Tree_Decomposition( double * var_weight )
@@ -420,21 +424,16 @@ void Inprocessor::Generate_Var_Order_From_TreeD( Simple_TreeD & treed, double *
 
 void Inprocessor::Compute_Var_Order_Flow_Cutter()
 {
+	Trace_Scope trace( Trace_Var_Order );
 	StopWatch begin_watch;
 	if ( running_options.profiling_inprocessing >= Profiling_Detail ) begin_watch.Start();
-	const char * graph_file = "solvers/flow_cutter_pace17-input.txt";
-	const char * solver_file = "solvers/flow_cutter_pace17";
-	const char * treed_file = "solvers/flow_cutter_pace17-output.txt";
-	Greedy_Graph * pg = Create_Primal_Graph();
-	ofstream fout( graph_file );
-	pg->Display_PACE( fout );
-	fout.close();
-	string cmd = string("timeout ") + "120s " + solver_file + " " + graph_file + " > " + treed_file + " 2>/dev/null";
-	int status = system(cmd.c_str());
-	assert(status >= 0);
-	ifstream fin( treed_file );
-	Simple_TreeD treed( fin );
-	treed.Verify( *pg );
+	Min_Fill_Graph * pg = Create_Primal_Graph();
+	Anytime_TreeD searcher( *pg );
+	searcher.Search( running_options.treed_time_budget, running_options.treed_num_threads, running_options.treed_stall_rounds, 0 );
+	if ( running_options.display_inprocessing_process ) {
+		cout << running_options.display_prefix << "The anytime tree decomposition: width " << searcher.Width() << " (lower bound " << searcher.Lower_Bound() << ") after " << searcher.Num_Rounds() << " rounds" << endl;
+	}
+	Simple_TreeD treed( *pg, searcher.Elimination_Order() );
 	running_options.treewidth = treed.Width();
 	Generate_Var_Order_From_TreeD( treed );
 	delete pg;
@@ -536,22 +535,12 @@ void Inprocessor::Compute_Dynamic_Min_Fill_Bound( unsigned bound )
 {
 	StopWatch begin_watch;
 	if ( running_options.profiling_inprocessing >= Profiling_Detail ) begin_watch.Start();
-	Greedy_Graph * pg = Create_Primal_Graph();
-	if ( _unsimplifiable_num_vars == _max_var ) {
-		Simple_TreeD treed( *pg, bound );
-		running_options.treewidth = treed.Width();
-		if ( running_options.treewidth <= bound ) {
-			Var_Weight_For_Tree_Decomposition( _var_scores );
-			treed.Compute_DTree_Scores( _var_scores );
-		}
-	}
-	else {
-		Simple_TreeD treed( *pg, bound, true );  /// optimized for large-scale problems
-		running_options.treewidth = treed.Width();
-		if ( running_options.treewidth <= bound ) {
-			Var_Weight_For_Tree_Decomposition( _var_scores );
-			treed.Compute_DTree_Scores( _var_scores );
-		}
+	Min_Fill_Graph * pg = Create_Primal_Graph();
+	Simple_TreeD treed( *pg, bound );
+	running_options.treewidth = treed.Width();
+	if ( running_options.treewidth <= bound ) {
+		Var_Weight_For_Tree_Decomposition( _var_scores );
+		treed.Compute_DTree_Scores( _var_scores );
 	}
 	delete pg;
 	if ( running_options.profiling_inprocessing >= Profiling_Detail ) statistics.time_tree_decomposition = begin_watch.Get_Elapsed_Seconds();
@@ -562,8 +551,8 @@ unsigned Inprocessor::Compute_Var_Order_Min_Fill_Bound_Component( Component & co
 	StopWatch begin_watch;
 	if ( running_options.profiling_inprocessing >= Profiling_Detail ) begin_watch.Start();
 	double * var_weight = new double [_max_var + 1];
-	Greedy_Graph * pg = Create_Weighted_Primal_Graph_Component( comp, var_weight );
-	Simple_TreeD treed( *pg, bound, true );  /// optimized for large-scale problems
+	Min_Fill_Graph * pg = Create_Weighted_Primal_Graph_Component( comp, var_weight );
+	Simple_TreeD treed( *pg, bound );
 	unsigned treewidth = treed.Width();
 	if ( treewidth <= bound ) {
 		assert( _var_order.Empty() );
@@ -575,7 +564,7 @@ unsigned Inprocessor::Compute_Var_Order_Min_Fill_Bound_Component( Component & co
 	return treewidth;
 }
 
-Greedy_Graph * Inprocessor::Create_Weighted_Primal_Graph_Component( Component & comp, double * var_weight )
+Min_Fill_Graph * Inprocessor::Create_Weighted_Primal_Graph_Component( Component & comp, double * var_weight )
 {
 	vector<vector<unsigned>> edges( comp.Vars_Size() );
 	vector<double> scores( 2 * comp.Vars_Size(), 0 );
@@ -660,7 +649,7 @@ Greedy_Graph * Inprocessor::Create_Weighted_Primal_Graph_Component( Component &
 		}
 		var_weight[i] = scores[i + i] * scores[i + i + 1];
 	}
-	return new Greedy_Graph( comp.Vars_Size() - 1, edges );
+	return new Min_Fill_Graph( comp.Vars_Size() - 1, edges, false, running_options.minfill_num_threads );
 }
 
 void Inprocessor::Generate_Var_Order_Min_Fill_Component( Component & comp, Simple_TreeD & treed, double * var_weight )
@@ -1077,6 +1066,7 @@ unsigned Inprocessor::Analyze_Conflict_Decision( Reason confl )  // NOTE: return
 	if ( confl.Is_Clause_Reason() ) {
 		Clause & clause = _long_clauses[confl.Clause_Value()];
 		assert( _big_learnt[0] == clause[0] );
+		clause.Mark_Used();
 		var = clause[1].Var();
 		_var_seen[var] = true;
 		_big_learnt[1] = clause[1];
@@ -1109,6 +1099,7 @@ unsigned Inprocessor::Analyze_Conflict_Decision( Reason confl )  // NOTE: return
 		if ( confl.Is_Clause_Reason() ) {
 			Clause & clause = _long_clauses[confl.Clause_Value()];
 			assert( uip == clause[0] );
+			clause.Mark_Used();
 			var = clause[1].Var();
 			if ( !_var_seen[var] ) {
 				_var_seen[var] = true;
@@ -1209,6 +1200,7 @@ Reason Inprocessor::Add_Learnt()
 		_long_watched_lists[_big_learnt[1]].push_back( _long_clauses.size() );
 		reason = Reason( _long_clauses.size(), SAT_REASON_CLAUSE );
 		_long_clauses.push_back( Clause( _big_learnt ) );  // allocate memory
+		Init_Learnt_Scores( _long_clauses.back() );
 	}
 /*	for ( unsigned i = 0; i < _big_learnt.Size(); i++ ) {
 		assert( _big_learnt[i] <= 2 * _max_var + 1 );
@@ -1228,6 +1220,7 @@ Reason Inprocessor::Add_Learnt()
 
 Reason Inprocessor::Get_Approx_Imp_Component( Component & comp, unsigned & backjump_level )
 {
+	Trace_Scope trace( Trace_IBCP );
 	StopWatch tmp_watch;
 	if ( running_options.profile_compiling >= Profiling_Abstract ) tmp_watch.Start();
 	Reason confl;
@@ -1356,6 +1349,7 @@ unsigned Inprocessor::Analyze_Conflict_Fixed_UIP( Reason confl, Literal fixed )
 	if ( confl.Is_Clause_Reason() ) {
 		Clause & clause = _long_clauses[confl.Clause_Value()];
 		assert( _big_learnt[1] == clause[0] );
+		clause.Mark_Used();
 		var = clause[1].Var();
 		_var_seen[var] = true;
 		if ( _var_stamps[var] + 1 != _num_levels ) _big_learnt.Add_Lit( clause[1] );
@@ -1382,6 +1376,7 @@ unsigned Inprocessor::Analyze_Conflict_Fixed_UIP( Reason confl, Literal fixed )
 		if ( confl.Is_Clause_Reason() ) {
 			Clause & clause = _long_clauses[confl.Clause_Value()];
 			assert( uip == clause[0] );
+			clause.Mark_Used();
 			var = clause[1].Var();
 			if ( !_var_seen[var] ) {
 				_var_seen[var] = true;
@@ -1594,6 +1589,7 @@ Reason Inprocessor::Get_Approx_Imp_Component_Partial_IBCP_Neg( Component & comp
 
 unsigned Inprocessor::Dynamic_Decompose_Component( Component & source, Component smaller_comps[] )
 {
+	Trace_Scope trace( Trace_Decompose );
 	switch ( running_options.decompose_strategy ) {
 	case Decompose_With_Sorting:
 		return Dynamic_Decompose_Component_With_Sorting( source, smaller_comps );
@@ -1687,54 +1683,63 @@ void Inprocessor::Add_Var_Neighbors_In_Beyond_2_Clauses( Variable var, Component
 
 unsigned Inprocessor::Dynamic_Decompose_Component_Without_Sorting( Component & source, Component smaller_comps[] )
 {
+	/* NOTE:
+	* The undecided variables are merged by union-find along the active clauses, and then one pass over the sorted
+	* variables and one over the sorted clauses distribute them to components, which are sorted without sorting
+	*/
 	StopWatch begin_watch;
 	if ( running_options.profiling_inprocessing >= Profiling_Detail ) begin_watch.Start();
-	unsigned num_vars, num_cls;
+	unsigned i, num_vars, num_cls;
 	Filter_Vars_Clauses_In_Component( source, num_vars, num_cls );
 	unsigned * vars = _var_rank;  // _var_rank record the undecided variables and _clause_stack record the active clauses
+	for ( i = 0; i < num_vars; i++ ) {
+		_var_parents[vars[i]] = vars[i];
+		_var_comp_ids[vars[i]] = 0;
+	}
+	for ( i = 0; i < num_vars; i++ ) {
+		vector<Variable>::iterator itr = _binary_var_membership_lists[vars[i]].begin();
+		vector<Variable>::iterator end = _binary_var_membership_lists[vars[i]].end();
+		for ( ; itr < end; itr++ ) {
+			if ( *itr > vars[i] && Var_Undecided( *itr ) ) Union_Vars( vars[i], *itr );
+		}
+	}
+	for ( i = 0; i < num_cls; i++ ) {
+		Clause & clause = _long_clauses[_clause_stack[i]];
+		unsigned k;
+		for ( k = 0; !Lit_Undecided( clause[k] ); k++ ) {}
+		Variable first = clause[k].Var();
+		for ( k++; k < clause.Size(); k++ ) {
+			if ( Lit_Undecided( clause[k] ) ) Union_Vars( first, clause[k].Var() );
+		}
+	}
+	for ( i = 0; i < num_vars; i++ ) {
+		_var_parents[vars[i]] = Find_Var_Root( vars[i] );
+		_var_comp_ids[_var_parents[vars[i]]]++;
+	}
 	Component * comp = smaller_comps;
-	while ( num_vars > 0 ) {
-		comp->Clear();  // NOTE: comp is initialized here
-		comp->Add_Var( Variable( vars[0] ) );
-		_var_seen[vars[0]] = true;
-		unsigned i = 0;
-		do {
-			Variable var = comp->Vars(i);
-			Add_Var_Neighbors_In_Binary_Clauses( var, *comp );
-			Add_Var_Neighbors_In_Ternary_Clauses( var, *comp );
-			Add_Var_Neighbors_In_Quaternary_Clauses( var, *comp );
-			Add_Var_Neighbors_In_Beyond_4_Clauses( var, *comp );
-		} while ( ++i < comp->Vars_Size() );
-		_var_seen[vars[0]] = false;
-		vars++, num_vars--;
-		if ( comp->Vars_Size() == 1 ) continue;
-		comp->Vars_Resize( 1 );
-		unsigned num_rest;
-		for ( i = num_rest = 0; i < num_vars; i++ ) {
-			unsigned var = vars[i];
-			if ( _var_seen[var] ) {
-				comp->Add_Var( Variable( var ) );
-				_var_seen[var] = false;
-			}
-			else vars[num_rest++] = vars[i];
-		}
-		num_vars = num_rest;
-		for ( i = num_rest = 0; i < num_cls; i++ ) {
-			unsigned cl = _clause_stack[i];
-			if ( _clause_status[cl] == 2 ) {  // was selected
-				comp->Add_ClauseID( cl );
-				_clause_status[cl] = 0;  // reset
-			}
-			else _clause_stack[num_rest++] = _clause_stack[i];
-		}
-		num_cls = num_rest;
-		comp->Add_Var( _max_var.Next() );  /// NOTE: prevent comp.Vars() from reallocating memory when push_back mar_var + 1 later
-		comp->Dec_Var();  /// pop _max_var.Next()
-		ASSERT( comp->Vars_Size() >= 2 );
-		comp++;
+	for ( i = 0; i < num_vars; i++ ) {  /// the components are ordered by their minimum variables
+		unsigned root = _var_parents[vars[i]];
+		if ( root == vars[i] ) {
+			if ( _var_comp_ids[root] == 1 ) continue;  // isolated
+			_var_comp_ids[root] = comp - smaller_comps;
+			comp->Clear();  // NOTE: comp is initialized here
+			comp++;
+		}
+		smaller_comps[_var_comp_ids[root]].Add_Var( Variable( vars[i] ) );
+	}
+	for ( i = 0; i < num_cls; i++ ) {
+		Clause & clause = _long_clauses[_clause_stack[i]];
+		unsigned k;
+		for ( k = 0; !Lit_Undecided( clause[k] ); k++ ) {}
+		smaller_comps[_var_comp_ids[_var_parents[clause[k].Var()]]].Add_ClauseID( _clause_stack[i] );
+		_clause_status[_clause_stack[i]] = 0;  // reset
 	}
-	for ( unsigned i = 0; DEBUG_OFF && i < _old_num_long_clauses; i++ ) ASSERT( _clause_status[i] == 0 );  // ToRemove
-	for ( Variable i = Variable::start; DEBUG_OFF && i <= _max_var; i++ ) ASSERT( !_var_seen[i] );  // ToRemove
+	for ( Component * comp_i = smaller_comps; comp_i < comp; comp_i++ ) {
+		comp_i->Add_Var( _max_var.Next() );  /// NOTE: prevent comp.Vars() from reallocating memory when push_back mar_var + 1 later
+		comp_i->Dec_Var();  /// pop _max_var.Next()
+		ASSERT( comp_i->Vars_Size() >= 2 );
+	}
+	for ( i = 0; DEBUG_OFF && i < _old_num_long_clauses; i++ ) ASSERT( _clause_status[i] == 0 );  // ToRemove
 	_clause_stack.clear();
 	if ( running_options.imp_strategy != SAT_Imp_Computing ) {
 		for ( Component * comp_i = smaller_comps; comp_i < comp - 1; comp_i++ ) {  // when backjump happens, reduce compilation
@@ -1771,75 +1776,6 @@ void Inprocessor::Filter_Vars_Clauses_In_Component( Component & source, unsigned
 	}
 }
 
-void Inprocessor::Add_Var_Neighbors_In_Ternary_Clauses( Variable var, Component & target )
-{
-	vector<unsigned>::iterator itr = _ternary_var_membership_lists[var].begin();
-	vector<unsigned>::iterator end = _ternary_var_membership_lists[var].end();
-	for ( ; itr < end; itr += 3 ) {
-		if ( _clause_status[*itr] != 1 ) continue;  // satisfied or selected
-		_clause_status[*itr] = 2;  // mark it as selected
-		unsigned var = *(itr + 1);
-		if ( Var_Undecided( Variable( var ) ) && !_var_seen[var] ) {  /// NOTE: prevent the edges from var to outside of the current component
-			target.Add_Var( Variable( var ) );
-			_var_seen[var] = true;
-		}
-		var = *(itr + 2);
-		if ( Var_Undecided( Variable( var ) ) && !_var_seen[var] ) {
-			target.Add_Var( Variable( var ) );
-			_var_seen[var] = true;
-		}
-	}
-}
-
-void Inprocessor::Add_Var_Neighbors_In_Quaternary_Clauses( Variable var, Component & target )
-{
-	vector<unsigned>::iterator itr = _quaternary_var_membership_lists[var].begin();
-	vector<unsigned>::iterator end = _quaternary_var_membership_lists[var].end();
-	for ( ; itr < end; itr += 4 ) {
-		if ( _clause_status[*itr] != 1 ) continue;  /// NOTE: prevent the edges from var to outside of the current component
-		_clause_status[*itr] = 2;  // mark it as selected
-		unsigned var = *(itr + 1);
-		if ( Var_Undecided( Variable( var ) ) && !_var_seen[var] ) {
-			target.Add_Var( Variable( var ) );
-			_var_seen[var] = true;
-		}
-		var = *(itr + 2);
-		if ( Var_Undecided( Variable( var ) ) && !_var_seen[var] ) {
-			target.Add_Var( Variable( var ) );
-			_var_seen[var] = true;
-		}
-		var = *(itr + 3);
-		if ( Var_Undecided( Variable( var ) ) && !_var_seen[var] ) {
-			target.Add_Var( Variable( var ) );
-			_var_seen[var] = true;
-		}
-	}
-}
-
-void Inprocessor::Add_Var_Neighbors_In_Beyond_4_Clauses( Variable var, Component & target )
-{
-	vector<unsigned>::iterator itr = _long_var_membership_lists[var].begin();
-	vector<unsigned>::iterator end = _long_var_membership_lists[var].end();
-	for ( ; itr < end; itr++ ) {
-		if ( _clause_status[*itr] != 1 ) continue;  // satisfied or selected
-		_clause_status[*itr] = 2;  // mark it as selected
-		Clause & clause = _long_clauses[*itr];
-		unsigned k;
-		for ( k = 0; clause[k].Var() != var; k++ ) {
-			if ( Lit_Undecided( clause[k] ) && !_var_seen[clause[k].Var()] ) {
-				target.Add_Var( clause[k].Var() );
-				_var_seen[clause[k].Var()] = true;
-			}
-		}
-		for ( k++; k < clause.Size(); k++ ) {
-			if ( Lit_Undecided( clause[k] ) && !_var_seen[clause[k].Var()] ) {
-				target.Add_Var( clause[k].Var() );
-				_var_seen[clause[k].Var()] = true;
-			}
-		}
-	}
-}
-
 bool Inprocessor::Generate_Current_Component( Component & parent, Component & current )
 {
 	current.Clear();
@@ -2710,6 +2646,7 @@ void Inprocessor::Get_All_Imp_Component_SAT( Component & comp, vector<Model *> &
 
 void Inprocessor::Get_All_Imp_Component( Component & comp, vector<Model *> & models )
 {
+	Trace_Scope trace( Trace_SAT_Imp );
 	StopWatch begin_watch;
 	Literal lit;
 	assert( !models.empty() );
@@ -2834,7 +2771,7 @@ void Inprocessor::Filter_Long_Learnts()
 			_clause_stack[itr - begin] = i;
 			_long_clauses[i++] = *itr;
 		}
-		else if ( itr->Size() <= fixed_len ) _long_clauses[i++] = *itr;
+		else if ( Keep_Long_Learnt( *itr ) ) _long_clauses[i++] = *itr;
 		else {
 			if ( !SHIELD_OPTIMIZATION ) itr->Free();  // ToModify
 			else {
@@ -2990,6 +2927,7 @@ void Inprocessor::Add_Marked_Model_Component( Component & comp, vector<Model *>
 
 void Inprocessor::Get_All_Imp_Component_External( Component & comp, vector<Model *> & models )
 {
+	Trace_Scope trace( Trace_SAT_Imp );
 	StopWatch begin_watch;
 	assert( !models.empty() );
 	if ( running_options.profiling_inprocessing >= Profiling_Detail ) begin_watch.Start();
@@ -4,6 +4,7 @@
 #include "Preprocessor.h"
 #include "Primitive_Types/Lit_Equivalency.h"
 #include "Component_Types/Component_Cache.h"
+#include "Template_Library/Tracer.h"
 
 
 namespace KCBox {
@@ -29,6 +30,8 @@ protected:
 	unsigned * _comp_offsets;  // recording decomposing status (+1 is decision), and the level i of components ranges from comp_point[i] to comp_point[i + 1]
 	unsigned * _active_comps;  // recording the current component which is being compiled
 	unsigned * _state_stack; // recording the state of the active component, for decision level, 0: prepare; 1: false; 2: true; 3: backtrack
+	unsigned * _var_parents;  // the union-find forest in dynamic decomposition
+	unsigned * _var_comp_ids;  // the size of each root in dynamic decomposition, and then its component
 	Lit_Equivalency _lit_equivalency;
 public:
 	Inprocessor();
@@ -50,12 +53,13 @@ protected:
 	bool Var_Appeared( Variable var ) const;  // omit unary clauses and literal equivalences
 	unsigned Num_Var_Appearances( Variable var ) const;  // omit unary clauses and literal equivalences
 	unsigned Num_Omitted_Vars() const { return NumVars( _max_var ) - _unsimplifiable_num_vars - _fixed_num_vars; }
+	size_t Fitted_Table_Size() const;  // the initial entries of the component cache and the node table for the current instance
 protected:  /// Var Heuristic
 	void Compute_Var_Order_Min_Fill_Heuristic_Bound( unsigned bound );
 	void Compute_Var_Order_Min_Fill_Heuristic_Opt();
-	Greedy_Graph * Create_Primal_Graph();
-	Greedy_Graph * Create_Primal_Graph_With_Sorting();
-	Greedy_Graph * Create_Primal_Graph_Without_Sorting();
+	Min_Fill_Graph * Create_Primal_Graph();
+	Min_Fill_Graph * Create_Primal_Graph_With_Sorting();
+	Min_Fill_Graph * Create_Primal_Graph_Without_Sorting();
 	void Var_Weight_For_Tree_Decomposition( double * var_weight );
 	void Var_Weight_For_Tree_Decomposition_With_Sorting( double * var_weight );
 	void Var_Weight_For_Tree_Decomposition_Without_Sorting( double * var_weight );
@@ -80,7 +84,7 @@ protected:  /// Var Heuristic
 	Variable Pick_Good_Projected_Var_Linearly_Component( Component & comp );
 	void Rename_Clauses_Fixed_Ordering();
 	unsigned Compute_Var_Order_Min_Fill_Bound_Component( Component & comp, unsigned bound );
-	Greedy_Graph * Create_Weighted_Primal_Graph_Component( Component & comp, double * var_weight );
+	Min_Fill_Graph * Create_Weighted_Primal_Graph_Component( Component & comp, double * var_weight );
 	void Generate_Var_Order_Min_Fill_Component( Component & comp, Simple_TreeD & treed, double * var_weight );
 protected:  /// Lit Heuristic
 	Literal Pick_Good_Lit_Component( Component & comp );
@@ -159,9 +163,21 @@ protected:  /// manage components
 	void Add_Var_Neighbors_In_Beyond_2_Clauses( Variable var, Component & target );
 	unsigned Dynamic_Decompose_Component_Without_Sorting( Component & source, Component smaller_comps[] );
 	void Filter_Vars_Clauses_In_Component( Component & source, unsigned & num_vars, unsigned & num_cls );  // use var_rank and clause_stack to record
-	void Add_Var_Neighbors_In_Ternary_Clauses( Variable var, Component & target );
-	void Add_Var_Neighbors_In_Quaternary_Clauses( Variable var, Component & target );
-	void Add_Var_Neighbors_In_Beyond_4_Clauses( Variable var, Component & target );
+	unsigned Find_Var_Root( unsigned var )
+	{
+		while ( _var_parents[var] != var ) {
+			_var_parents[var] = _var_parents[_var_parents[var]];  // path halving
+			var = _var_parents[var];
+		}
+		return var;
+	}
+	void Union_Vars( unsigned var, unsigned other )
+	{
+		var = Find_Var_Root( var );
+		other = Find_Var_Root( other );
+		if ( var < other ) _var_parents[other] = var;
+		else _var_parents[var] = other;
+	}
 	bool Generate_Current_Component( Component & parent, Component & current );
 	CNF_Formula * Output_Original_Clauses_In_Component( Component & comp );
 	CNF_Formula * Output_Original_And_Learnt_Clauses_In_Component( Component & comp );
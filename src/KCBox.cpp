@@ -0,0 +1,220 @@
+#include "KCBox.h"
+#include "Counters/KCounter.h"
+#include "Compilers/CCDD_Compiler.h"
+
+
+namespace KCBox {
+
+
+using namespace std;
+
+
+Model_Counter::Model_Counter()
+{
+	Counter_Parameters parameters( "ExactMC" );
+	Init( parameters );
+}
+
+Model_Counter::Model_Counter( Counter_Parameters & parameters )
+{
+	Init( parameters );
+}
+
+void Model_Counter::Init( Counter_Parameters & parameters )
+{
+	_counter = new KCounter;
+	_counter->Set_Running_Options( parameters, true );
+	_counter->running_options.display_counting_process = false;
+	_counter->running_options.display_preprocessing_process = false;
+	_counter->running_options.display_prefix = "";
+	_counter->running_options.checkpoint_file = nullptr;
+	_counter->running_options.stats_json_file = nullptr;
+	_heur = Parse_Heuristic( parameters.heur );
+}
+
+Model_Counter::~Model_Counter()
+{
+	delete _counter;
+}
+
+Running_Options & Model_Counter::Options()
+{
+	return _counter->running_options;
+}
+
+Count_Result Model_Counter::Count( CNF_Formula & cnf, const Run_Budget & budget )
+{
+	StopWatch watch;
+	watch.Start();
+	Count_Result result;
+	if ( cnf.Max_Var() == Variable::undef ) result.count = cnf.Known_Count();
+	else {
+		_counter->budget = budget;
+		result.count = _counter->Count_Models( cnf, _heur );
+		result.status = _counter->budget.Status();
+		if ( result.status != Run_Done ) result.count = 0;
+	}
+	result.seconds = watch.Get_Elapsed_Seconds();
+	return result;
+}
+
+size_t Model_Counter::Memory()
+{
+	return _counter->Memory();
+}
+
+Compiled_CCDD::Compiled_CCDD(): _manager( nullptr ), _ccdd( nullptr ), _status( Run_Done ), _known_count( 0 ), _seconds( 0 )
+{
+}
+
+Compiled_CCDD::Compiled_CCDD( Compiled_CCDD && other ): _manager( nullptr ), _ccdd( nullptr )
+{
+	*this = std::move( other );
+}
+
+Compiled_CCDD::~Compiled_CCDD()
+{
+	Free();
+}
+
+Compiled_CCDD & Compiled_CCDD::operator = ( Compiled_CCDD && other )
+{
+	if ( this == &other ) return *this;
+	Free();
+	_manager = other._manager;
+	_ccdd = other._ccdd;
+	_status = other._status;
+	_known_count = other._known_count;
+	_seconds = other._seconds;
+	other._manager = nullptr;
+	other._ccdd = nullptr;
+	return *this;
+}
+
+void Compiled_CCDD::Free()
+{
+	delete _ccdd;  /// NOTE: the diagram is detached from its manager before the manager is freed
+	delete _manager;
+	_ccdd = nullptr;
+	_manager = nullptr;
+}
+
+size_t Compiled_CCDD::Num_Nodes()
+{
+	assert( Done() );
+	if ( _manager == nullptr ) return 1;
+	return _manager->Num_Nodes( *_ccdd );
+}
+
+size_t Compiled_CCDD::Num_Edges()
+{
+	assert( Done() );
+	if ( _manager == nullptr ) return 0;
+	return _manager->Num_Edges( *_ccdd );
+}
+
+bool Compiled_CCDD::Decide_SAT( const vector<Literal> & assignment )
+{
+	assert( Done() );
+	if ( _manager == nullptr ) return _known_count != 0;
+	return _manager->Decide_SAT( *_ccdd, assignment );
+}
+
+BigInt Compiled_CCDD::Count_Models()
+{
+	assert( Done() );
+	if ( _manager == nullptr ) return _known_count;
+	return _manager->Count_Models( *_ccdd );
+}
+
+BigInt Compiled_CCDD::Count_Models( const vector<Literal> & assignment )
+{
+	assert( Done() );
+	if ( _manager == nullptr ) return _known_count;
+	return _manager->Count_Models( *_ccdd, assignment );
+}
+
+void Compiled_CCDD::Uniformly_Sample( Random_Generator & rand_gen, vector<vector<bool>> & samples )
+{
+	assert( Done() );
+	if ( _manager == nullptr ) {
+		for ( vector<bool> & sample: samples ) {
+			sample.clear();
+		}
+		return;
+	}
+	_manager->Uniformly_Sample( rand_gen, *_ccdd, samples );
+}
+
+void Compiled_CCDD::Write( ostream & out )
+{
+	assert( Done() );
+	if ( _manager != nullptr ) _manager->Display( out );
+}
+
+CCDD_Knowledge_Compiler::CCDD_Knowledge_Compiler()
+{
+	Compiler_Parameters parameters( "Panini" );
+	Init( parameters );
+}
+
+CCDD_Knowledge_Compiler::CCDD_Knowledge_Compiler( Compiler_Parameters & parameters )
+{
+	Init( parameters );
+}
+
+void CCDD_Knowledge_Compiler::Init( Compiler_Parameters & parameters )
+{
+	_compiler = new CCDD_Compiler;
+	_compiler->Set_Running_Options( parameters, true );
+	_compiler->running_options.display_compiling_process = false;
+	_compiler->running_options.display_preprocessing_process = false;
+	_compiler->running_options.display_counting_process = false;
+	_compiler->running_options.display_prefix = "";
+	_compiler->running_options.stats_json_file = nullptr;
+	_heur = Parse_Heuristic( parameters.heur );
+	if ( _heur != AutomaticalHeur && _heur != minfill && _heur != LinearLRW && _heur != DLCP && _heur != dynamic_minfill ) {
+		cerr << "Warning[CCDD_Knowledge_Compiler]: the heuristic is not supported yet, and the automatical one is used!" << endl;
+		_heur = AutomaticalHeur;
+	}
+}
+
+CCDD_Knowledge_Compiler::~CCDD_Knowledge_Compiler()
+{
+	delete _compiler;
+}
+
+Running_Options & CCDD_Knowledge_Compiler::Options()
+{
+	return _compiler->running_options;
+}
+
+Compiled_CCDD CCDD_Knowledge_Compiler::Compile( CNF_Formula & cnf, const Run_Budget & budget )
+{
+	/* NOTE:
+	* Each result owns a manager of its own, because the compiler reorders the variables of the manager
+	* for every formula, which would invalidate the diagrams compiled before
+	*/
+	StopWatch watch;
+	watch.Start();
+	Compiled_CCDD result;
+	if ( cnf.Max_Var() == Variable::undef ) result._known_count = cnf.Known_Count();
+	else {
+		_compiler->budget = budget;
+		float memory = _compiler->running_options.max_memory;
+		result._manager = new CCDD_Manager( cnf.Max_Var(), Fit_Hash_Table_Size( cnf.Num_Vars(), cnf.Num_Clauses(), 0, memory ) );
+		result._ccdd = new CDDiagram( _compiler->Compile( *result._manager, cnf, _heur ) );
+		result._status = _compiler->budget.Status();
+		if ( result._status != Run_Done ) result.Free();
+	}
+	result._seconds = watch.Get_Elapsed_Seconds();
+	return result;
+}
+
+size_t CCDD_Knowledge_Compiler::Memory()
+{
+	return _compiler->Memory();
+}
+
+
+}
@@ -0,0 +1,113 @@
+#ifndef _KCBox_h_
+#define _KCBox_h_
+
+#include "Parameters.h"
+#include "Primitive_Types/CNF_Formula.h"
+#include "Template_Library/Time_Memory.h"
+
+
+namespace KCBox {
+
+
+/****************************************************************************************************
+*                                                                                                   *
+*                                         Library interface                                         *
+*                                                                                                   *
+****************************************************************************************************/
+
+/* NOTE:
+* The engines behind this interface allocate their memory for the largest formula seen so far and keep it
+* between calls, so a service constructs them once and calls them repeatedly instead of running one process
+* per query. A call returns its result by value, and stops early when its budget is exhausted: the time and
+* memory limits and the cancellation flag are polled by the search loops, including the SAT search of preprocessing
+* and the R2-D2 phase of linear orderings, and the workers compiling root components in parallel share the budget.
+* The memory limit is checked against Memory_Ledger::Total, which covers all engines of the process.
+* An engine serves one call at a time; parallel calls need one engine each.
+*/
+
+class KCounter;
+class CCDD_Compiler;
+class CCDD_Manager;
+class CDDiagram;
+
+struct Count_Result
+{
+	Run_Status status;
+	BigInt count;  // valid only if status is Run_Done
+	double seconds;
+	Count_Result(): status( Run_Done ), count( 0 ), seconds( 0 ) {}
+};
+
+class Model_Counter  // ExactMC
+{
+protected:
+	KCounter * _counter;
+	Heuristic _heur;
+public:
+	Model_Counter();
+	Model_Counter( Counter_Parameters & parameters );  // the input and output options are ignored
+	~Model_Counter();
+	Running_Options & Options();
+	Count_Result Count( CNF_Formula & cnf, const Run_Budget & budget = Run_Budget() );  /// NOTE: cnf may be simplified
+	size_t Memory();
+protected:
+	void Init( Counter_Parameters & parameters );
+private:
+	Model_Counter( const Model_Counter & );
+	Model_Counter & operator = ( const Model_Counter & );
+};
+
+class Compiled_CCDD  // the result of one compilation, which owns the nodes of its diagram
+{
+	friend class CCDD_Knowledge_Compiler;
+protected:
+	CCDD_Manager * _manager;
+	CDDiagram * _ccdd;
+	Run_Status _status;
+	BigInt _known_count;  // used when the formula has no variables, and then there is no manager
+	double _seconds;
+public:
+	Compiled_CCDD();
+	Compiled_CCDD( Compiled_CCDD && other );
+	~Compiled_CCDD();
+	Compiled_CCDD & operator = ( Compiled_CCDD && other );
+	Run_Status Status() const { return _status; }
+	bool Done() const { return _status == Run_Done; }  /// NOTE: the following queries need a finished compilation
+	double Seconds() const { return _seconds; }
+	size_t Num_Nodes();
+	size_t Num_Edges();
+	bool Decide_SAT( const vector<Literal> & assignment );
+	BigInt Count_Models();
+	BigInt Count_Models( const vector<Literal> & assignment );
+	void Uniformly_Sample( Random_Generator & rand_gen, vector<vector<bool>> & samples );
+	void Write( ostream & out );  // in the format of Panini
+	void Free();
+private:
+	Compiled_CCDD( const Compiled_CCDD & );
+	Compiled_CCDD & operator = ( const Compiled_CCDD & );
+};
+
+class CCDD_Knowledge_Compiler  // Panini for CCDD
+{
+protected:
+	CCDD_Compiler * _compiler;
+	Heuristic _heur;
+public:
+	CCDD_Knowledge_Compiler();
+	CCDD_Knowledge_Compiler( Compiler_Parameters & parameters );  // the input and output options are ignored
+	~CCDD_Knowledge_Compiler();
+	Running_Options & Options();
+	Compiled_CCDD Compile( CNF_Formula & cnf, const Run_Budget & budget = Run_Budget() );  /// NOTE: cnf may be simplified
+	size_t Memory();
+protected:
+	void Init( Compiler_Parameters & parameters );
+private:
+	CCDD_Knowledge_Compiler( const CCDD_Knowledge_Compiler & );
+	CCDD_Knowledge_Compiler & operator = ( const CCDD_Knowledge_Compiler & );
+};
+
+
+}
+
+
+#endif  // _KCBox_h_
@@ -214,6 +214,35 @@ void CCDD_Manager::Load_Nodes( CCDD_Manager & other )
 	Swap_Nodes( other );
 }
 
+NodeID CCDD_Manager::Import_Nodes( CCDD_Manager & other, NodeID root )
+{
+	assert( _max_var == other.Max_Var() && root < other.Num_Nodes() );
+	if ( root < _num_fixed_nodes ) return root;
+	vector<bool> reachable( root + 1, false );
+	reachable[root] = true;
+	for ( dag_size_t i = root; i >= _num_fixed_nodes; i-- ) {
+		if ( !reachable[i] ) continue;
+		for ( unsigned j = 0; j < other._nodes[i].ch_size; j++ ) {
+			reachable[other._nodes[i].ch[j]] = true;
+		}
+	}
+	vector<NodeID> node_map( root + 1 );
+	for ( dag_size_t i = 0; i < _num_fixed_nodes; i++ ) {
+		node_map[i] = NodeID( i );
+	}
+	for ( dag_size_t i = _num_fixed_nodes; i <= root; i++ ) {  /// NOTE: a child is always older than its parents
+		if ( !reachable[i] ) continue;
+		CDD_Node node = other._nodes[i].Copy();
+		for ( unsigned j = 0; j < node.ch_size; j++ ) {
+			node.ch[j] = node_map[node.ch[j]];
+		}
+		if ( node.sym == CDD_SYMBOL_DECOMPOSE ) _qsorter.Sort( node.ch, node.ch_size );  // the children are sorted by IDs
+		else if ( node.sym == CDD_SYMBOL_KERNELIZE ) _qsorter.Sort( node.ch + 1, node.ch_size - 1 );  // the core comes first
+		node_map[i] = Push_Node( node );
+	}
+	return node_map[root];
+}
+
 bool CCDD_Manager::Entail_Clause( const CDDiagram & ccdd, Clause &cl )
 {
 	assert( Contain( ccdd ) );
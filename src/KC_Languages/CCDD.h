@@ -110,6 +110,7 @@ public:
 	void Abandon_Rename( unsigned map[] );
 	void Enlarge_Max_Var( Chain & new_order );
 	void Load_Nodes( CCDD_Manager & other );
+	NodeID Import_Nodes( CCDD_Manager & other, NodeID root );  // NOTE: the variables of other need to be ordered in the same way
 	CDDiagram Generate_CCDD( NodeID root ) { assert( root < _nodes.Size() );  return Generate_CDD( root ); }
 	void Display( ostream & out );
 	void Display_Stat( ostream & out );
@@ -6,7 +6,8 @@ namespace KCBox {
 
 CDD_Manager::CDD_Manager( Variable max_var, dag_size_t estimated_node_num ):
 Diagram_Manager( max_var ),
-_nodes( 2 * estimated_node_num )
+_nodes( 2 * estimated_node_num ),
+_stream( nullptr )
 {
 	Add_Fixed_Nodes();
 	Allocate_and_Init_Auxiliary_Memory();
@@ -55,6 +56,97 @@ CDD_Manager::~CDD_Manager()
 		delete [] _nodes[i].ch;
 	}
 	Free_Auxiliary_Memory();
+	delete _stream;
+}
+
+void CDD_Manager::Open_Stream( const char * file_name )
+{
+	assert( _stream == nullptr );
+	_stream = new fstream( file_name, ios::in | ios::out | ios::trunc );
+	if ( _stream->fail() ) {
+		cerr << "ERROR[CDD]: the stream file cannot be opened!" << endl;
+		exit( 1 );
+	}
+	_stream_ids.clear();
+	_stream_index.clear();
+	_num_streamed = 0;
+	_stream_offset = 0;
+}
+
+void CDD_Manager::Flush_Stream()
+{
+	/* NOTE:
+	* The nodes are written in the format of Display, and a child is always older than its parents.  The header is
+	* written with the first nodes, since the maximum variable can still be enlarged before compilation.
+	* A removed node may be generated again, so the written nodes are indexed by the hash values of their lines,
+	* and a hit is confirmed by reading the line back from the file
+	*/
+	if ( _stream == nullptr ) return;
+	fstream & out = *_stream;
+	string line;
+	if ( _num_streamed == 0 ) {
+		line = "Maximum variable: " + to_string( ExtVar( _max_var ) ) + "\nNumber of nodes: ";
+		_stream_size_pos = line.size();
+		line += string( 20, ' ' ) + '\n';
+		out << line;
+		_stream_offset += line.size();
+	}
+	for ( dag_size_t i = _stream_ids.size(); i < _nodes.Size(); i++ ) {
+		CDD_Node & node = _nodes[i];
+		if ( node.sym == CDD_SYMBOL_FALSE ) line = "F 0";
+		else if ( node.sym == CDD_SYMBOL_TRUE ) line = "T 0";
+		else {
+			if ( node.sym == CDD_SYMBOL_DECOMPOSE ) line = "D";
+			else if ( node.sym == CDD_SYMBOL_KERNELIZE ) line = "K";
+			else line = to_string( node.sym );
+			for ( unsigned j = 0; j < node.ch_size; j++ ) {
+				line += ' ' + to_string( _stream_ids[node.ch[j]] );
+			}
+			line += " 0";
+		}
+		size_t key = hash<string>()( line );
+		if ( i >= _num_fixed_nodes ) {
+			unordered_map<size_t, streamoff>::iterator itr = _stream_index.find( key );
+			if ( itr != _stream_index.end() ) {
+				string written;
+				out.flush();
+				out.seekg( itr->second );
+				getline( out, written );
+				out.seekp( _stream_offset );
+				size_t tab = written.find( '\t' );
+				if ( tab != string::npos && written.compare( tab + 1, string::npos, line ) == 0 ) {
+					_stream_ids.push_back( stoull( written.substr( 0, tab ) ) );
+					continue;
+				}
+			}
+			else _stream_index[key] = _stream_offset;
+		}
+		_stream_ids.push_back( _num_streamed );
+		line = to_string( _num_streamed++ ) + ":\t" + line + '\n';
+		out << line;
+		_stream_offset += line.size();
+	}
+}
+
+void CDD_Manager::Close_Stream( NodeID root )
+{
+	assert( _stream != nullptr && root < _nodes.Size() );
+	Flush_Stream();
+	fstream & out = *_stream;
+	dag_size_t num_nodes = _num_streamed;
+	if ( _stream_ids[root] != num_nodes - 1 ) {  /// NOTE: the root of a file is the last node, so an older root is conjoined with the true node
+		out << num_nodes << ":\tD " << std::min( _stream_ids[root], (dag_size_t) NodeID::top ) << ' ' << std::max( _stream_ids[root], (dag_size_t) NodeID::top ) << " 0" << endl;
+		num_nodes++;
+	}
+	out.seekp( _stream_size_pos );
+	out << num_nodes;
+	out.close();
+	if ( out.fail() ) cerr << "Warning[CDD]: failed to write the stream file!" << endl;
+	delete _stream;
+	_stream = nullptr;
+	_stream_ids.clear();
+	_stream_ids.shrink_to_fit();
+	_stream_index.clear();
 }
 
 void CDD_Manager::Free_Auxiliary_Memory()
@@ -416,6 +508,10 @@ bool CDD_Manager::Decide_Valid_Under_Assignment( NodeID root )
 
 void CDD_Manager::Clear_Nodes()
 {
+	if ( _stream_ids.size() > _num_fixed_nodes ) {
+		cerr << "ERROR[CDD]: cannot clear the written nodes!" << endl;
+		exit( 1 );
+	}
 	for ( dag_size_t i = _num_fixed_nodes; i < _nodes.Size(); i++ ) {
 		delete [] _nodes[i].ch;
 	}
@@ -424,6 +520,7 @@ void CDD_Manager::Clear_Nodes()
 
 void CDD_Manager::Remove_Redundant_Nodes()
 {
+	Flush_Stream();
 	DLList_Node<NodeID> * itr;
 	for ( itr = _allocated_nodes.Front(); itr != _allocated_nodes.Head(); itr = _allocated_nodes.Next( itr ) ) {
 		_nodes[itr->data].infor.visited = true;
@@ -452,6 +549,7 @@ void CDD_Manager::Remove_Redundant_Nodes()
 			for ( unsigned j = 2; j < _nodes[i].ch_size; j++ ) {
 				_nodes[i - num_remove].ch[j] = _nodes[_nodes[i].ch[j]].infor.mark;
 			}
+			if ( _stream != nullptr ) _stream_ids[i - num_remove] = _stream_ids[i];
 		}
 		else {
 			num_remove++;
@@ -462,6 +560,7 @@ void CDD_Manager::Remove_Redundant_Nodes()
 		itr->data = _nodes[itr->data].infor.mark;
 	}
 	dag_size_t new_size = _nodes.Size() - num_remove;
+	if ( _stream != nullptr ) _stream_ids.resize( new_size );
 	_nodes.Resize( new_size );
 	for ( dag_size_t i = 0; i < _nodes.Size(); i++ ) {
 		_nodes[i].infor.Init();
@@ -472,6 +571,7 @@ void CDD_Manager::Remove_Redundant_Nodes()
 void CDD_Manager::Remove_Redundant_Nodes( vector<NodeID> & kept_nodes )
 {
 //	Display( cout );
+	Flush_Stream();
 	DLList_Node<NodeID> * itr;
 	for ( itr = _allocated_nodes.Front(); itr != _allocated_nodes.Head(); itr = _allocated_nodes.Next( itr ) ) {
 		_nodes[itr->data].infor.visited = true;
@@ -508,6 +608,7 @@ void CDD_Manager::Remove_Redundant_Nodes( vector<NodeID> & kept_nodes )
 			for ( unsigned j = 2; j < _nodes[i].ch_size; j++ ) {
 				_nodes[i - num_remove].ch[j] = _nodes[_nodes[i].ch[j]].infor.mark;
 			}
+			if ( _stream != nullptr ) _stream_ids[i - num_remove] = _stream_ids[i];
 		}
 		else {
 			num_remove++;
@@ -522,6 +623,7 @@ void CDD_Manager::Remove_Redundant_Nodes( vector<NodeID> & kept_nodes )
 		kept_nodes[i] = _nodes[kept_nodes[i]].infor.mark;
 	}
 	dag_size_t new_size = _nodes.Size() - num_remove;
+	if ( _stream != nullptr ) _stream_ids.resize( new_size );
 	_nodes.Resize( new_size );
 	for ( dag_size_t i = 0; i < _nodes.Size(); i++ ) _nodes[i].infor.Init();
 	_hash_memory = _nodes.Memory();
@@ -3,6 +3,7 @@
 
 #include "OBDD[AND].h"
 #include "../Primitive_Types/Lit_Equivalency.h"
+#include <unordered_map>
 
 
 namespace KCBox {
@@ -170,10 +171,21 @@ protected:  // auxiliary memory
 	NodeID * _result_stack;
 	unsigned _num_result_stack;
 	QSorter _qsorter;
-	size_t _hash_memory;
+	Memory_Account<Memory_Nodes> _hash_memory;
+protected:  // streaming
+	fstream * _stream;  // the file where nodes are written during compilation
+	streamoff _stream_size_pos;  // the position of the number of nodes, which is known only in the end
+	streamoff _stream_offset;
+	vector<dag_size_t> _stream_ids;  // the IDs of the written nodes in the file, which are kept when removing redundant nodes
+	dag_size_t _num_streamed;
+	unordered_map<size_t, streamoff> _stream_index;  // the hash values of written lines to their positions
 public:
 	CDD_Manager( Variable max_var, dag_size_t estimated_node_num = LARGE_HASH_TABLE );
 	~CDD_Manager();
+	void Open_Stream( const char * file_name );
+	void Flush_Stream();
+	void Close_Stream( NodeID root );
+	bool Streaming() const { return _stream != nullptr; }
 	void Rename( unsigned map[] );
 	void Abandon_Rename( unsigned map[] );
 	void Enlarge_Max_Var( Variable max_var );
@@ -207,6 +219,12 @@ protected:
 public: // transformation
 	void Clear_Nodes();
 	void Shrink_Nodes() { _nodes.Shrink_To_Fit(); _hash_memory = _nodes.Memory(); }
+	void Reserve_Nodes( dag_size_t num_nodes )  // when the instance turns out to be wider than estimated at construction
+	{
+		if ( 2 * num_nodes <= _nodes.Num_Entries() ) return;
+		_nodes.Resize_Entries( 2 * num_nodes );
+		_hash_memory = _nodes.Memory();
+	}
 	void Swap_Nodes( CDD_Manager & other ) { _nodes.Swap( other._nodes); }
 	void Remove_Redundant_Nodes();
 	void Remove_Redundant_Nodes( vector<NodeID> & kept_nodes );
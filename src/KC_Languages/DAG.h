@@ -85,7 +85,7 @@ template<typename T_HASH, typename T_NODE> NodeID Hash_Hit_Node( T_HASH & nodes,
 	return NodeID( id );
 }
 
-template<typename T_HASH, typename T_NODE> NodeID Hash_Hit_Node( T_HASH & nodes, T_NODE & node, size_t & hash_memory )
+template<typename T_HASH, typename T_NODE, typename T_MEMORY> NodeID Hash_Hit_Node( T_HASH & nodes, T_NODE & node, T_MEMORY & hash_memory )
 {
 	dag_size_t id = nodes.Hit( node, hash_memory );
 //	ASSERT( hash_memory == nodes.Memory() );  // ToRemove
@@ -26,6 +26,7 @@ public:
 	void Rename( unsigned map[] );
 	void Abandon_Rename( unsigned map[] );
 	void Enlarge_Max_Var( Variable & max_var );
+	NodeID Import_Nodes( DecDNNF_Manager & other, NodeID root );  // NOTE: the variables of other cannot exceed those of this manager
 	CDDiagram Generate_DNNF( NodeID root ) { assert( root < _nodes.Size() );  return Generate_CDD( root ); }
 	void Display( ostream & out );
 	void Display_Stat( ostream & out );
@@ -74,7 +74,7 @@ protected:
 protected:
 	NodeID * _result_stack;
 	unsigned _num_result_stack;
-	size_t _hash_memory;
+	Memory_Account<Memory_Nodes> _hash_memory;
 	Binary_Map<NodeID, NodeID, NodeID> _op_table;
 public:
 	OBDD_Manager( Variable max_var );
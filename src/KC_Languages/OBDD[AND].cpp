@@ -184,6 +184,35 @@ void OBDDC_Manager::Reorder( const Chain & new_order )
 	_var_order = new_order;
 }
 
+NodeID OBDDC_Manager::Import_Nodes( OBDDC_Manager & other, NodeID root )
+{
+	assert( other.Max_Var() <= _max_var && root < other._nodes.Size() );
+	if ( root < _num_fixed_nodes ) return root;
+	vector<bool> reachable( root + 1, false );
+	reachable[root] = true;
+	for ( dag_size_t i = root; i >= _num_fixed_nodes; i-- ) {
+		if ( !reachable[i] ) continue;
+		for ( unsigned j = 0; j < other._nodes[i].ch_size; j++ ) {
+			reachable[other._nodes[i].ch[j]] = true;
+		}
+	}
+	vector<NodeID> node_map( root + 1 );
+	for ( dag_size_t i = 0; i < _num_fixed_nodes; i++ ) {
+		node_map[i] = NodeID( i );
+	}
+	for ( dag_size_t i = _num_fixed_nodes; i <= root; i++ ) {  /// NOTE: a child is always older than its parents
+		if ( !reachable[i] ) continue;
+		_aux_rnode.sym = other._nodes[i].sym;
+		_aux_rnode.ch_size = 0;
+		for ( unsigned j = 0; j < other._nodes[i].ch_size; j++ ) {
+			_aux_rnode.Add_Child( node_map[other._nodes[i].ch[j]] );
+		}
+		if ( _aux_rnode.sym == DECOMP_SYMBOL_CONJOIN ) _qsorter.Sort( _aux_rnode.ch, _aux_rnode.ch_size );  // the children are sorted by IDs
+		node_map[i] = Push_Node( _aux_rnode );
+	}
+	return node_map[root];
+}
+
 void OBDDC_Manager::Rename( unsigned map[] )
 {
 	_var_order.Rename( map );
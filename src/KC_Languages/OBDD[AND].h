@@ -228,7 +228,7 @@ protected: //auxiliary memory
 	unsigned * _node_set_sizes;
 	Rough_BDDC_Node _aux_rnode;
 	QSorter _qsorter;
-	size_t _hash_memory;
+	Memory_Account<Memory_Nodes> _hash_memory;
 public:
 	OBDDC_Manager( Variable max_var,  dag_size_t node_num = LARGE_HASH_TABLE );
 	OBDDC_Manager( const Chain & order, dag_size_t node_num = 100 ); // Only called by the static generating functions
@@ -236,6 +236,7 @@ public:
 	OBDDC_Manager( OBDDC_Manager & other );
 	~OBDDC_Manager();
 	void Reorder( const Chain & new_order );
+	NodeID Import_Nodes( OBDDC_Manager & other, NodeID root );  // NOTE: the variables of other need to be ordered in the same way
 	void Rename( unsigned map[] );
 	void Abandon_Rename( unsigned map[] );
 	OBDDC_Manager * Copy_BDDC_Standard_Order( NodeID root ); /// For each decision node u, the position of the low children of u is less than that of the high children of of u. Furthermore, for any two children v and w of decomposition node u, the position of v is less than that of u if the min_var of v is less than that of u
@@ -9,6 +9,7 @@
 #include "Compilers/Partial_Compiler.h"
 #include "Counters/KCounter.h"
 #include "Counters/WCounter.h"
+#include "Template_Library/Tracer.h"
 
 using namespace KCBox;
 
@@ -25,12 +26,12 @@ Sampler_Parameters sampler_parameters( "FastUS" );
 
 Approx_Counter_Parameters approx_counter_parameters( "PartialKC" );
 
-Tool_Parameters * tools[] = {&preprocessor_parameters, \
+Solver_Tool_Parameters * tools[] = {&preprocessor_parameters, \
 	&counter_parameters, \
 	&compiler_parameters, \
 	&sampler_parameters, \
 	&approx_counter_parameters};
-const int num_tools = sizeof(tools) / sizeof(Tool_Parameters *);
+const int num_tools = sizeof(tools) / sizeof(Solver_Tool_Parameters *);
 
 
 struct Parameters
@@ -179,7 +180,10 @@ void Test_Preprocessor()
 
 void Test_Counter()
 {
-	if ( !counter_parameters.weighted ) {
+	if ( counter_parameters.batch ) {
+		KCounter::Test_Batch( parameters.cnf_file, counter_parameters );
+	}
+	else if ( !counter_parameters.weighted ) {
 		KCounter::Test( parameters.cnf_file, counter_parameters, parameters.quiet );
 	}
 	else {
@@ -250,9 +254,17 @@ void Test_PartialKC()
 	}
 }
 
+Solver_Tool_Parameters * Chosen_Tool()
+{
+	for ( int t = 0; t < num_tools; t++ ) {
+		if ( strcmp( parameters.tool, tools[t]->Tool_Name() ) == 0 ) return tools[t];
+	}
+	return nullptr;
+}
+
 void Test()
 {
-	if ( !parameters.quiet ) {
+	if ( !parameters.quiet && !counter_parameters.batch ) {  // the lines of batch mode are left alone on the standard output
 		if ( counter_parameters.competition ) {
 			cout << "c o Instance name: " << parameters.cnf_file << endl;
 			system( "printf 'c o '" );
@@ -307,7 +319,11 @@ int main( int argc, const char *argv[] )
 		}
 	}
 	if ( t == num_tools ) Parse_Parameters( argc, argv );
+	Solver_Tool_Parameters * tool = Chosen_Tool();
+	if ( tool->trace.Exists() ) Tracer::Start( tool->trace_sample, 100 );  // the scopes over 100 us are all kept
+	Catch_Interrupt_Signal();  // Ctrl-C stops the run like an exhausted budget
 	Test();
+	if ( tool->trace.Exists() && !Tracer::Export( tool->trace ) ) return 1;
 	return 0;
 }
 
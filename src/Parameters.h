@@ -4,6 +4,7 @@
 #include "Template_Library/Basic_Functions.h"
 #include "Template_Library/Basic_Structures.h"
 #include "Template_Library/Options.h"
+#include "Template_Library/Statistics_Writer.h"
 #include "Primitive_Types/Assignment.h"
 
 
@@ -28,14 +29,56 @@ extern inline Solver_Type Parse_Solver( const char * type )
 	else return solver_invalid;
 }
 
-struct Preprocessor_Parameters: public Tool_Parameters
+struct Solver_Tool_Parameters: public Tool_Parameters  // the options shared by all tools
+{
+	StringOption stats_json;
+	FloatOption stats_interval;
+	StringOption trace;
+	IntOption trace_sample;
+	FloatOption time_limit;
+	FloatOption memory_limit;
+	Solver_Tool_Parameters( const char * tool_name ): Tool_Parameters( tool_name ),
+		stats_json( "--stats-json", "the file to which the statistics are written in JSON at the end", nullptr ),
+		stats_interval( "--stats-interval", "the interval in seconds between two snapshots of the statistics file", 0 ),
+		trace( "--trace", "the file to which the timeline of the hot phases is written in Chrome trace format", nullptr ),
+		trace_sample( "--trace-sample", "keep one in this number of the short scopes of each phase in the timeline", 1024, 1, 1 << 30 ),
+		time_limit( "--time-limit", "the time in seconds after which the search stops with a partial or unknown result (0 means no limit)", 0 ),
+		memory_limit( "--memory-limit", "the memory in GB of the search beyond which it stops with a partial or unknown result (0 means no limit)", 0 )
+	{
+		Add_Option( &stats_json );
+		Add_Option( &stats_interval );
+		Add_Option( &trace );
+		Add_Option( &trace_sample );
+		Add_Option( &time_limit );
+		Add_Option( &memory_limit );
+	}
+	bool Parse_Parameters( int & i, int argc, const char *argv[] )
+	{
+		if ( !Tool_Parameters::Parse_Parameters( i, argc, argv ) ) return false;
+		if ( stats_interval.Exists() && ( !stats_json.Exists() || stats_interval <= 0 ) ) {
+			cerr << "ERROR: --stats-interval must be positive and work with --stats-json!" << endl;
+			return false;
+		}
+		if ( trace_sample.Exists() && !trace.Exists() ) {
+			cerr << "ERROR: --trace-sample must work with --trace!" << endl;
+			return false;
+		}
+		if ( time_limit < 0 || memory_limit < 0 ) {
+			cerr << "ERROR: --time-limit and --memory-limit must be nonnegative!" << endl;
+			return false;
+		}
+		return true;
+	}
+};
+
+struct Preprocessor_Parameters: public Solver_Tool_Parameters
 {
 	BoolOption competition;
 	StringOption solver;
 	BoolOption no_rm_clauses;
 	BoolOption no_lit_equ;
 	StringOption out_file;
-	Preprocessor_Parameters( const char * tool_name ): Tool_Parameters( tool_name ),
+	Preprocessor_Parameters( const char * tool_name ): Solver_Tool_Parameters( tool_name ),
 		competition( "--competition", "working for mc competition", false ),
 		solver( "--solver", "MiniSat or CaDiCaL", nullptr ),
 		no_rm_clauses( "--no-rm-clauses", "no use of blocking clauses", false ),
@@ -50,7 +93,7 @@ struct Preprocessor_Parameters: public Tool_Parameters
 	}
 };
 
-struct Counter_Parameters: public Tool_Parameters
+struct Counter_Parameters: public Solver_Tool_Parameters
 {
 	BoolOption competition;
 	BoolOption weighted;
@@ -61,8 +104,17 @@ struct Counter_Parameters: public Tool_Parameters
 	FloatOption memo;
 	IntOption kdepth;
 	BoolOption clear_half;
+	BoolOption evict_cache;
 	IntOption format;
-	Counter_Parameters( const char * tool_name ): Tool_Parameters( tool_name ),
+	FloatOption treed_time;
+	IntOption threads;
+	StringOption checkpoint;
+	FloatOption checkpoint_interval;
+	BoolOption resume;
+	BoolOption batch;
+	IntOption jobs;
+	StringOption jsonl;
+	Counter_Parameters( const char * tool_name ): Solver_Tool_Parameters( tool_name ),
 		competition( "--competition", "working for mc competition", false ),
 		weighted( "--weighted", "weighted model counting", false ),
 		mpf_prec( "--mpf-prec", "the times of the default precision of mpf_t", 1 ),
@@ -72,7 +124,16 @@ struct Counter_Parameters: public Tool_Parameters
 		memo( "--memo", "the available memory in GB", 4 ),
 		kdepth( "--kdepth", "maximum kernelization depth", 128 ),
 		clear_half( "--clear-half", "clear half of component cache", false ),
-		format( "--format", "MC Competition format (0), miniC2D format (1)", 0, 0, 1 )
+		evict_cache( "--evict-cache", "evict the component cache entries with the lowest priority of hits, cost and size (GDSF) instead of clearing", false ),
+		format( "--format", "MC Competition format (0), miniC2D format (1)", 0, 0, 1 ),
+		treed_time( "--treed-time", "the time budget in seconds of the anytime tree decomposition (only for FlowCutter)", 60 ),
+		threads( "--threads", "the number of threads for tree decomposition and literal probing (0 means the number of hardware threads)", 1, 0, 1024 ),
+		checkpoint( "--checkpoint", "the file to which the search state is saved periodically", nullptr ),
+		checkpoint_interval( "--checkpoint-interval", "the interval in seconds between two checkpoints", 600 ),
+		resume( "--resume", "continue from the checkpoint file", false ),
+		batch( "--batch", "the input is a list of cnf files (one per line) or a directory of them, all counted in this process", false ),
+		jobs( "--jobs", "the number of instances counted in parallel in batch mode (0 means the number of hardware threads)", 1, 0, 1024 ),
+		jsonl( "--jsonl", "the file to which batch mode writes one JSON line per instance (the standard output by default)", nullptr )
 	{
 		Add_Option( &competition );
 		Add_Option( &weighted );
@@ -83,11 +144,20 @@ struct Counter_Parameters: public Tool_Parameters
 		Add_Option( &memo );
 		Add_Option( &kdepth );
 		Add_Option( &clear_half );
+		Add_Option( &evict_cache );
 		Add_Option( &format );
+		Add_Option( &treed_time );
+		Add_Option( &threads );
+		Add_Option( &checkpoint );
+		Add_Option( &checkpoint_interval );
+		Add_Option( &resume );
+		Add_Option( &batch );
+		Add_Option( &jobs );
+		Add_Option( &jsonl );
 	}
 	bool Parse_Parameters( int & i, int argc, const char *argv[] )
 	{
-		if ( !Tool_Parameters::Parse_Parameters( i, argc, argv ) ) return false;
+		if ( !Solver_Tool_Parameters::Parse_Parameters( i, argc, argv ) ) return false;
 		if ( strcmp( heur, "auto") != 0 && strcmp( heur, "minfill") != 0 && strcmp( heur, "FlowCutter") != 0 && \
 			strcmp( heur, "LinearLRW") != 0 && strcmp( heur, "VSADS") != 0 && strcmp( heur, "DLCS") != 0 && \
 			strcmp( heur, "DLCP") != 0 && strcmp( heur, "dynamic_minfill") != 0 ) {
@@ -97,6 +167,10 @@ struct Counter_Parameters: public Tool_Parameters
 			strcmp( heur, "LinearLRW") != 0 ) {
 			return false;
 		}
+		if ( treed_time.Exists() && ( strcmp( heur, "FlowCutter") != 0 || treed_time <= 0 ) ) {
+			cerr << "ERROR: --treed-time must be positive and work with --heur FlowCutter!" << endl;
+			return false;
+		}
 		if ( !weighted ) {
 			if ( format.Exists() ) return false;
 			if ( mpf_prec.Exists() ) {
@@ -104,6 +178,26 @@ struct Counter_Parameters: public Tool_Parameters
 				return false;
 			}
 		}
+		if ( evict_cache && clear_half ) {
+			cerr << "ERROR: --evict-cache cannot work with --clear-half!" << endl;
+			return false;
+		}
+		if ( ( checkpoint_interval.Exists() || resume ) && !checkpoint.Exists() ) {
+			cerr << "ERROR: --checkpoint-interval and --resume must work with --checkpoint!" << endl;
+			return false;
+		}
+		if ( checkpoint.Exists() && ( weighted || condition.Exists() || checkpoint_interval < 0 ) ) {
+			cerr << "ERROR: --checkpoint cannot work with --weighted or --condition, and its interval must be nonnegative!" << endl;
+			return false;
+		}
+		if ( ( jobs.Exists() || jsonl.Exists() ) && !batch ) {
+			cerr << "ERROR: --jobs and --jsonl must work with --batch!" << endl;
+			return false;
+		}
+		if ( batch && ( weighted || condition.Exists() || checkpoint.Exists() || stats_json.Exists() || competition ) ) {
+			cerr << "ERROR: --batch cannot work with --weighted, --condition, --checkpoint, --stats-json or --competition!" << endl;
+			return false;
+		}
 		return true;
 	}
 };
@@ -157,14 +251,16 @@ inline ostream & operator << ( ostream & out, KC_Language & lang )
 	return out;
 }
 
-struct Compiler_Parameters: public Tool_Parameters
+struct Compiler_Parameters: public Solver_Tool_Parameters
 {
 	StringOption lang;
 	StringOption heur;
 	StringOption cache_enc;
 	FloatOption memo;
 	IntOption kdepth;
+	IntOption threads;
 	StringOption out_file;
+	BoolOption stream;
 	StringOption out_file_dot;
 	BoolOption CO;
 	BoolOption VA;
@@ -175,13 +271,15 @@ struct Compiler_Parameters: public Tool_Parameters
 	IntOption US;
 	IntOption wUS;
 	StringOption condition;
-	Compiler_Parameters( const char * tool_name ): Tool_Parameters( tool_name ),
+	Compiler_Parameters( const char * tool_name ): Solver_Tool_Parameters( tool_name ),
 		lang( "--lang", "KC language OBDD, OBDD[AND], Decision-DNNF, R2-D2, or CCDD", "OBDD[AND]" ),
 		heur( "--heur", "heuristic strategy (auto, minfill, FlowCutter, lexicographic, LinearLRW, VSADS, DLCP, or dynamic_minfill)", "auto" ),
 		cache_enc( "--cache-encoding", "component cache encoding strategy (simple or difference)", "simple" ),
 		memo( "--memo", "the available memory in GB", 4 ),
 		kdepth( "--kdepth", "maximum kernelization depth (only applicable for CCDD)", 128 ),
+		threads( "--threads", "the number of threads compiling the root in parallel (0 means the number of hardware threads, not applicable for smooth-OBDD[AND] and R2-D2)", 1, 0, 1024 ),
 		out_file( "--out", "the output file with compilation", nullptr ),
+		stream( "--stream", "writing the nodes into the output file during compilation (only applicable for CCDD and Decision-DNNF)", false ),
 		out_file_dot( "--out-dot", "the output file with compilation in .dot format", nullptr ),
 		CO( "--CO", "checking consistency", false ),
 		VA( "--VA", "checking validity", false ),
@@ -198,7 +296,9 @@ struct Compiler_Parameters: public Tool_Parameters
 		Add_Option( &cache_enc );
 		Add_Option( &memo );
 		Add_Option( &kdepth );
+		Add_Option( &threads );
 		Add_Option( &out_file );
+		Add_Option( &stream );
 		Add_Option( &out_file_dot );
 		Add_Option( &CO );
 		Add_Option( &VA );
@@ -212,7 +312,7 @@ struct Compiler_Parameters: public Tool_Parameters
 	}
 	bool Parse_Parameters( int & i, int argc, const char *argv[] )
 	{
-		if ( !Tool_Parameters::Parse_Parameters( i, argc, argv ) ) return false;
+		if ( !Solver_Tool_Parameters::Parse_Parameters( i, argc, argv ) ) return false;
 		KC_Language kclang = Parse_Language( lang );
 		if ( kclang == lang_invalid ) {
 			cerr << "ERROR: the language is not supported!" << endl;
@@ -221,6 +321,14 @@ struct Compiler_Parameters: public Tool_Parameters
 		if ( kclang != lang_CCDD && kdepth.Exists() ) {
 			cerr << "ERROR: --kdepth can only work with CCDD!" << endl;
 		}
+		if ( ( kclang == lang_smooth_OBDDC || kclang == lang_RRCDD ) && threads.Exists() ) {
+			cerr << "ERROR: --threads cannot work with smooth-OBDD[AND] or R2-D2!" << endl;
+			return false;
+		}
+		if ( stream && ( ( kclang != lang_CCDD && kclang != lang_DecDNNF ) || !out_file.Exists() ) ) {
+			cerr << "ERROR: --stream can only work with --out for CCDD or Decision-DNNF!" << endl;
+			return false;
+		}
 		if ( !At_Most_One_Query() ) {
 			cerr << "ERROR: there are more than one query!" << endl;
 		}
@@ -266,7 +374,7 @@ protected:
 	}
 };
 
-struct Sampler_Parameters: public Tool_Parameters
+struct Sampler_Parameters: public Solver_Tool_Parameters
 {
 	BoolOption weighted;
 	BoolOption approx;
@@ -274,7 +382,7 @@ struct Sampler_Parameters: public Tool_Parameters
 	FloatOption memo;
 	IntOption format;
 	StringOption out_file;
-	Sampler_Parameters( const char * tool_name ): Tool_Parameters( tool_name ),
+	Sampler_Parameters( const char * tool_name ): Solver_Tool_Parameters( tool_name ),
 		weighted( "--weighted", "weighted sampling", false ),
 		approx( "--approx", "approximately uniform", false ),
 		nsamples( "--nsamples", "number of samples", 1 ),
@@ -291,7 +399,7 @@ struct Sampler_Parameters: public Tool_Parameters
 	}
 	bool Parse_Parameters( int & i, int argc, const char *argv[] )
 	{
-		if ( !Tool_Parameters::Parse_Parameters( i, argc, argv ) ) return false;
+		if ( !Solver_Tool_Parameters::Parse_Parameters( i, argc, argv ) ) return false;
 		if ( !weighted ) {
 			if ( format.Exists() ) {
 				cerr << "ERROR: --format must work with --weighted!" << endl;
@@ -305,7 +413,7 @@ struct Sampler_Parameters: public Tool_Parameters
 	}
 };
 
-struct Approx_Counter_Parameters: public Tool_Parameters
+struct Approx_Counter_Parameters: public Solver_Tool_Parameters
 {
 	BoolOption weighted;
 	StringOption heur;
@@ -317,7 +425,11 @@ struct Approx_Counter_Parameters: public Tool_Parameters
 	IntOption format;
 	BoolOption lower;
 	FloatOption confidence;
-	Approx_Counter_Parameters( const char * tool_name ): Tool_Parameters( tool_name ),
+	IntOption threads;
+	StringOption checkpoint;
+	FloatOption checkpoint_interval;
+	BoolOption resume;
+	Approx_Counter_Parameters( const char * tool_name ): Solver_Tool_Parameters( tool_name ),
 		weighted( "--weighted", "weighted model counting", false ),
 		heur( "--heur", "heuristic strategy (auto, minfill, LinearLRW, VSADS, DLCS, DLCP, dynamic_minfill)", "auto" ),
 		time( "--time", "timeout in seconds", 3600 ),
@@ -327,7 +439,11 @@ struct Approx_Counter_Parameters: public Tool_Parameters
 		seed( "--seed", "random seed", 0 ),
 		format( "--format", "MC Competition format (0), miniC2D format (1)", 0, 0, 1 ),
 		lower( "--lower", "computing lower bound", false ),
-		confidence( "--confidence", "the confidence of lower bound", 0.99 )
+		confidence( "--confidence", "the confidence of lower bound", 0.99 ),
+		threads( "--threads", "the number of independent sampling streams (0 means the number of hardware threads)", 1, 0, 1024 ),
+		checkpoint( "--checkpoint", "the file to which the sampling state is saved periodically", nullptr ),
+		checkpoint_interval( "--checkpoint-interval", "the interval in seconds between two checkpoints", 600 ),
+		resume( "--resume", "continue from the checkpoint file", false )
 	{
 		Add_Option( &weighted );
 		Add_Option( &heur );
@@ -339,10 +455,14 @@ struct Approx_Counter_Parameters: public Tool_Parameters
 		Add_Option( &format );
 		Add_Option( &lower );
 		Add_Option( &confidence );
+		Add_Option( &threads );
+		Add_Option( &checkpoint );
+		Add_Option( &checkpoint_interval );
+		Add_Option( &resume );
 	}
 	bool Parse_Parameters( int & i, int argc, const char *argv[] )
 	{
-		if ( !Tool_Parameters::Parse_Parameters( i, argc, argv ) ) return false;
+		if ( !Solver_Tool_Parameters::Parse_Parameters( i, argc, argv ) ) return false;
 		if ( strcmp( heur, "auto") != 0 && strcmp( heur, "minfill") != 0 && \
 			strcmp( heur, "LinearLRW") != 0 && strcmp( heur, "VSADS") != 0 && strcmp( heur, "DLCS") != 0 && \
 			strcmp( heur, "DLCP") != 0 && strcmp( heur, "dynamic_minfill") != 0 ) {
@@ -358,6 +478,18 @@ struct Approx_Counter_Parameters: public Tool_Parameters
 			if ( !lower ) return false;
 			if ( confidence <= 0 || confidence >= 1 ) return false;
 		}
+		if ( threads.Exists() && lower ) {
+			cerr << "ERROR: --threads cannot work with --lower!" << endl;
+			return false;
+		}
+		if ( ( checkpoint_interval.Exists() || resume ) && !checkpoint.Exists() ) {
+			cerr << "ERROR: --checkpoint-interval and --resume must work with --checkpoint!" << endl;
+			return false;
+		}
+		if ( checkpoint.Exists() && ( weighted || lower || threads.Exists() || checkpoint_interval < 0 ) ) {
+			cerr << "ERROR: --checkpoint cannot work with --weighted, --lower or --threads, and its interval must be nonnegative!" << endl;
+			return false;
+		}
 		return true;
 	}
 };
@@ -506,6 +638,8 @@ enum Profiling_Level
 struct Running_Options
 {
 	const char * display_prefix;
+	const char * stats_json_file;  /// nullptr means no statistics file
+	float stats_interval;  /// in seconds, and nonpositive means only the final statistics are written
 /// parameters of solver
 	Variable variable_bound;  // used for oracle mode
 	Solver_Type sat_solver;
@@ -517,6 +651,9 @@ struct Running_Options
 	double sat_restart_trigger_inc;
 	unsigned sat_restart_max;  // the maximum times of restart, and after that, external solver will be called
 	bool sat_filter_long_learnts;
+	bool sat_learnt_tiers;  // retain long learnts by tiers: core (small LBD), tier2 (middle LBD, kept while used), and local (kept only if reused)
+	unsigned sat_learnt_core_lbd;
+	unsigned sat_learnt_tier2_lbd;
 	bool sat_employ_external_solver;
 	bool sat_employ_external_solver_always;
 	Heuristic_Literal_Structure sat_heur_lits;
@@ -531,6 +668,7 @@ struct Running_Options
 	bool detect_lit_equivalence_first;
 	bool detect_lit_equivalence;
 	Literal_Equivalence_Detecting_Strategy lit_equivalence_detecting_strategy;
+	unsigned lit_equivalence_num_threads;  /// the threads to probe literals when detecting equivalences by BCP, and 0 means the number of hardware threads
 	bool detect_binary_learnts_resolution;
 	bool detect_binary_learnts_bcp;
 	bool detect_AND_gates;
@@ -541,6 +679,10 @@ struct Running_Options
 /// parameters of inprocessor
 	unsigned treewidth;  /// the minfill treewidth of the current problem
 	Heuristic var_ordering_heur;  /// the current heuristic strategy
+	double treed_time_budget;  /// in seconds, the time budget of the anytime tree decomposition
+	unsigned treed_num_threads;  /// 0 means the number of hardware threads
+	unsigned treed_stall_rounds;  /// the anytime tree decomposition stops when the width is not improved for so many rounds
+	unsigned minfill_num_threads;  /// the threads to recompute fill sizes, and 0 means the number of hardware threads
 	bool mixed_var_ordering;
 	bool phase_selecting;
 	Implicate_Computing_Strategy imp_strategy;
@@ -564,14 +706,19 @@ struct Running_Options
 	bool compute_duplicate_rate;
 	Cache_Encoding_Strategy cache_encoding = Simple_Cache_Encoding;
 	unsigned removing_redundant_nodes_trigger;
+	unsigned compile_num_threads;  /// the threads compiling the root (its components or top decisions) in parallel, and 0 means the number of hardware threads
 	bool display_compiling_process;
 	bool display_memory_status;
 	Profiling_Level profile_compiling;
 /// parameters of counter
 	bool clear_half_of_cache;
+	bool evict_cache;  /// GDSF eviction of the component cache instead of clearing
 	bool static_heur;
 	bool display_counting_process;
 	Profiling_Level profile_counting;
+	const char * checkpoint_file;  /// also used by partial kc, and nullptr means no checkpoint
+	float checkpoint_interval;  /// in seconds
+	bool resume_from_checkpoint;
 	/// parameters of partial kc
 	bool estimate_marginal_probability;
 	bool adaptive_sampling;
@@ -579,6 +726,9 @@ struct Running_Options
 	float sampling_time;
 	unsigned sampling_count;
 	unsigned sampling_display_interval;
+	unsigned sampling_num_threads;  /// the independent sampling streams, and 0 means the number of hardware threads
+	bool evict_cold_nodes;  /// under memory pressure, freeze the least visited subgraphs instead of restarting
+	float eviction_ratio;  /// the proportion of decision nodes frozen per eviction
 	Profiling_Level profile_partial_kc;
 /// parameters of oracle
 	Profiling_Level profile_oracle;
@@ -586,6 +736,8 @@ struct Running_Options
 	Running_Options()
 	{
 		display_prefix = "";
+		stats_json_file = nullptr;
+		stats_interval = 0;
 		variable_bound = Variable::undef;  /// NOTE: only Preprocessor and its inherited class can open this mode
 		/// solver
 		sat_solver = solver_MiniSat;
@@ -597,6 +749,9 @@ struct Running_Options
 		sat_restart_trigger_inc = 1.5;
 		sat_restart_max = 2;
 		sat_filter_long_learnts = false;
+		sat_learnt_tiers = true;
+		sat_learnt_core_lbd = 2;
+		sat_learnt_tier2_lbd = 6;
 		sat_employ_external_solver = true;
 		sat_employ_external_solver_always = false;
 		sat_heur_lits = Heuristic_Literal_Heap;
@@ -610,6 +765,7 @@ struct Running_Options
 		block_lits_external = true;
 		detect_lit_equivalence_first = false;
 		lit_equivalence_detecting_strategy = Literal_Equivalence_Detection_BCP;
+		lit_equivalence_num_threads = 1;
 		detect_lit_equivalence = true;
 		detect_binary_learnts_resolution = true;
 		detect_binary_learnts_bcp = false;
@@ -619,7 +775,12 @@ struct Running_Options
 		display_preprocessing_process = true;
 		profile_preprocessing = Profiling_Detail;
 		/// inprocessor
+		treewidth = UNSIGNED_UNDEF;
 		var_ordering_heur = AutomaticalHeur;
+		treed_time_budget = 60;
+		treed_num_threads = 0;
+		treed_stall_rounds = 64;
+		minfill_num_threads = 1;
 		mixed_var_ordering = true;
 		phase_selecting = true;
 		imp_strategy = Automatical_Imp_Computing;  // Automatical_Imp_Computing, Partial_Implicit_BCP, Full_Implicit_BCP, SAT_Imp_Computing
@@ -641,13 +802,18 @@ struct Running_Options
 		trivial_length_bound = 0.5;
 		treewidth_bound = 32;
 		removing_redundant_nodes_trigger = 2000000;
+		compile_num_threads = 1;
 		display_compiling_process = true;
 		profile_compiling = Profiling_Abstract;
 		/// counter
 		clear_half_of_cache = false;
+		evict_cache = false;
 		static_heur = false;
 		display_counting_process = true;
 		profile_counting = Profiling_Abstract;
+		checkpoint_file = nullptr;
+		checkpoint_interval = 600;
+		resume_from_checkpoint = false;
 		/// partial kc
 		estimate_marginal_probability = true;
 		adaptive_sampling = false;
@@ -655,6 +821,9 @@ struct Running_Options
 		sampling_time = 3600;
 		sampling_count = UNSIGNED_UNDEF;
 		sampling_display_interval = 1;
+		sampling_num_threads = 1;
+		evict_cold_nodes = true;
+		eviction_ratio = 0.5;
 		profile_partial_kc = Profiling_Abstract;
 		/// oracle
 		profile_oracle = Profiling_Abstract;
@@ -662,6 +831,8 @@ struct Running_Options
 	}
 	void Display( ostream & out )
 	{
+		out << display_prefix << "stats_json_file = " << ( stats_json_file == nullptr ? "none" : stats_json_file ) << endl;
+		out << display_prefix << "stats_interval = " << stats_interval << endl;
 		out << display_prefix << "variable_bound = " << variable_bound << endl;  /// NOTE: only Preprocessor and its inherited class can open this mode
 		/// solver
 		out << display_prefix << "sat_solver = " << sat_solver << endl;
@@ -673,6 +844,9 @@ struct Running_Options
 		out << display_prefix << "sat_restart_trigger_inc = " << sat_restart_trigger_inc << endl;
 		out << display_prefix << "sat_restart_max = " << sat_restart_max << endl;
 		out << display_prefix << "sat_filter_long_learnts = " << sat_filter_long_learnts << endl;
+		out << display_prefix << "sat_learnt_tiers = " << sat_learnt_tiers << endl;
+		out << display_prefix << "sat_learnt_core_lbd = " << sat_learnt_core_lbd << endl;
+		out << display_prefix << "sat_learnt_tier2_lbd = " << sat_learnt_tier2_lbd << endl;
 		out << display_prefix << "sat_employ_external_solver = " << sat_employ_external_solver << endl;
 		out << display_prefix << "sat_employ_external_solver_always = " << sat_employ_external_solver_always << endl;
 		out << display_prefix << "sat_heur_lits = " << sat_heur_lits << endl;
@@ -686,6 +860,7 @@ struct Running_Options
 		out << display_prefix << "block_lits_external = " << block_lits_external << endl;
 		out << display_prefix << "detect_lit_equivalence_first = " << detect_lit_equivalence_first << endl;
 		out << display_prefix << "lit_equivalence_detecting_strategy = " << lit_equivalence_detecting_strategy << endl;
+		out << display_prefix << "lit_equivalence_num_threads = " << lit_equivalence_num_threads << endl;
 		out << display_prefix << "detect_lit_equivalence = " << detect_lit_equivalence << endl;
 		out << display_prefix << "detect_binary_learnts_resolution = " << detect_binary_learnts_resolution << endl;
 		out << display_prefix << "detect_binary_learnts_bcp = " << detect_binary_learnts_bcp << endl;
@@ -696,6 +871,10 @@ struct Running_Options
 		out << display_prefix << "profile_preprocessing = " << profile_preprocessing << endl;
 		/// inprocessor
 		out << display_prefix << "var_ordering_heur = " << var_ordering_heur << endl;
+		out << display_prefix << "treed_time_budget = " << treed_time_budget << endl;
+		out << display_prefix << "treed_num_threads = " << treed_num_threads << endl;
+		out << display_prefix << "treed_stall_rounds = " << treed_stall_rounds << endl;
+		out << display_prefix << "minfill_num_threads = " << minfill_num_threads << endl;
 		out << display_prefix << "mixed_var_ordering = " << mixed_var_ordering << endl;
 		out.setf(std::ios_base::boolalpha);
 		out << display_prefix << "phase_selecting = " << phase_selecting << endl;
@@ -720,13 +899,18 @@ struct Running_Options
 		out << display_prefix << "treewidth_bound = " << treewidth_bound << endl;
 		out << display_prefix << "cache_encoding = " << cache_encoding << endl;
 		out << display_prefix << "removing_redundant_nodes_trigger = " << removing_redundant_nodes_trigger << endl;
+		out << display_prefix << "compile_num_threads = " << compile_num_threads << endl;
 		out << display_prefix << "display_compiling_process = " << display_compiling_process << endl;
 		out << display_prefix << "profile_compiling = " << profile_compiling << endl;
 		/// counter
 		out << display_prefix << "clear_half_of_cache = " << clear_half_of_cache << endl;
+		out << display_prefix << "evict_cache = " << evict_cache << endl;
 		out << display_prefix << "static_heur = " << static_heur << endl;
 		out << display_prefix << "display_counting_process = " << display_counting_process << endl;
 		out << display_prefix << "profile_counting = " << profile_counting << endl;
+		out << display_prefix << "checkpoint_file = " << ( checkpoint_file == nullptr ? "none" : checkpoint_file ) << endl;
+		out << display_prefix << "checkpoint_interval = " << checkpoint_interval << endl;
+		out << display_prefix << "resume_from_checkpoint = " << resume_from_checkpoint << endl;
 		/// partial kc
 		out << display_prefix << "estimate_marginal_probability = " << estimate_marginal_probability << endl;
 		out << display_prefix << "adaptive_sampling = " << adaptive_sampling << endl;
@@ -734,6 +918,9 @@ struct Running_Options
 		out << display_prefix << "sampling_time = " << sampling_time << endl;
 		out << display_prefix << "sampling_count = " << sampling_count << endl;
 		out << display_prefix << "sample_display_interval = " << sampling_display_interval << endl;
+		out << display_prefix << "sampling_num_threads = " << sampling_num_threads << endl;
+		out << display_prefix << "evict_cold_nodes = " << evict_cold_nodes << endl;
+		out << display_prefix << "eviction_ratio = " << eviction_ratio << endl;
 		out << display_prefix << "profile_partial_kc = " << profile_partial_kc << endl;
 		/// oracle
 		out << display_prefix << "profile_oracle = " << profile_oracle << endl;
@@ -780,6 +967,11 @@ struct Debug_Options
 
 struct Statistics
 {
+	Statistics()
+	{
+		Init_Partial_KC();
+		time_count = 0;
+	}
 	/// solver
 	double time_solve;
 	double time_external_solve;
@@ -863,11 +1055,13 @@ struct Statistics
 	double time_compile;
 	double time_gen_cnf_cache;
 	double time_gen_dag;
+	unsigned num_cache_hits;
 	void Init_Compiler_Single()
 	{
 		time_compile = 0;
 		time_gen_cnf_cache = 0;
 		time_gen_dag = 0;
+		num_cache_hits = 0;
 	}
 	void Init_Compiler()
 	{
@@ -899,6 +1093,50 @@ struct Statistics
 		Init_Extensive_Inprocessor();
 		Init_Partial_KC_Single();
 	}
+	void Write_JSON( JSON_Writer & writer ) const  // times are in seconds
+	{
+		writer.Begin_Object( "solver" );
+		writer.Field( "time_solve", time_solve );
+		writer.Field( "time_external_solve", time_external_solve );
+		writer.Field( "num_solve", num_solve );
+		writer.Field( "num_unsat_solve", num_unsat_solve );
+		writer.Field( "num_external_solve", num_external_solve );
+		writer.Field( "num_binary_learnt", num_binary_learnt );
+		writer.Field( "num_learnt", num_learnt );
+		writer.End_Object();
+		writer.Begin_Object( "preprocess" );
+		writer.Field( "time_preprocess", time_preprocess );
+		writer.Field( "time_block_clauses", time_block_clauses );
+		writer.Field( "time_block_lits", time_block_lits );
+		writer.Field( "time_replace_lit_equivalences", time_replace_lit_equivalences );
+		writer.Field( "time_replace_gates", time_replace_gates );
+		writer.End_Object();
+		writer.Begin_Object( "inprocess" );
+		writer.Field( "time_tree_decomposition", time_tree_decomposition );
+		writer.Field( "time_ibcp", time_ibcp );
+		writer.Field( "time_dynamic_decompose", time_dynamic_decompose );
+		writer.Field( "time_dynamic_decompose_sort", time_dynamic_decompose_sort );
+		writer.End_Object();
+		writer.Begin_Object( "kernelize" );
+		writer.Field( "time_kernelize", time_kernelize );
+		writer.Field( "time_kernelize_block_lits", time_kernelize_block_lits );
+		writer.Field( "time_kernelize_vivification", time_kernelize_vivification );
+		writer.Field( "time_kernelize_lit_equ", time_kernelize_lit_equ );
+		writer.Field( "max_kdepth", max_kdepth );
+		writer.Field( "max_non_trivial_kdepth", max_non_trivial_kdepth );
+		writer.Field( "num_kernelizations", num_kernelizations );
+		writer.Field( "num_non_trivial_kernelizations", num_non_trivial_kernelizations );
+		writer.End_Object();
+		writer.Begin_Object( "search" );
+		writer.Field( "time_compile", time_compile );
+		writer.Field( "time_count", time_count );
+		writer.Field( "time_gen_cnf_cache", time_gen_cnf_cache );
+		writer.Field( "time_gen_dag", time_gen_dag );
+		writer.Field( "num_cache_hits", num_cache_hits );
+		writer.Field( "time_simply_counting", time_simply_counting );
+		writer.Field( "time_estimate_marginal_probability", time_estimate_marginal_probability );
+		writer.End_Object();
+	}
 };
 
 
@@ -1,5 +1,6 @@
 #include "Preprocessor.h"
 #include <sys/sysinfo.h>
+#include <thread>
 
 
 namespace KCBox {
@@ -35,6 +36,8 @@ void Preprocessor::Allocate_and_Init_Auxiliary_Memory( Variable max_var )  // To
 	_lit_index = new unsigned [2 * _max_var + 2];
 	_lit_lowlink = new unsigned [2 * _max_var + 2];
 	_active_lits = new Literal [2 * _max_var + 2];
+	_implication_begins = new unsigned [2 * _max_var + 2];
+	_implication_ends = new unsigned [2 * _max_var + 2];
 	_var_map = new Variable [_max_var + 1];
 	_lit_map = new Literal [2 * _max_var + 2];
 	_equivalent_lit_sets = new vector<Literal> [2 * _max_var + 2];
@@ -49,6 +52,8 @@ void Preprocessor::Allocate_and_Init_Auxiliary_Memory( Variable max_var )  // To
 		_model_seen[i + i + 1] = false;
 		_lit_search_state[i + i] = UNSIGNED_UNDEF;
 		_lit_search_state[i + i + 1] = UNSIGNED_UNDEF;
+		_implication_begins[i + i] = UNSIGNED_UNDEF;
+		_implication_begins[i + i + 1] = UNSIGNED_UNDEF;
 	}
 	_lit_appeared[2 * _max_var + 2] = false;
 	_lit_appeared[2 * _max_var + 3] = false;
@@ -70,6 +75,8 @@ void Preprocessor::Free_Auxiliary_Memory()  // NOTE: only called in Allocate_and
 	delete [] _lit_index;  // The last two bits are used to mark 2*_max_var + 2 and 2*_max_var + 3 not assigned
 	delete [] _lit_lowlink;  // The last two bits are used to mark 2*_max_var + 2 and 2*_max_var + 3 not assigned
 	delete [] _active_lits;
+	delete [] _implication_begins;
+	delete [] _implication_ends;
 	delete [] _var_map;
 	delete [] _lit_map;
 	delete [] _equivalent_lit_sets;
@@ -138,7 +145,12 @@ bool Preprocessor::Preprocess( CNF_Formula & cnf, vector<Model *> & models )
 	}
 	bool sat = Preprocess( models );
 	if ( running_options.profile_preprocessing >= Profiling_Abstract ) statistics.time_preprocess += begin_watch.Get_Elapsed_Seconds();
-	if ( !sat ) {
+	if ( budget.Interrupted() ) {  // stopped in solving, where unknown is returned as unsatisfiable
+		if ( running_options.display_preprocessing_process ) {
+			cout << "s UNKNOWN" << endl;
+		}
+	}
+	else if ( !sat ) {
 		if ( running_options.display_preprocessing_process ) {
 			cout << "s UNSATISFIABLE" << endl;
 		}
@@ -763,6 +775,10 @@ bool Preprocessor::Imply_Lit( vector<Model *> & models, Literal lit )
 		unsigned num_restart = 0;
 		double restart_bound = Restart_Bound();
 		while ( ( lifted_sat = Search_Solution( restart_bound ) ) == 2 ) {
+			if ( budget.Interrupted() ) {  // lit is taken as not implied, which is sound
+				Backjump( old_num_levels );
+				return false;
+			}
 			restart_bound *= running_options.sat_restart_trigger_inc;
 			num_restart++;
 			if ( running_options.sat_employ_external_solver && num_restart > running_options.sat_restart_max ) {
@@ -863,7 +879,7 @@ void Preprocessor::Filter_Long_Learnts()
 			_clause_stack[itr - begin] = i;
 			_long_clauses[i++] = *itr;
 		}
-		else if ( itr->Size() <= fixed_len ) _long_clauses[i++] = *itr;
+		else if ( Keep_Long_Learnt( *itr ) ) _long_clauses[i++] = *itr;
 		else itr->Free();
 	}
 	_long_clauses.resize( i );
@@ -1616,15 +1632,17 @@ void Preprocessor::Cluster_Equivalent_Lits()
 			_lit_equivalences[i + i + 1] = ~root;
 		}
 		if ( _lit_equivalences[i + i] != i + i ) {  // NOTE: lit may be changed, so we need to use _lit_equivalences[i + i]
-			unsigned j;
-			for ( j = 0; _lit_equivalences[i + i] != _equivalent_lit_sets[j][0]; j++ ) {}  // find the old entry
+			unsigned j = _lit_index[_lit_equivalences[i + i]];  // find the old entry
+			assert( _lit_equivalences[i + i] == _equivalent_lit_sets[j][0] );
 			_equivalent_lit_sets[j].push_back( Literal( i, false ) );
 			_equivalent_lit_sets[j ^ 0x01].push_back( Literal( i, true ) );
 			_fixed_num_vars++;
 		}
 		else {  // create new entries
+			_lit_index[i + i] = _equivalent_lit_cluster_size;  /// NOTE: _lit_index records the entries of roots
 			singleton[0] = Literal( i, false );
 			_equivalent_lit_sets[_equivalent_lit_cluster_size++] = singleton;
+			_lit_index[i + i + 1] = _equivalent_lit_cluster_size;
 			singleton[0] = Literal( i, true );
 			_equivalent_lit_sets[_equivalent_lit_cluster_size++] = singleton;
 		}
@@ -1641,6 +1659,11 @@ bool Preprocessor::Detect_Lit_Equivalence_Tarjan()
 		}
 		Display_Clauses( cerr, true );  // ToRemove
 	}
+	vector<unsigned> vars( NumVars( _max_var ) );
+	for ( Variable i = Variable::start; i <= _max_var; i++ ) {
+		vars[i - Variable::start] = i;
+	}
+	Generate_Implication_Graph( vars.begin(), vars.end() );
 	for ( Variable i = Variable::start; i <= _max_var; i++ ) {
 		if ( _lit_search_state[i + i] != UNSIGNED_UNDEF || _lit_search_state[i + i + 1] != UNSIGNED_UNDEF ) continue;
 		if ( _lit_equivalences[i + i] != i + i ) continue;
@@ -1650,6 +1673,7 @@ bool Preprocessor::Detect_Lit_Equivalence_Tarjan()
 		_lit_search_state[i + i] = UNSIGNED_UNDEF;
 		_lit_search_state[i + i + 1] = UNSIGNED_UNDEF;
 	}
+	Clear_Implication_Graph( vars.begin(), vars.end() );
 	unsigned old_fixed_num_vars = _fixed_num_vars;
 	Cluster_Equivalent_Lits();  // _fixed_num_vars will change in the function
 	if ( DEBUG_OFF ) {  // ToModify
@@ -1691,6 +1715,34 @@ bool Preprocessor::Detect_Lit_Equivalence_Tarjan()
 	return old_fixed_num_vars < _fixed_num_vars;
 }
 
+void Preprocessor::Generate_Implication_Graph( vector<unsigned>::const_iterator begin, vector<unsigned>::const_iterator end )
+{
+	vector<unsigned>::const_iterator itr;
+	_implication_targets.clear();
+	for ( itr = begin; itr < end; itr++ ) {  // mark the literals in the graph
+		_implication_begins[*itr + *itr] = 0;
+		_implication_begins[*itr + *itr + 1] = 0;
+	}
+	for ( itr = begin; itr < end; itr++ ) {
+		for ( unsigned lit = *itr + *itr; lit <= *itr + *itr + 1; lit++ ) {  /// a or b means that (not a) -> b is an edge
+			_implication_begins[lit] = _implication_targets.size();
+			vector<Literal> & successors = _binary_clauses[lit ^ 0x01];
+			for ( unsigned i = 0; i < successors.size(); i++ ) {
+				if ( _implication_begins[successors[i]] != UNSIGNED_UNDEF ) _implication_targets.push_back( successors[i] );
+			}
+			_implication_ends[lit] = _implication_targets.size();
+		}
+	}
+}
+
+void Preprocessor::Clear_Implication_Graph( vector<unsigned>::const_iterator begin, vector<unsigned>::const_iterator end )
+{
+	for ( ; begin < end; begin++ ) {
+		_implication_begins[*begin + *begin] = UNSIGNED_UNDEF;
+		_implication_begins[*begin + *begin + 1] = UNSIGNED_UNDEF;
+	}
+}
+
 void Preprocessor::Strongly_Connected_Component( Literal source )
 {
 	Literal top, lit;
@@ -1699,31 +1751,27 @@ void Preprocessor::Strongly_Connected_Component( Literal source )
 	_lit_stack[size++] = source;  // push to _lit_stack
 	_active_lits[capacity++] = source;  // push to _active_lits
 	_lit_seen[source] = true;  // mark active literals
-	_lit_search_state[source] = 0;
+	_lit_search_state[source] = _implication_begins[source];  /// NOTE: _lit_search_state records the position of the next successor
 	_lit_index[source] = index++;
 	_lit_lowlink[source] = _lit_index[source];
 	while ( size > 0 ) {
 		top = _lit_stack[size - 1];
-		if ( _lit_search_state[top] < _binary_clauses[~top].size() ) {  /// a or b means that (not a) -> b is an edge
-			lit = _binary_clauses[~top][_lit_search_state[top]];
+		if ( _lit_search_state[top] < _implication_ends[top] ) {
+			lit = _implication_targets[_lit_search_state[top]++];
 			if ( _lit_search_state[lit] == UNSIGNED_UNDEF ) {
 				_lit_stack[size++] = lit;  // push to _lit_stack
 				_active_lits[capacity++] = lit;  // push to _active_lits
 				_lit_seen[lit] = true;
-				_lit_search_state[lit] = 0;
+				_lit_search_state[lit] = _implication_begins[lit];
 				_lit_index[lit] = index++;
 				_lit_lowlink[lit] = _lit_index[lit];
 			}
-			_lit_search_state[top]++;
+			/** NOTE:
+			** only consider the active literals (excluding the literals searched by different callings or from different branches without loop)
+			**/
+			else if ( _lit_seen[lit] && _lit_index[lit] < _lit_lowlink[top] ) _lit_lowlink[top] = _lit_index[lit];
 		}
 		else {
-			for ( unsigned i = 0; i < _binary_clauses[~top].size(); i++ ) {
-				lit = _binary_clauses[~top][i];
-				/** NOTE:
-				** only consider the active literals (excluding the literals searched by different callings or from different branches without loop)
-				**/
-				if ( _lit_seen[lit] && _lit_lowlink[lit] < _lit_lowlink[top] ) _lit_lowlink[top] = _lit_lowlink[lit];
-			}
 			if ( _lit_lowlink[top] == _lit_index[top] ) {
 				Literal min = top;
 				for ( unsigned i = capacity - 1; _active_lits[i] != top; i-- ) {  // NOTE: _lit_equivalences[lit] is not greater than lit
@@ -1742,6 +1790,9 @@ void Preprocessor::Strongly_Connected_Component( Literal source )
 				capacity--;  // pop top in _active_lits
 			}
 			size--;  // pop top in _lit_stack
+			if ( size > 0 && _lit_lowlink[top] < _lit_lowlink[_lit_stack[size - 1]] ) {
+				_lit_lowlink[_lit_stack[size - 1]] = _lit_lowlink[top];
+			}
 		}
 	}
 	assert( size == 0 && capacity == 0 );
@@ -1918,6 +1969,7 @@ void Preprocessor::Add_Binary_Clause_Naive_Half( Literal lit1, Literal lit2 )
 
 bool Preprocessor::Detect_Lit_Equivalence_BCP()
 {
+	if ( running_options.lit_equivalence_num_threads != 1 ) return Detect_Lit_Equivalence_BCP_Parallel();
 	unsigned old_num_d_stack = _num_dec_stack;
 	vector<Literal> neg_implied_literals, pos_implied_literals;
 	for ( Variable i = Variable::start; i <= _max_var; i++ ) {
@@ -1936,26 +1988,155 @@ bool Preprocessor::Detect_Lit_Equivalence_BCP()
 			pos_implied_literals[j - old_num_d_stack - 1] = _dec_stack[j];
 		}
 		Un_BCP( old_num_d_stack );
-		if ( neg_implied_literals.empty() || pos_implied_literals.empty() ) continue;
-		_lit_seen[neg_implied_literals[0]] = true;
-		for ( unsigned j = 1; j < neg_implied_literals.size(); j++ ) {
-			_lit_seen[neg_implied_literals[j]] = true;
-		}
-		for ( unsigned j = 0; j < pos_implied_literals.size(); j++ ) {
-			Literal lit = pos_implied_literals[j];
-			if ( !_lit_seen[~lit] ) continue;
-			Record_Equivalent_Lit_Pair( Literal( i, true ), lit );
+		Record_Equivalent_Lits_By_Implications( i, neg_implied_literals, pos_implied_literals );
+	}
+	unsigned old_fixed_num_vars = _fixed_num_vars;
+	Cluster_Equivalent_Lits();  // _fixed_num_vars will change in the function
+	return old_fixed_num_vars < _fixed_num_vars;
+}
+
+void Preprocessor::Record_Equivalent_Lits_By_Implications( Variable var, vector<Literal> & neg_implied_literals, vector<Literal> & pos_implied_literals )
+{
+	if ( neg_implied_literals.empty() || pos_implied_literals.empty() ) return;
+	_lit_seen[neg_implied_literals[0]] = true;
+	for ( unsigned j = 1; j < neg_implied_literals.size(); j++ ) {
+		_lit_seen[neg_implied_literals[j]] = true;
+	}
+	for ( unsigned j = 0; j < pos_implied_literals.size(); j++ ) {
+		Literal lit = pos_implied_literals[j];
+		if ( !_lit_seen[~lit] ) continue;
+		Record_Equivalent_Lit_Pair( Literal( var, true ), lit );
+	}
+	_lit_seen[neg_implied_literals[0]] = false;
+	for ( unsigned j = 1; j < neg_implied_literals.size(); j++ ) {
+		_lit_seen[neg_implied_literals[j]] = false;
+	}
+}
+
+bool Preprocessor::Detect_Lit_Equivalence_BCP_Parallel()
+{
+	unsigned num_threads = running_options.lit_equivalence_num_threads;
+	if ( num_threads == 0 ) num_threads = std::max( std::thread::hardware_concurrency(), 1u );
+	vector<unsigned> vars;
+	for ( Variable i = Variable::start; i <= _max_var; i++ ) {
+		if ( Var_Undecided( i ) ) vars.push_back( i );
+	}
+	Generate_Implication_Graph( vars.begin(), vars.end() );
+	Generate_Long_Occurrence_Lists();
+	const unsigned batch_size = 1024 * num_threads;  /// bound the memory of implied literals
+	vector<Literal> probes;
+	vector<vector<Literal>> implied_lits;
+	for ( unsigned i = 0; i < vars.size(); ) {
+		probes.clear();
+		for ( ; i < vars.size() && probes.size() < 2 * batch_size; i++ ) {
+			probes.push_back( Literal( Variable( vars[i] ), false ) );
+			probes.push_back( Literal( Variable( vars[i] ), true ) );
 		}
-		_lit_seen[neg_implied_literals[0]] = false;
-		for ( unsigned j = 1; j < neg_implied_literals.size(); j++ ) {
-			_lit_seen[neg_implied_literals[j]] = false;
+		Implied_Literals_Approx_Parallel( probes, implied_lits );
+		for ( unsigned j = 0; j < probes.size(); j += 2 ) {
+			Record_Equivalent_Lits_By_Implications( probes[j].Var(), implied_lits[j], implied_lits[j + 1] );
 		}
 	}
+	Clear_Implication_Graph( vars.begin(), vars.end() );
 	unsigned old_fixed_num_vars = _fixed_num_vars;
 	Cluster_Equivalent_Lits();  // _fixed_num_vars will change in the function
 	return old_fixed_num_vars < _fixed_num_vars;
 }
 
+void Preprocessor::Generate_Long_Occurrence_Lists()
+{
+	_long_occurrence_offsets.assign( 2 * _max_var + 3, 0 );
+	vector<Clause>::iterator itr, begin = _long_clauses.begin(), end = _long_clauses.end();
+	for ( itr = begin; itr < end; itr++ ) {
+		for ( unsigned i = 0; i < itr->Size(); i++ ) {
+			_long_occurrence_offsets[(*itr)[i] + 1]++;
+		}
+	}
+	for ( unsigned lit = 1; lit < _long_occurrence_offsets.size(); lit++ ) {
+		_long_occurrence_offsets[lit] += _long_occurrence_offsets[lit - 1];
+	}
+	_long_occurrences.resize( _long_occurrence_offsets.back() );
+	vector<unsigned> positions( _long_occurrence_offsets.begin(), _long_occurrence_offsets.end() - 1 );
+	for ( itr = begin; itr < end; itr++ ) {
+		for ( unsigned i = 0; i < itr->Size(); i++ ) {
+			_long_occurrences[positions[(*itr)[i]]++] = itr - begin;
+		}
+	}
+}
+
+void Preprocessor::Implied_Literals_Approx_Parallel( const vector<Literal> & lits, vector<vector<Literal>> & imp_lits )
+{
+	unsigned num_threads = running_options.lit_equivalence_num_threads;
+	if ( num_threads == 0 ) num_threads = std::max( std::thread::hardware_concurrency(), 1u );
+	if ( lits.size() < 64 * num_threads ) num_threads = 1;  /// not worth to start threads
+	imp_lits.resize( lits.size() );
+	vector<std::thread> workers;
+	for ( unsigned id = 1; id < num_threads; id++ ) {
+		workers.push_back( std::thread( &Preprocessor::Implied_Literals_Approx_Thread, this, std::cref( lits ), id, num_threads, std::ref( imp_lits ) ) );
+	}
+	Implied_Literals_Approx_Thread( lits, 0, num_threads, imp_lits );
+	for ( std::thread & worker: workers ) {
+		worker.join();
+	}
+}
+
+void Preprocessor::Implied_Literals_Approx_Thread( const vector<Literal> & lits, unsigned id, unsigned num_threads, vector<vector<Literal>> & imp_lits )
+{
+	/* NOTE:
+	* Each thread propagates on its own copy of the current assignment and only reads the shared clauses,
+	* and the literals implied by unit propagation do not depend on the order of propagation unless a conflict occurs
+	*/
+	vector<int8_t> values( _max_var + 1 );
+	for ( Variable i = Variable::start; i <= _max_var; i++ ) {
+		values[i] = _assignment[i];
+	}
+	vector<Literal> trail;
+	for ( unsigned k = id; k < lits.size(); k += num_threads ) {
+		trail.clear();
+		trail.push_back( lits[k] );
+		values[lits[k].Var()] = lits[k].Sign();
+		bool conflict = false;
+		for ( unsigned head = 0; head < trail.size() && !conflict; head++ ) {
+			Literal lit = trail[head];
+			for ( unsigned i = _implication_begins[lit]; i < _implication_ends[lit]; i++ ) {
+				Literal imp = _implication_targets[i];
+				if ( values[imp.Var()] == lbool::unknown ) {
+					values[imp.Var()] = imp.Sign();
+					trail.push_back( imp );
+				}
+				else if ( values[imp.Var()] != imp.Sign() ) {
+					conflict = true;
+					break;
+				}
+			}
+			Literal neg = ~lit;
+			for ( unsigned i = _long_occurrence_offsets[neg]; i < _long_occurrence_offsets[neg + 1] && !conflict; i++ ) {
+				Clause & clause = _long_clauses[_long_occurrences[i]];
+				Literal unit = Literal::undef;
+				unsigned j;
+				for ( j = 0; j < clause.Size(); j++ ) {
+					int8_t value = values[clause[j].Var()];
+					if ( value == lbool::unknown ) {
+						if ( unit != Literal::undef ) break;  // two unassigned literals
+						unit = clause[j];
+					}
+					else if ( value == clause[j].Sign() ) break;  // satisfied
+				}
+				if ( j < clause.Size() ) continue;
+				if ( unit == Literal::undef ) conflict = true;
+				else {
+					values[unit.Var()] = unit.Sign();
+					trail.push_back( unit );
+				}
+			}
+		}
+		imp_lits[k].assign( trail.begin() + 1, trail.end() );
+		for ( unsigned i = 0; i < trail.size(); i++ ) {
+			values[trail[i].Var()] = lbool::unknown;
+		}
+	}
+}
+
 bool Preprocessor::Detect_Lit_Equivalence_IBCP()
 {
 	unsigned old_num_d_stack = _num_dec_stack, tmp_num_d_stack;
@@ -2589,7 +2770,12 @@ bool Preprocessor::Preprocess_Sharp( CNF_Formula & cnf, vector<Model *> & models
 	}
 	bool sat = Preprocess_Sharp( models );
 	if ( running_options.profile_preprocessing >= Profiling_Abstract ) statistics.time_preprocess += begin_watch.Get_Elapsed_Seconds();
-	if ( !sat ) {
+	if ( budget.Interrupted() ) {  // stopped in solving, where unknown is returned as unsatisfiable
+		if ( running_options.display_preprocessing_process ) {
+			cout << "s UNKNOWN" << endl;
+		}
+	}
+	else if ( !sat ) {
 		if ( running_options.display_preprocessing_process ) {
 			cout << "s UNSATISFIABLE" << endl;
 		}
@@ -3557,7 +3743,12 @@ bool Preprocessor::Preprocess_Sharp( WCNF_Formula & cnf, vector<Model *> & model
 	}
 	bool sat = Preprocess_Sharp( cnf.Weights(), models );
 	if ( running_options.profile_preprocessing >= Profiling_Abstract ) statistics.time_preprocess += begin_watch.Get_Elapsed_Seconds();
-	if ( !sat ) {
+	if ( budget.Interrupted() ) {  // stopped in solving, where unknown is returned as unsatisfiable
+		if ( running_options.display_preprocessing_process ) {
+			cout << "s UNKNOWN" << endl;
+		}
+	}
+	else if ( !sat ) {
 		if ( running_options.display_preprocessing_process ) {
 			cout << "s UNSATISFIABLE" << endl;
 		}
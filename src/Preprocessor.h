@@ -25,9 +25,14 @@ protected:
 	bool * _model_seen;  // model_seen[lit] is true means that some model satisfies lit
 	Literal * _lit_stack;  // used in recursive algorithm
 	unsigned * _lit_search_state;  // used in Strongly_Connected_Component
-	unsigned * _lit_index;  // used in Strongly_Connected_Component
+	unsigned * _lit_index;  // used in Strongly_Connected_Component, and Cluster_Equivalent_Lits
 	unsigned * _lit_lowlink;  // used in Strongly_Connected_Component
 	Literal * _active_lits;  // used in Strongly_Connected_Component, IBCP
+	unsigned * _implication_begins;  /// CSR of binary implications: the successors of lit are _implication_targets[_implication_begins[lit], _implication_ends[lit])
+	unsigned * _implication_ends;
+	vector<Literal> _implication_targets;
+	vector<unsigned> _long_occurrence_offsets;  // CSR of the long clauses containing each literal, used in parallel probing
+	vector<unsigned> _long_occurrences;
 	Variable * _var_map;  // used for renaming formulas
 	Literal * _lit_map;  // used for renaming formulas
 	vector<Literal> * _equivalent_lit_sets;  // it is sorted and each cluster is also sorted, and used for optimize Replace_Equivalent_Lit()
@@ -75,7 +80,7 @@ protected:
 	void Add_Marked_Model( vector<int8_t> & minisat_model, vector<Model *> & models );
 	void Add_Marked_Model( vector<Model *> & models );
 	inline bool Learnts_Exploded();
-	void Filter_Long_Learnts();  // first delete the learnt clauses with more than 3 literals, and if still exploded, delete all long learnt clauses
+	void Filter_Long_Learnts();  // first delete the learnt clauses out of the retained tiers, and if still exploded, delete all long learnt clauses
 	void Simplify_Binary_Clauses_By_Unary();
 	inline void Remove_Old_Binary_Clause_Half( unsigned lit, unsigned pos );
 	void Simplify_Long_Clauses_By_Unary();
@@ -109,7 +114,9 @@ protected:
 	void Detect_Binary_Learnts_Resolution();
 	void Detect_Binary_Learnts_BCP();
 	bool Detect_Lit_Equivalence_Tarjan();  // using Tarjan's strongly connected components algorithm
-	void Strongly_Connected_Component( Literal source );  /// Tarjan's strongly connected components algorithm, the source is stored as component[0]
+	void Generate_Implication_Graph( vector<unsigned>::const_iterator begin, vector<unsigned>::const_iterator end );  /// only keep the implications between the given variables
+	void Clear_Implication_Graph( vector<unsigned>::const_iterator begin, vector<unsigned>::const_iterator end );
+	void Strongly_Connected_Component( Literal source );  /// Tarjan's strongly connected components algorithm over the implication graph, the source is stored as component[0]
 	bool Detect_Lit_Equivalence_Transitive();  // transitive closure
 	void Cluster_Equivalent_Lits();
 	void Replace_Equivalent_Lit_Binary_Clauses();  // no consider learnt clauses
@@ -119,8 +126,13 @@ protected:
 	void Add_Binary_Clause_Naive_Half( Literal lit1, Literal lit2 );  // only push into _binary_clauses[lit1]
 	void Clear_Equivalent_lit_Sets();
 	bool Detect_Lit_Equivalence_BCP();
+	bool Detect_Lit_Equivalence_BCP_Parallel();
+	void Record_Equivalent_Lits_By_Implications( Variable var, vector<Literal> & neg_implied_literals, vector<Literal> & pos_implied_literals );
 	bool Detect_Lit_Equivalence_IBCP();
 	void Implied_Literals_Approx( Literal lit, vector<Literal> & imp_lits );
+	void Generate_Long_Occurrence_Lists();
+	void Implied_Literals_Approx_Parallel( const vector<Literal> & lits, vector<vector<Literal>> & imp_lits );  /// NOTE: the implication graph and long occurrence lists are required
+	void Implied_Literals_Approx_Thread( const vector<Literal> & lits, unsigned id, unsigned num_threads, vector<vector<Literal>> & imp_lits );
 	void Record_Equivalent_Lit_Pair( Literal lit, Literal lit2 );
 	void Block_Binary_Clauses();
 	bool Non_Unary_Clauses_Empty();
@@ -274,9 +286,24 @@ public:
 			preprocessor.running_options.profile_preprocessing = Profiling_Close;
 		}
 		if ( parameters.competition ) preprocessor.running_options.display_prefix = "c o ";
+		preprocessor.running_options.stats_json_file = parameters.stats_json;
+		preprocessor.Set_Budget( parameters );
+		preprocessor.budget.Start();
 		vector<Model *> models;
 		bool sat = preprocessor.Preprocess( cnf, models );
-		if ( !sat ) {
+		if ( preprocessor.budget.Interrupted() ) {  // the input is the partial result
+			cerr << "Warning[PreLite]: " << Run_Status_Name( preprocessor.budget.Status() ) << ", and the input is output unprocessed!" << endl;
+			cnf_fin.open( infile );
+			CNF_Formula input( cnf_fin );
+			cnf_fin.close();
+			if ( parameters.out_file == nullptr ) cout << input;
+			else {
+				ofstream fout( parameters.out_file );
+				fout << input;
+				fout.close();
+			}
+		}
+		else if ( !sat ) {
 			if ( parameters.out_file == nullptr ) {
 				cout << "p cnf 1 2" << endl;
 				cout << "1 0" << endl;
@@ -298,6 +325,7 @@ public:
 			preprocessor.Display_Processed_Clauses( fout );
 			fout.close();
 		}
+		if ( parameters.stats_json.Exists() ) Write_Statistics_File( preprocessor, parameters.stats_json );
 		preprocessor.Reset();
 	}
 };
@@ -345,6 +345,8 @@ public:
 			while ( BLANK_CHAR( *p ) ) p++;
 		}
  	}
+	void Write_Binary( Variable max_var, ostream & out ) { out.write( (const char *) bits, Size( max_var ) * sizeof(unsigned) ); }  // used by checkpoints
+	bool Read_Binary( Variable max_var, istream & in ) { return (bool) in.read( (char *) bits, Size( max_var ) * sizeof(unsigned) ); }
 	void Display( unsigned max_var, ostream & fout )
 	{
 		fout << "[" << num_copy << "]: ";
@@ -362,8 +364,8 @@ public:
 		}
 		fout << endl;
 	}
-protected:
-	unsigned Size( Variable max_var )
+public:
+	static unsigned Size( Variable max_var )
 	{
 		return ( max_var - Variable::start + 1 + UNSIGNED_SIZE - 1 ) / UNSIGNED_SIZE;
 	}
@@ -376,8 +378,10 @@ protected:
 	Model * _allocated;  // Doubly linked list with a sentinel node
 	Model * _unallocated;  // Singly linked list
 	unsigned _alloc_size;  // the size of doubly linked list
+	size_t _num_models;  // all models owned, including the sentinel and the unallocated ones
+	Memory_Account<Memory_Models> _memory;
 public:
-	Model_Pool( Variable max_var, unsigned capacity = 0 ) : _max_var( max_var ), _alloc_size( 0 )
+	Model_Pool( Variable max_var, unsigned capacity = 0 ) : _max_var( max_var ), _alloc_size( 0 ), _num_models( 1 + capacity )
 	{
 		_allocated = new Model( max_var );
 		_allocated->pre = _allocated;
@@ -388,6 +392,7 @@ public:
 			model->next = _unallocated;
 			_unallocated = model;
 		}
+		Update_Memory();
 	}
 	~Model_Pool()
 	{
@@ -422,6 +427,8 @@ public:
 			_unallocated = _unallocated->next;
 			delete tmp;
 		}
+		_num_models = _alloc_size + 1;
+		Update_Memory();
 	}
 	void Reset_Max_Var( Variable new_max_var )
 	{
@@ -443,6 +450,9 @@ public:
 		_allocated->pre = _allocated;
 		_allocated->next = _allocated;
 		_unallocated = NULL;
+		_alloc_size = 0;
+		_num_models = 1;
+		Update_Memory();
 	}
 	void Shrink_Max_Var( Variable new_max_var, Variable var_map[] )
 	{
@@ -470,6 +480,8 @@ public:
 		}
 		_max_var = new_max_var;
 		_unallocated = nullptr;
+		_num_models = _alloc_size + 1;
+		Update_Memory();
 	}
 	Model * Allocate()
 	{
@@ -481,6 +493,8 @@ public:
 				model->next = _unallocated;
 				_unallocated = model;
 			}
+			_num_models += 512;
+			Update_Memory();
  		}
 		model = _unallocated;
 		_unallocated = _unallocated->next;
@@ -536,7 +550,7 @@ public:
 		}
 		return capa + _alloc_size;
 	}
-	size_t Memory() const { return Capacity() * ( sizeof(Model) + ( _max_var - Variable::start + 1 ) / 8 ); }
+	size_t Memory() const { return _memory; }
 	bool Empty() const { return _allocated->next == _allocated; }
 	void Display( ostream & fout )
 	{
@@ -545,6 +559,8 @@ public:
 			itr->Display( _max_var, fout );
 		}
 	}
+protected:
+	void Update_Memory() { _memory = _num_models * ( sizeof(Model) + Model::Size( _max_var ) * sizeof(unsigned) ); }
 };
 
 
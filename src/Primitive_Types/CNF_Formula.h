@@ -4,6 +4,7 @@
 #include "../Template_Library/Basic_Functions.h"
 #include "../Template_Library/Basic_Structures.h"
 #include "../Template_Library/BigNum.h"
+#include "../Template_Library/Time_Memory.h"
 #include "../Template_Library/Graph_Structures.h"
 
 
@@ -168,34 +169,36 @@ class Clause
 protected:
 	Literal * _lits;  /// NOTE: need to call Free() to free the memory outside
 	unsigned _size;
+	unsigned _lbd: 30;  /// NOTE: literal block distance when learnt, and zero for the other clauses; it fills the padding after _size
+	unsigned _used: 2;  // recently used in conflict analysis, which decides whether a long learnt clause survives filtering
 public:
-	Clause(): _lits( nullptr ), _size( 0 ) {}
-	Clause( Literal lit ): _size( 1 )
+	Clause(): _lits( nullptr ), _size( 0 ), _lbd( 0 ), _used( 0 ) {}
+	Clause( Literal lit ): _size( 1 ), _lbd( 0 ), _used( 0 )
 	{
 		Allocate_Memory();
 		_lits[0] = lit;
 	}
-	Clause( Literal lit0, Literal lit1 ): _size( 2 )
+	Clause( Literal lit0, Literal lit1 ): _size( 2 ), _lbd( 0 ), _used( 0 )
 	{
 		Allocate_Memory();
 		_lits[0] = lit0;
 		_lits[1] = lit1;
 	}
-	Clause( const Literal * lits, unsigned size ): _size( size )
+	Clause( const Literal * lits, unsigned size ): _size( size ), _lbd( 0 ), _used( 0 )
 	{
 		Allocate_Memory();
 		for ( unsigned i = 0; i < size; i++ ) {
 			_lits[i] = lits[i];
 		}
 	}
-	Clause( const vector<Literal> & lits ): _size( lits.size() )
+	Clause( const vector<Literal> & lits ): _size( lits.size() ), _lbd( 0 ), _used( 0 )
 	{
 		Allocate_Memory();
 		for ( unsigned i = 0; i < _size; i++ ) {
 			_lits[i] = lits[i];
 		}
 	}
-	Clause( Big_Clause & clause ): _size ( clause.Size() )
+	Clause( Big_Clause & clause ): _size ( clause.Size() ), _lbd( 0 ), _used( 0 )
 	{
 		Allocate_Memory();
 		for ( unsigned i = 0; i < _size; i++ ) {
@@ -203,18 +206,38 @@ public:
 		}
 	}
 	Clause Copy() const { return Clause( _lits, _size ); }  /// NOTE: the object created by copy constructor will share the same memory
-	void Free() { delete [] _lits; }
+	void Free()
+	{
+		Memory_Ledger::Release( Memory_Clauses, _size * sizeof(Literal) );
+		delete [] _lits;
+	}
 	unsigned Size() const { return _size; }
-	void Shrink( unsigned size ) { assert( size <= _size ); _size = size; }
+	void Shrink( unsigned size )  /// NOTE: the ledger counts the live literals, so the cut ones are released though still allocated
+	{
+		assert( size <= _size );
+		Memory_Ledger::Release( Memory_Clauses, ( _size - size ) * sizeof(Literal) );
+		_size = size;
+	}
+	unsigned LBD() const { return _lbd; }
+	void Set_LBD( unsigned lbd ) { _lbd = lbd < 0x3FFFFFFF ? lbd : 0x3FFFFFFF; }
+	unsigned Used() const { return _used; }
+	void Mark_Used() { _used = 2; }
+	void Set_Used( unsigned used ) { assert( used <= 2 ); _used = used; }
 	Literal & operator [] ( unsigned i ) { return _lits[i]; }
 	Literal & Last_Lit() { return _lits[_size - 1]; }  /// NOTE: this clause cannot be empty
-	void Erase_Lit( unsigned i ) { assert( i < _size ); _lits[i] = _lits[--_size]; }
+	void Erase_Lit( unsigned i ) { assert( i < _size ); _lits[i] = _lits[--_size]; Memory_Ledger::Release( Memory_Clauses, sizeof(Literal) ); }
 	void Swap_Lits( unsigned i, unsigned j ) { Literal tmp = _lits[i]; _lits[i] = _lits[j]; _lits[j] = tmp; }
 	void Swap( Clause & clause )
 	{
 		unsigned tmp_size = _size;
 		_size = clause._size;
 		clause._size = tmp_size;
+		tmp_size = _lbd;
+		_lbd = clause._lbd;
+		clause._lbd = tmp_size;
+		tmp_size = _used;
+		_used = clause._used;
+		clause._used = tmp_size;
 		Literal * tmp_lits = _lits;
 		_lits = clause._lits;
 		clause._lits = tmp_lits;
@@ -242,6 +265,7 @@ protected:
 			cerr << "ERROR[Clause]: fail for allocating space for clause!" << endl;
 			exit( 1 );
 		}
+		Memory_Ledger::Charge( Memory_Clauses, _size * sizeof(Literal) );
 	}
 };
 
@@ -0,0 +1,468 @@
+#include "Template_Library/Basic_Functions.h"
+#include "Template_Library/Time_Memory.h"
+#include "Template_Library/Options.h"
+#include "Primitive_Types/CNF_Formula.h"
+#include <map>
+#include <sstream>
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace KCBox;
+
+
+/****************************************************************************************************
+*                                                                                                   *
+*                                         Parameters                                                *
+*                                                                                                   *
+****************************************************************************************************/
+
+struct Regression_Parameters: public Tool_Parameters
+{
+	StringOption kcbox;
+	StringOption solvers;
+	StringOption engines;
+	StringOption results;
+	StringOption csv;
+	BoolOption update;
+	IntOption timeout;
+	IntOption samples;
+	FloatOption threshold;
+	FloatOption noise;
+	FloatOption memory_threshold;
+	FloatOption memory_noise;
+	Regression_Parameters( const char * tool_name ): Tool_Parameters( tool_name ),
+		kcbox( "--kcbox", "the KCBox binary under test", "./KCBox" ),
+		solvers( "--solvers", "the directory of the bundled tools, which are skipped when missing", "solvers" ),
+		engines( "--engines", "the comma-separated engines among ExactMC, Panini, FastUS, sharpSAT, dsharp, miniC2D, pmc+ExactMC and B+E+ExactMC", "ExactMC,Panini,FastUS,sharpSAT,dsharp,miniC2D,pmc+ExactMC,B+E+ExactMC" ),
+		results( "--results", "the tracked results CSV which the times and memory are compared with", nullptr ),
+		csv( "--csv", "the CSV file to which this run is written", nullptr ),
+		update( "--update", "rewrite --results with this run when no count mismatches" ),
+		timeout( "--timeout", "the time limit in seconds of each run", 300, 1, 86400 ),
+		samples( "--samples", "the number of samples drawn by FastUS", 20, 1, 1000000 ),
+		threshold( "--threshold", "the tolerated relative slowdown of the wall time of the KCBox engines", 0.5 ),
+		noise( "--noise", "the slowdown in seconds which is always tolerated", 0.25 ),
+		memory_threshold( "--memory-threshold", "the tolerated relative growth of the peak RSS of the KCBox engines", 0.25 ),
+		memory_noise( "--memory-noise", "the growth in MB of the peak RSS which is always tolerated", 16 )
+	{
+		Add_Option( &kcbox );
+		Add_Option( &solvers );
+		Add_Option( &engines );
+		Add_Option( &results );
+		Add_Option( &csv );
+		Add_Option( &update );
+		Add_Option( &timeout );
+		Add_Option( &samples );
+		Add_Option( &threshold );
+		Add_Option( &noise );
+		Add_Option( &memory_threshold );
+		Add_Option( &memory_noise );
+	}
+	bool Parse_Parameters( int & i, int argc, const char *argv[] )
+	{
+		if ( !Tool_Parameters::Parse_Parameters( i, argc, argv ) ) return false;
+		if ( threshold < 0 || noise < 0 || memory_threshold < 0 || memory_noise < 0 ) {
+			cerr << "ERROR: --threshold, --noise, --memory-threshold and --memory-noise must be nonnegative!" << endl;
+			return false;
+		}
+		if ( update && !results.Exists() ) {
+			cerr << "ERROR: --update needs --results!" << endl;
+			return false;
+		}
+		return true;
+	}
+} regress_parameters( "kcbox-regress" );
+
+
+/****************************************************************************************************
+*                                                                                                   *
+*                                           Engines                                                 *
+*                                                                                                   *
+****************************************************************************************************/
+
+enum Regression_Engine
+{
+	engine_exactmc = 0,
+	engine_panini,
+	engine_fastus,
+	engine_sharpsat,
+	engine_dsharp,
+	engine_minic2d,
+	engine_pmc,
+	engine_be,
+	engine_invalid
+};
+
+const char * engine_names[] = {"ExactMC", "Panini", "FastUS", "sharpSAT", "dsharp", "miniC2D", "pmc+ExactMC", "B+E+ExactMC"};
+
+const char * output_file = "kcbox-regress-output.txt";
+const char * samples_file = "kcbox-regress-samples.txt";
+const char * preprocessed_file = "kcbox-regress-preprocessed.cnf";
+
+Regression_Engine Parse_Engine( const string & name )
+{
+	for ( unsigned i = 0; i < engine_invalid; i++ ) {
+		if ( name == engine_names[i] ) return Regression_Engine( i );
+	}
+	return engine_invalid;
+}
+
+bool Is_Bundled( Regression_Engine engine ) { return engine >= engine_sharpsat; }  /// NOTE: only the engines of KCBox itself are judged on time and memory
+
+string Bundled_Tool( Regression_Engine engine )
+{
+	const char * tools[] = {"sharpSAT", "dsharp", "miniC2D", "pmc_linux", "B+E_linux"};
+	return string( regress_parameters.solvers ) + "/" + tools[engine - engine_sharpsat];
+}
+
+vector<string> Engine_Command( Regression_Engine engine, const string & instance )
+{
+	string kcbox( regress_parameters.kcbox );
+	switch ( engine ) {
+	case engine_exactmc:
+		return { kcbox, "ExactMC", instance };
+	case engine_panini:
+		return { kcbox, "Panini", "--lang", "CCDD", "--CT", instance };
+	case engine_fastus:
+		return { kcbox, "FastUS", "--nsamples", to_string( (int) regress_parameters.samples ), "--out", samples_file, instance };
+	case engine_sharpsat:
+		return { Bundled_Tool( engine ), instance };
+	case engine_dsharp:
+		return { Bundled_Tool( engine ), "-count", instance };
+	case engine_minic2d:
+		return { Bundled_Tool( engine ), "-c", instance, "-C", "-m", "4", "-i" };  // minfill vtree, which needs no helper binary
+	case engine_pmc:  // the options of pmc which preserve the model count
+		return { Bundled_Tool( engine ), "-vivification", "-eliminateLit", "-litImplied", "-iterate=10", "-equiv", "-orGate", "-affine", instance };
+	default:
+		return { Bundled_Tool( engine ), instance };
+	}
+}
+
+struct Regression_Run
+{
+	string instance;
+	Regression_Engine engine;
+	string count;  // empty if unknown, and "-" for FastUS
+	double wall;  // in seconds
+	double cpu;  // in seconds, user plus system
+	size_t peak_rss;  // in KB
+	bool ok;
+	double wall_ratio;  // over the tracked results, and 0 if there is none
+	double rss_ratio;
+};
+
+bool Execute( const vector<string> & command, const char * output, Regression_Run & run )  /// NOTE: the times and memory are added to run, so a pipeline sums its stages
+{
+	cout.flush();
+	StopWatch watch;
+	watch.Start();
+	pid_t pid = fork();
+	if ( pid < 0 ) {
+		cerr << "ERROR[kcbox-regress]: cannot fork!" << endl;
+		exit( 1 );
+	}
+	if ( pid == 0 ) {
+		int fd = open( output, O_WRONLY | O_CREAT | O_TRUNC, 0644 );
+		int null_fd = open( "/dev/null", O_WRONLY );
+		if ( fd < 0 || null_fd < 0 ) _exit( 127 );
+		dup2( fd, STDOUT_FILENO );
+		dup2( null_fd, STDERR_FILENO );
+		close( fd );
+		close( null_fd );
+		alarm( regress_parameters.timeout );  // SIGALRM survives exec and terminates a run that is too long
+		vector<char *> argv;
+		for ( const string & arg: command ) argv.push_back( const_cast<char *>( arg.c_str() ) );
+		argv.push_back( nullptr );
+		execv( argv[0], argv.data() );
+		_exit( 127 );
+	}
+	int status;
+	struct rusage usage;
+	if ( wait4( pid, &status, 0, &usage ) != pid ) return false;
+	run.wall += watch.Get_Elapsed_Seconds();
+	run.cpu += usage.ru_utime.tv_sec + usage.ru_stime.tv_sec + ( usage.ru_utime.tv_usec + usage.ru_stime.tv_usec ) / 1000000.0;
+	run.peak_rss = max<size_t>( run.peak_rss, usage.ru_maxrss );  // ru_maxrss is in kilobytes on Linux
+	return WIFEXITED( status ) && WEXITSTATUS( status ) != 127;
+}
+
+string Read_Count( Regression_Engine engine )  // the exact count in the output, or empty
+{
+	ifstream fin( output_file );
+	stringstream buffer;
+	buffer << fin.rdbuf();
+	string output = buffer.str();
+	const char * marker;
+	if ( engine == engine_sharpsat ) marker = "# solutions";
+	else if ( engine == engine_dsharp ) marker = "#SAT (full):";
+	else if ( engine == engine_minic2d ) marker = "Counting...";
+	else marker = "Number of models:";
+	size_t pos = output.rfind( marker );
+	if ( pos == string::npos ) return "";
+	stringstream sin( output.substr( pos + strlen( marker ) ) );
+	string count;
+	sin >> count;  // the count may be on the next line
+	if ( count.empty() || count.find_first_not_of( "0123456789" ) != string::npos ) count = "";
+	if ( count.empty() && engine == engine_dsharp && output.find( "Theory is unsat" ) != string::npos ) count = "0";
+	return count;
+}
+
+bool Valid_Samples( CNF_Formula & cnf, unsigned expected )  // each line of samples_file satisfies cnf, and there are expected lines
+{
+	ifstream fin( samples_file );
+	string line;
+	unsigned num_samples = 0;
+	vector<int> values( cnf.Max_Var() + 1, 0 );  // 1 for true, -1 for false, and 0 for unassigned
+	while ( getline( fin, line ) ) {
+		if ( line.find_first_not_of( " \t\r" ) == string::npos ) continue;
+		num_samples++;
+		fill( values.begin(), values.end(), 0 );
+		stringstream sin( line );
+		int lit;
+		while ( sin >> lit ) {
+			unsigned var = abs( lit );
+			if ( var == 0 || var >= values.size() ) return false;
+			values[var] = lit > 0 ? 1 : -1;
+		}
+		for ( unsigned i = 0; i < cnf.Num_Clauses(); i++ ) {
+			Clause & clause = cnf[i];
+			unsigned j = 0;
+			for ( ; j < clause.Size(); j++ ) {
+				int ext = ExtLit( clause[j] );
+				if ( values[abs( ext )] == ( ext > 0 ? 1 : -1 ) ) break;
+			}
+			if ( j == clause.Size() ) return false;
+		}
+	}
+	return num_samples == expected;
+}
+
+void Run_Engine( Regression_Engine engine, const string & instance, Regression_Run & run )
+{
+	run.count = "";
+	run.wall = run.cpu = 0;
+	run.peak_rss = 0;
+	run.wall_ratio = run.rss_ratio = 0;
+	if ( engine == engine_pmc || engine == engine_be ) {
+		run.ok = Execute( Engine_Command( engine, instance ), preprocessed_file, run );
+		run.ok = run.ok && Execute( Engine_Command( engine_exactmc, preprocessed_file ), output_file, run );
+	}
+	else run.ok = Execute( Engine_Command( engine, instance ), output_file, run );
+	if ( engine == engine_fastus ) run.count = "-";
+	else if ( run.ok ) run.count = Read_Count( engine );
+	run.ok = run.ok && !run.count.empty();
+}
+
+
+/****************************************************************************************************
+*                                                                                                   *
+*                                          Reports                                                  *
+*                                                                                                   *
+****************************************************************************************************/
+
+void Write_CSV( ostream & out, vector<Regression_Run> & runs )
+{
+	out << "instance,engine,count,wall,cpu,peak_rss_kb,ok,wall_ratio,rss_ratio" << endl;
+	for ( Regression_Run & run: runs ) {
+		out << run.instance << "," << engine_names[run.engine] << "," << run.count << ",";
+		out << run.wall << "," << run.cpu << "," << run.peak_rss << "," << run.ok << ",";
+		out << run.wall_ratio << "," << run.rss_ratio << endl;
+	}
+}
+
+bool Read_CSV( const char * file, map<pair<string, unsigned>, Regression_Run> & runs )
+{
+	ifstream fin( file );
+	if ( !fin.is_open() ) return false;
+	string line;
+	getline( fin, line );  // header
+	while ( getline( fin, line ) ) {
+		if ( line.empty() ) continue;
+		vector<string> fields;
+		size_t begin = 0, end;
+		while ( ( end = line.find( ',', begin ) ) != string::npos ) {
+			fields.push_back( line.substr( begin, end - begin ) );
+			begin = end + 1;
+		}
+		fields.push_back( line.substr( begin ) );
+		if ( fields.size() != 9 || Parse_Engine( fields[1] ) == engine_invalid ) return false;
+		Regression_Run run;
+		run.instance = fields[0];
+		run.engine = Parse_Engine( fields[1] );
+		run.count = fields[2];
+		run.wall = atof( fields[3].c_str() );
+		run.cpu = atof( fields[4].c_str() );
+		run.peak_rss = atol( fields[5].c_str() );
+		run.ok = fields[6] == "1";
+		run.wall_ratio = atof( fields[7].c_str() );
+		run.rss_ratio = atof( fields[8].c_str() );
+		runs[make_pair( run.instance, (unsigned) run.engine )] = run;
+	}
+	return true;
+}
+
+unsigned Compare_With_Results( vector<Regression_Run> & runs, map<pair<string, unsigned>, Regression_Run> & tracked )  // return the number of regressions
+{
+	unsigned num_regressions = 0;
+	double threshold = regress_parameters.threshold, noise = regress_parameters.noise;
+	double memory_threshold = regress_parameters.memory_threshold, memory_noise = (double) regress_parameters.memory_noise * 1024;  // in KB
+	cout << "instance engine wall_ratio rss_ratio" << endl;
+	for ( Regression_Run & run: runs ) {
+		auto itr = tracked.find( make_pair( run.instance, (unsigned) run.engine ) );
+		if ( itr == tracked.end() || !itr->second.ok || !run.ok ) continue;
+		Regression_Run & old = itr->second;
+		run.wall_ratio = old.wall > 0 ? run.wall / old.wall : 1;
+		run.rss_ratio = old.peak_rss > 0 ? (double) run.peak_rss / old.peak_rss : 1;
+		cout << run.instance << " " << engine_names[run.engine] << " " << run.wall_ratio << " " << run.rss_ratio;
+		if ( Is_Bundled( run.engine ) ) {
+			cout << endl;
+			continue;
+		}
+		bool slower = run.wall > old.wall * ( 1 + threshold ) + noise;
+		bool larger = run.peak_rss > old.peak_rss * ( 1 + memory_threshold ) + memory_noise;
+		if ( slower ) cout << " SLOWDOWN";
+		if ( larger ) cout << " MEMORY";
+		cout << endl;
+		num_regressions += slower || larger;
+	}
+	return num_regressions;
+}
+
+
+/****************************************************************************************************
+*                                                                                                   *
+*                                            Main                                                   *
+*                                                                                                   *
+****************************************************************************************************/
+
+struct Regression_Instance
+{
+	string name;  // as in the manifest, which keys the tracked results
+	string path;
+	string expected;  // the known count, or empty
+};
+
+vector<Regression_Instance> Read_Manifest( const char * manifest )  /// NOTE: one cnf file per line, optionally followed by its count; '#' starts a comment, and relative paths are relative to the manifest
+{
+	ifstream fin( manifest );
+	if ( !fin.is_open() ) {
+		cerr << "ERROR[kcbox-regress]: cannot open " << manifest << "!" << endl;
+		exit( 1 );
+	}
+	string dir( manifest );
+	size_t pos = dir.find_last_of( '/' );
+	dir = pos == string::npos ? "" : dir.substr( 0, pos + 1 );
+	vector<Regression_Instance> instances;
+	string line;
+	while ( getline( fin, line ) ) {
+		stringstream sin( line.substr( 0, line.find( '#' ) ) );
+		Regression_Instance instance;
+		if ( !( sin >> instance.name ) ) continue;
+		sin >> instance.expected;
+		instance.path = instance.name[0] == '/' ? instance.name : dir + instance.name;
+		instances.push_back( instance );
+	}
+	return instances;
+}
+
+vector<Regression_Engine> Parse_Engines( const char * names )
+{
+	vector<Regression_Engine> engines;
+	string list( names );
+	size_t begin = 0, end;
+	do {
+		end = list.find( ',', begin );
+		string name = list.substr( begin, end == string::npos ? string::npos : end - begin );
+		Regression_Engine engine = Parse_Engine( name );
+		if ( engine == engine_invalid ) {
+			cerr << "ERROR[kcbox-regress]: invalid engine \"" << name << "\"!" << endl;
+			exit( 1 );
+		}
+		engines.push_back( engine );
+		begin = end + 1;
+	} while ( end != string::npos );
+	stable_partition( engines.begin(), engines.end(), []( Regression_Engine e ) { return e != engine_fastus; } );  // FastUS needs the count of the others
+	return engines;
+}
+
+int main( int argc, const char *argv[] )
+{
+	int i = 1;
+	if ( !regress_parameters.Parse_Parameters( i, argc, argv ) || i + 1 != argc ) {
+		cerr << "The usage of kcbox-regress [options] manifest:" << endl;
+		regress_parameters.Helper( cerr );
+		return 1;
+	}
+	vector<Regression_Instance> instances = Read_Manifest( argv[i] );
+	vector<Regression_Engine> engines = Parse_Engines( regress_parameters.engines );
+	if ( access( regress_parameters.kcbox, X_OK ) != 0 ) {
+		cerr << "ERROR[kcbox-regress]: cannot execute " << regress_parameters.kcbox << "!" << endl;
+		return 1;
+	}
+	vector<Regression_Run> runs;
+	unsigned num_mismatches = 0, num_failed = 0;
+	for ( Regression_Instance & instance: instances ) {
+		ifstream fin( instance.path );
+		if ( !fin.is_open() ) {
+			cerr << "ERROR[kcbox-regress]: cannot open " << instance.path << "!" << endl;
+			return 1;
+		}
+		CNF_Formula cnf( fin );
+		fin.close();
+		string reference = instance.expected;
+		for ( Regression_Engine engine: engines ) {
+			if ( Is_Bundled( engine ) && access( Bundled_Tool( engine ).c_str(), X_OK ) != 0 ) {
+				cout << instance.name << " " << engine_names[engine] << ": skipped, as " << Bundled_Tool( engine ) << " is missing" << endl;
+				continue;
+			}
+			Regression_Run run;
+			run.instance = instance.name;
+			run.engine = engine;
+			Run_Engine( engine, instance.path, run );
+			if ( engine == engine_fastus && run.ok ) {
+				unsigned expected = reference == "0" ? 0 : (unsigned) regress_parameters.samples;
+				run.ok = !reference.empty() && Valid_Samples( cnf, expected );
+			}
+			cout << instance.name << " " << engine_names[engine] << ": ";
+			if ( run.ok ) cout << run.count << ", " << run.wall << "s wall, " << run.cpu << "s cpu, " << run.peak_rss << " KB peak" << endl;
+			else cout << "failed" << endl;
+			if ( !run.ok && Is_Bundled( engine ) ) {
+				cerr << "Warning[kcbox-regress]: " << engine_names[engine] << " failed on " << instance.name << "!" << endl;
+			}
+			else if ( !run.ok ) num_failed++;
+			else if ( engine != engine_fastus ) {
+				if ( reference.empty() ) reference = run.count;
+				else if ( run.count != reference ) {
+					cerr << "ERROR[kcbox-regress]: " << engine_names[engine] << " counts " << run.count << " on " << instance.name << ", but " << reference << " is expected!" << endl;
+					num_mismatches++;
+				}
+			}
+			runs.push_back( run );
+		}
+	}
+	unlink( output_file );
+	unlink( samples_file );
+	unlink( preprocessed_file );
+	unsigned num_regressions = 0;
+	map<pair<string, unsigned>, Regression_Run> tracked;
+	if ( regress_parameters.results.Exists() && access( regress_parameters.results, F_OK ) == 0 ) {
+		if ( !Read_CSV( regress_parameters.results, tracked ) ) {
+			cerr << "ERROR[kcbox-regress]: cannot read the results " << regress_parameters.results << "!" << endl;
+			return 1;
+		}
+		num_regressions = Compare_With_Results( runs, tracked );
+		cout << num_regressions << " regressions over the tracked results" << endl;
+	}
+	if ( regress_parameters.csv.Exists() ) {
+		ofstream fout( regress_parameters.csv );
+		Write_CSV( fout, runs );
+	}
+	if ( regress_parameters.update && num_mismatches == 0 && num_failed == 0 ) {
+		ofstream fout( regress_parameters.results );
+		Write_CSV( fout, runs );
+		cout << "The tracked results " << regress_parameters.results << " are updated" << endl;
+	}
+	if ( num_mismatches > 0 ) cerr << "ERROR[kcbox-regress]: " << num_mismatches << " counts mismatch!" << endl;
+	if ( num_failed > 0 ) cerr << "ERROR[kcbox-regress]: " << num_failed << " runs of KCBox failed!" << endl;
+	return num_mismatches > 0 || num_failed > 0 || ( num_regressions > 0 && !regress_parameters.update );
+}
@@ -1,4 +1,5 @@
 #include "Solver.h"
+#include "Template_Library/Checkpoint.h"
 #include <sys/sysinfo.h>
 
 
@@ -45,6 +46,7 @@ void Solver::Allocate_and_Init_Auxiliary_Memory( Variable max_var )  // ToDo: wh
 	_heur_sorted_lits = new Literal [2 * _max_var + 4];  // "heur_lits[2 * max_var + 2]" and "heur_lits[2 * max_var + 3]" is sometimes used to reduce the number of iteration
 	_heur_lits_heap.Enlarge_Index( 2 * _max_var + 1, _heur_decaying_sum );
 	_var_rank = new unsigned [2 * _max_var + 2];
+	_level_seen = new bool [NumVars( _max_var ) + 2];
 	_big_clause.Reserve( 2 * NumVars( _max_var ) );  /// NOTE: avoid overflow with tautology
 	_big_learnt.Reserve( _max_var );  // used in learning conflict
 	if ( Hyperscale_Problem() ) _model_pool = new Model_Pool( _max_var, 1 );
@@ -62,6 +64,9 @@ void Solver::Allocate_and_Init_Auxiliary_Memory( Variable max_var )  // ToDo: wh
 		_lit_seen[i + i] = false;
 		_lit_seen[i + i + 1] = false;
 	}
+	for ( unsigned i = 0; i < NumVars( _max_var ) + 2; i++ ) {
+		_level_seen[i] = false;
+	}
 	_var_seen[max_var + 1] = false;
 	_lit_seen[2 * max_var + 2] = false;
 	_lit_seen[2 * max_var + 3] = false;
@@ -77,6 +82,7 @@ void Solver::Free_Auxiliary_Memory()  // NOTE: only called in Allocate_and_Init_
 	delete [] _heur_decaying_sum;  // heur_value[0] and heur_value[1] is sometimes used to reduce the number of iteration	}
 	delete [] _heur_sorted_lits;  // "heur_lits[2 * max_var + 2]" and "heur_lits[2 * max_var + 3]" is sometimes used to reduce the number of iteration
 	delete [] _var_rank;
+	delete [] _level_seen;
 	delete _model_pool;
 }
 
@@ -140,6 +146,7 @@ void Solver::operator = ( Solver & another )
 	*_model_pool = *another._model_pool;
 	running_options = another.running_options;
 	debug_options = another.debug_options;
+	budget = another.budget;  // a continuing engine shares the clock and the status
 }
 
 void Solver::Open_Oracle_Mode( Variable var_bound )
@@ -366,6 +373,7 @@ bool Solver::Solve( vector<Model *> & models )
 	unsigned num_restart = 0;
 	double restart_bound = Restart_Bound();
 	while ( ( lifted_sat = Search_Solution( restart_bound ) ) == 2 ) {
+		if ( budget.Interrupted() ) return false;  /// NOTE: unknown, which the caller needs to check
 		restart_bound *= running_options.sat_restart_trigger_inc;
 		num_restart++;
 		if ( running_options.sat_employ_external_solver && num_restart > running_options.sat_restart_max ) {
@@ -404,9 +412,9 @@ unsigned Solver::Search_Solution( unsigned conf_limit )
 			}
 			Backjump( back_level + 1 );
 			Assign( _big_learnt[0], Add_Learnt_Sort() );
-			if ( _long_clauses.size() - old_size > conf_limit ) {
+			if ( _long_clauses.size() - old_size > conf_limit || ( budget.Active() && budget.Exhausted() ) ) {
 				Backjump( old_num_levels );
-				return 2;  // restart
+				return 2;  // restart, or stop when interrupted
 			}
 			conf = BCP( _num_dec_stack - 1 );
 		}
@@ -548,6 +556,7 @@ unsigned Solver::Analyze_Conflict( Reason confl )
 	if ( confl.Is_Clause_Reason() ) {  /// SAT_IS_REASON_LONG( Reason::undef ) is true but this situation will not appear
 		Clause & clause = _long_clauses[confl.Clause_Value()];
 		assert( _big_learnt[1] == clause[0] );
+		clause.Mark_Used();
 		var = clause[1].Var();
 		_var_seen[var] = true;
 		if ( _var_stamps[var] + 1 == _num_levels ) num_ip++;
@@ -580,6 +589,7 @@ unsigned Solver::Analyze_Conflict( Reason confl )
 		if ( confl.Is_Clause_Reason() ) {
 			Clause & clause = _long_clauses[confl.Clause_Value()];
 			assert( uip == clause[0] );
+			clause.Mark_Used();
 			var = clause[1].Var();
 			if ( !_var_seen[var] ) {
 				_var_seen[var] = true;
@@ -674,6 +684,7 @@ inline Reason Solver::Add_Learnt_Sort()
 		_long_watched_lists[_big_learnt[1]].push_back( _long_clauses.size() );
 		reason = Reason( _long_clauses.size(), SAT_REASON_CLAUSE );
 		_long_clauses.push_back( Clause( _big_learnt ) );  // allocate memory
+		Init_Learnt_Scores( _long_clauses.back() );
 	}
 	Update_Heur_Decaying_Sum();
 	return reason;
@@ -938,6 +949,7 @@ Reason Solver::Add_Learnt_Sort_Component( Component & comp )
 		_long_watched_lists[_big_learnt[1]].push_back( _long_clauses.size() );
 		reason = Reason( _long_clauses.size(), SAT_REASON_CLAUSE );
 		_long_clauses.push_back( Clause( _big_learnt ) );
+		Init_Learnt_Scores( _long_clauses.back() );
 	}
 /*	for ( unsigned i = 0; i < _big_learnt.Size(); i++ ) {
 		assert( Literal::start <= _big_learnt[i] && _big_learnt[i] <= 2 * _max_var + 1 );
@@ -1077,16 +1089,15 @@ void Solver::Filter_Long_Learnts_During_Solving( unsigned old_num_levels, unsign
 		}
 	}
 	unsigned new_size = old_size;
-	const unsigned fixed_len = 3;
 	vector<Clause>::iterator begin = _long_clauses.begin(), end = _long_clauses.end();
 	for ( vector<Clause>::iterator itr = begin + old_size; itr < end; itr++ ) {
 		if ( _clause_status[itr - begin] ) {
 			_clause_stack[itr - begin] = new_size;
 			_long_clauses[new_size++] = *itr;
 		}
-		else if ( itr->Size() <= fixed_len ) _long_clauses[new_size++] = *itr;
+		else if ( Keep_Long_Learnt( *itr ) ) _long_clauses[new_size++] = *itr;
 		else if ( Two_Unassigned_Literals( *itr ) ) _long_clauses[new_size++] = *itr;
-		else if ( ( itr - begin ) % 2 == 0 ) _long_clauses[new_size++] = *itr;
+		else if ( !running_options.sat_learnt_tiers && ( itr - begin ) % 2 == 0 ) _long_clauses[new_size++] = *itr;
 		else itr->Free();
 	}
 	_long_clauses.resize( new_size ), end = _long_clauses.end();
@@ -1137,6 +1148,41 @@ unsigned Solver::Num_Unassigned_Literals( Clause & clause )
 	else return num + Lit_Undecided( clause[i] );
 }
 
+unsigned Solver::Compute_LBD( Big_Clause & learnt )  // NOTE: learnt[0] is the asserting literal, and may be unassigned after backjumping
+{
+	unsigned i, lbd = 1;
+	for ( i = 1; i < learnt.Size(); i++ ) {
+		Variable var = learnt[i].Var();
+		if ( Var_Undecided( var ) || _var_stamps[var] >= _num_levels ) continue;  // NOTE: the literals assigned before any level have the stamp UNSIGNED_UNDEF
+		if ( _level_seen[_var_stamps[var]] ) continue;
+		_level_seen[_var_stamps[var]] = true;
+		lbd++;
+	}
+	for ( i = 1; i < learnt.Size(); i++ ) {
+		Variable var = learnt[i].Var();
+		if ( Var_Decided( var ) && _var_stamps[var] < _num_levels ) _level_seen[_var_stamps[var]] = false;
+	}
+	return lbd;
+}
+
+void Solver::Init_Learnt_Scores( Clause & learnt )  // NOTE: learnt is built from _big_learnt
+{
+	learnt.Set_LBD( Compute_LBD( _big_learnt ) );
+	learnt.Set_Used( 1 );  // survive the next filtering
+}
+
+bool Solver::Keep_Long_Learnt( Clause & learnt )  /// NOTE: age the clause, so call it once for each filtering
+{
+	if ( learnt.Size() <= 3 ) return true;
+	if ( !running_options.sat_learnt_tiers ) return false;
+	unsigned lbd = learnt.LBD() > 0 ? learnt.LBD() : learnt.Size();  // the clauses from other sources have no LBD
+	if ( lbd <= running_options.sat_learnt_core_lbd ) return true;
+	unsigned used = learnt.Used();
+	if ( lbd <= running_options.sat_learnt_tier2_lbd ) learnt.Set_Used( used > 0 ? used - 1 : 0 );
+	else learnt.Set_Used( 0 );
+	return used > 0;
+}
+
 Reason Solver::Assign_Late( unsigned level, Literal lit, Reason reason )
 {
 	ASSERT( !Var_Decided( lit.Var() ) && level < _num_levels && reason != Reason::undef );
@@ -1215,6 +1261,30 @@ unsigned Solver::Num_Binary_Learnts()
 	return num / 2;
 }
 
+uint64_t Solver::Fingerprint_Original_Clauses()
+{
+	uint64_t hash = 14695981039346656037ULL;
+	hash = Fingerprint_Combine( hash, _max_var );
+	for ( Literal lit: _unary_clauses ) {
+		hash = Fingerprint_Combine( hash, lit );
+	}
+	for ( Literal lit = Literal::start; lit <= 2 * _max_var + 1; lit++ ) {
+		for ( unsigned j = 0; j < _old_num_binary_clauses[lit]; j++ ) {
+			if ( lit < _binary_clauses[lit][j] ) {
+				hash = Fingerprint_Combine( hash, lit );
+				hash = Fingerprint_Combine( hash, _binary_clauses[lit][j] );
+			}
+		}
+	}
+	for ( unsigned i = 0; i < _old_num_long_clauses; i++ ) {
+		hash = Fingerprint_Combine( hash, _long_clauses[i].Size() );
+		for ( unsigned j = 0; j < _long_clauses[i].Size(); j++ ) {
+			hash = Fingerprint_Combine( hash, _long_clauses[i][j] );
+		}
+	}
+	return hash;
+}
+
 void Solver::Verify_Satisfiability( CNF_Formula & cnf, bool result )
 {
 	vector<vector<int>> original_eclauses;
@@ -1581,6 +1651,22 @@ void Solver::Display_Statistics( ostream & out )
 {
 }
 
+void Solver::Write_Statistics_JSON( JSON_Writer & writer )
+{
+	writer.Field( "cpu_seconds", Total_Elapsed_Seconds() );
+	writer.Field( "memory", Total_Used_Memory() );
+	writer.Field( "peak_memory", Peak_Used_Memory() );
+	writer.Begin_Object( "memory_ledger" );  // the tracked bytes, which the memory limits are checked against
+	for ( unsigned i = 0; i < Memory_Num_Subsystems; i++ ) {
+		writer.Field( Memory_Ledger::Name( Memory_Subsystem( i ) ), Memory_Ledger::Used( Memory_Subsystem( i ) ) );
+	}
+	writer.Field( "total", Memory_Ledger::Total() );
+	writer.End_Object();
+	writer.Begin_Object( "statistics" );
+	statistics.Write_JSON( writer );
+	writer.End_Object();
+}
+
 void Solver::Display_Clauses( ostream & out, bool all )
 {
 	unsigned index = 0;
@@ -1986,6 +2072,13 @@ bool Solver::Simplify_Original_Clauses_By_Unary( vector<Clause> & clauses )
 	return true;
 }
 
+void Solver::Set_Budget( Solver_Tool_Parameters & parameters )
+{
+	budget.time_limit = parameters.time_limit;
+	budget.memory_limit = parameters.memory_limit * 1024 * 1024 * 1024;
+	budget.cancel = &Interrupt_Signal();
+}
+
 size_t Solver::Memory()
 {
 	size_t mem = _model_pool->Memory();
@@ -150,6 +150,7 @@ protected:
 	Literal _heur_lit_sentinel;  // the sentinel in heur_sorted_lits
 	Heap<Literal, double> _heur_lits_heap;
 	unsigned * _var_rank;  // used for conflict learning, and dynamic decomposition
+	bool * _level_seen;  // used for computing the LBD of learnt clauses
 	Big_Clause _big_clause;  // only used in a single function, cannot used for transmitting parameters
 	Big_Clause _big_learnt;  // only used in learning conflict
 	Model_Pool * _model_pool;  // each model pool should be recreate for each instance
@@ -207,6 +208,9 @@ protected:
 	Literal Branch_Component( Component & comp );
 	void Filter_Long_Learnts_During_Solving( unsigned old_num_levels, unsigned old_size );
 	bool Two_Unassigned_Literals( Clause & clause );
+	unsigned Compute_LBD( Big_Clause & learnt );
+	void Init_Learnt_Scores( Clause & learnt );
+	bool Keep_Long_Learnt( Clause & learnt );
 	unsigned Num_Unassigned_Literals( Clause & clause );
 protected:
 	Reason Assign_Late( unsigned level, Literal lit, Reason reason );
@@ -216,6 +220,7 @@ protected:
 	unsigned Old_Num_Binary_Clauses();
 	unsigned Num_Learnts();
 	unsigned Num_Binary_Learnts();
+	uint64_t Fingerprint_Original_Clauses();  // used to match a checkpoint with the instance it was written for
 	void Verify_Satisfiability( CNF_Formula & cnf, bool result );
 	void Verify_Long_Learnt( unsigned pos );
 	void Verify_Learnt( Big_Clause & learnt );
@@ -252,12 +257,15 @@ public:
 	bool Solve( vector<vector<int>> & eclauses );
 public:
 	size_t Memory();  /// not the exact memory (omit some auxiliary memory)
+	void Write_Statistics_JSON( JSON_Writer & writer );  /// NOTE: the engines with caches hide it to append their cache metrics
 	void Free_Models( vector<Model *> & models );  /// NOTE: free the models EXACTLY output by calling Solve() or Preprocess()
+	void Set_Budget( Solver_Tool_Parameters & parameters );  // the limits on the command line, and the interrupt signal
 //-------------------------------------------------------------
 public:
 	Statistics statistics;
 	Running_Options running_options;
 	Debug_Options debug_options;
+	Run_Budget budget;  // checked only by the engines that can stop early, and started by each of their runs
 public:
 	static void Debug()
 	{
@@ -688,6 +688,19 @@ protected:
 #define LARGE_HASH_TABLE		1000000
 #define HUGE_HASH_TABLE    		10000000
 
+/* NOTE:
+* The initial entries of a table that grows with the search of an instance. The search stores more for a larger
+* instance and exponentially more for a wider one, so the table starts with 16 entries per variable and clause,
+* doubled for every 8 of the treewidth up to 48, and then grows by rehashing. The empty buckets of the table take
+* at most 1/64 of the memory (in GB) of the engine
+*/
+extern inline size_t Fit_Hash_Table_Size( size_t num_vars, size_t num_clauses, unsigned treewidth, float memory )
+{
+	size_t size = ( num_vars + num_clauses ) * 16 << ( std::min( treewidth, 48u ) / 8 );
+	size_t bound = (size_t) ( memory * 1024 * 1024 * 1024 / 64 / sizeof(vector<size_t>) );
+	return std::max<size_t>( std::min( size, bound ), SMALL_HASH_TABLE );
+}
+
 template <typename T> class Hash_Table
 {
 protected:
@@ -722,7 +735,7 @@ public:
 		_hit_success = false;
 		return _data.size() - 1;
 	}
-	size_t Hit( T & element, size_t & memory )
+	template <typename Memory_Counter> size_t Hit( T & element, Memory_Counter & memory )  // memory is a size_t or a Memory_Account
 	{
 		if ( _data.size() > _entries.size() * 4 ) {
 			ASSERT( memory == Memory() );
@@ -914,14 +927,19 @@ public:
 	}
 };
 
+#define LARGE_HASH_TABLE_MIGRATION	2  // the old entries migrated by each hit while the table grows
+
 template <typename T> class Large_Hash_Table  // designed for memory exhausted
 {
 protected:
 	vector<vector<size_t>> _entries;
+	vector<vector<size_t>> _old_entries;  // the entries before the latest growth, which are not migrated yet
+	size_t _num_migrated;  // _old_entries[0, _num_migrated) have been moved to _entries
+	size_t _num_recycled;  // the storage of _old_entries[0, _num_recycled) has been reused by _entries
 	BlockVector<T> _data;
 	bool _hit_success;  // record the status of the latest hit
 public:
-	Large_Hash_Table( size_t num_entries = LARGE_HASH_TABLE ): _data( 64 * 1024, 16 )
+	Large_Hash_Table( size_t num_entries = LARGE_HASH_TABLE ): _num_migrated( 0 ), _num_recycled( 0 ), _data( 64 * 1024, 16 )
 	{
 		_entries.resize( Prime_Close( num_entries ) );
 		size_t data_capacity = _entries.size() * 2;
@@ -934,38 +952,33 @@ public:
 	}
 	size_t Hit( T & element )
 	{
-		if ( _data.Size() > _entries.size() * 4 ) Resize_Entries( _entries.size() * 2 );
-		size_t key = element.Key();
-		key %= _entries.size();
-		for ( size_t i = 0; i < _entries[key].size(); i++ ) {
-			if ( element == _data[_entries[key][i]] ) {
+		size_t memory = 0;  // not recorded
+		if ( _data.Size() > _entries.size() * 4 ) Grow_Entries( memory );
+		else if ( !_old_entries.empty() ) Migrate_Entries( LARGE_HASH_TABLE_MIGRATION, memory );
+		vector<size_t> & entry = Entry( element.Key() );
+		for ( size_t i = 0; i < entry.size(); i++ ) {
+			if ( element == _data[entry[i]] ) {
 				_hit_success = true;
-				return _entries[key][i];
+				return entry[i];
 			}
 		}
-		_entries[key].push_back( _data.Size() );
+		Push_Entry( entry, _data.Size(), memory );
 		_data.Push_Back( element );
 		_hit_success = false;
 		return _data.Size() - 1;
 	}
-	size_t Hit( T & element, size_t & memory )
+	template <typename Memory_Counter> size_t Hit( T & element, Memory_Counter & memory )  // memory is a size_t or a Memory_Account
 	{
-		if ( _data.Size() > _entries.size() * 4 ) {
-			ASSERT( memory == Memory() );
-			Resize_Entries( _entries.size() * 2 );
-			memory = Memory();
-		}
-		size_t key = element.Key();
-		key %= _entries.size();
-		for ( size_t i = 0; i < _entries[key].size(); i++ ) {
-			if ( element == _data[_entries[key][i]] ) {
+		if ( _data.Size() > _entries.size() * 4 ) Grow_Entries( memory );
+		else if ( !_old_entries.empty() ) Migrate_Entries( LARGE_HASH_TABLE_MIGRATION, memory );
+		vector<size_t> & entry = Entry( element.Key() );
+		for ( size_t i = 0; i < entry.size(); i++ ) {
+			if ( element == _data[entry[i]] ) {
 				_hit_success = true;
-				return _entries[key][i];
+				return entry[i];
 			}
 		}
-		memory -= _entries[key].capacity() * sizeof(size_t);
-		_entries[key].push_back( _data.Size() );
-		memory += _entries[key].capacity() * sizeof(size_t);
+		Push_Entry( entry, _data.Size(), memory );
 		memory -= ( _data.Capacity() - _data.Size() ) * sizeof(T);
 		_data.Push_Back( element );
 		memory += ( _data.Capacity() - _data.Size() ) * sizeof(T);
@@ -977,24 +990,32 @@ public:
 	void Erase( size_t loc )
 	{
 		ASSERT( loc < _data.Size() );
-		size_t i, key = _data[loc].Key() % _entries.size();
-		for ( i = 0; loc != _entries[key][i]; i++ ) {}
-		Simply_Erase_Vector_Element( _entries[key], i );
+		size_t i;
+		vector<size_t> & entry = Entry( _data[loc].Key() );
+		for ( i = 0; loc != entry[i]; i++ ) {}
+		Simply_Erase_Vector_Element( entry, i );
 		size_t fill_loc = _data.Size() - 1;
-		key = _data.Back().Key() % _entries.size();
-		for ( i = 0; fill_loc != _entries[key][i]; i++ ) {}
-		_entries[key][i] = loc;
+		vector<size_t> & fill_entry = Entry( _data.Back().Key() );
+		for ( i = 0; fill_loc != fill_entry[i]; i++ ) {}
+		fill_entry[i] = loc;
 		_data.Simply_Erase( loc );
 	}
 	size_t Location( T & element )
 	{
-		size_t key = element.Key();
-		key %= _entries.size();
-		for ( size_t i = 0; i < _entries[key].size(); i++ ) {
-			if ( element == _data[_entries[key][i]] ) return _entries[key][i];
+		vector<size_t> & entry = Entry( element.Key() );
+		for ( size_t i = 0; i < entry.size(); i++ ) {
+			if ( element == _data[entry[i]] ) return entry[i];
 		}
 		return SIZET_UNDEF;
 	}
+	template <typename Memory_Counter> void Rekey( size_t loc, size_t old_key, Memory_Counter & memory )  /// NOTE: called after the key of _data[loc] changes from old_key
+	{
+		size_t i;
+		vector<size_t> & old_entry = Entry( old_key );
+		for ( i = 0; loc != old_entry[i]; i++ ) {}
+		Simply_Erase_Vector_Element( old_entry, i );
+		Push_Entry( Entry( _data[loc].Key() ), loc, memory );
+	}
 	const vector<T> & Data() const { return _data; }
 	T & operator [] ( size_t i ) { return _data[i];	}
 	bool Empty() const { return _data.Empty(); }
@@ -1007,6 +1028,7 @@ public:
 	}
 	void Shrink_To_Fit()
 	{
+		Discard_Old_Entries();
 		_data.Shrink_To_Fit();
 		_entries.clear();
 		_entries.shrink_to_fit();
@@ -1028,10 +1050,15 @@ public:
 			mem += _entries[i].capacity() * sizeof(size_t);
 		}
 		mem += _entries.capacity() * sizeof(vector<size_t>);
+		for ( size_t i = _num_recycled; i < _old_entries.size(); i++ ) {
+			mem += _old_entries[i].capacity() * sizeof(size_t);
+		}
+		mem += _old_entries.capacity() * sizeof(vector<size_t>);
 		return mem;
 	}
 	void Recompute_Entries()
 	{
+		Discard_Old_Entries();
 		for ( size_t i = 0; i < _entries.size(); i++ ) {
 			_entries[i].clear();
 		}
@@ -1048,6 +1075,7 @@ public:
 			cerr << "Warning[Large_Hash_Table]: new size is greater than old size" << endl;
 			return;
 		}
+		Discard_Old_Entries();
 		for ( size_t i = 0; i < _entries.size(); i++ ) {
 			_entries[i].clear();
 		}
@@ -1058,12 +1086,22 @@ public:
 			_entries[key].push_back( i );
 		}
 	}
+	size_t Num_Entries() const { return _entries.size(); }
+	void Reset_Entries( size_t num_entries )  /// NOTE: only for an empty table, which then grows from num_entries
+	{
+		assert( _data.Empty() );
+		Discard_Old_Entries();
+		if ( Prime_Close( num_entries ) == _entries.size() ) return;
+		vector<vector<size_t>> tmp_entries( Prime_Close( num_entries ) );
+		_entries.swap( tmp_entries );
+	}
 	void Resize_Entries( size_t new_size )
 	{
 		if ( new_size <= _entries.size() ) {
 			cerr << "Warning[Large_Hash_Table]: new size of _entries is not greater than old size" << endl;
 			return;
 		}
+		Discard_Old_Entries();
 		for ( size_t i = 0; i < _entries.size(); i++ ) {
 			_entries[i].clear();
 		}
@@ -1076,6 +1114,7 @@ public:
 	}
 	void Clear()
 	{
+		Discard_Old_Entries();
 		size_t entry_size = _entries.size();
 		_entries.clear();
 		_entries.resize( entry_size );
@@ -1104,6 +1143,19 @@ public:
 			kept_locs[i] = Hit( kept_elems[i] );
 		}
 	}
+	void Clear_Shrink( vector<size_t> & kept_locs, size_t capacity )
+	{
+		assert( capacity >= kept_locs.size() );
+		vector<T> kept_elems( kept_locs.size() );
+		for ( size_t i = 0; i < kept_locs.size(); i++ ) {
+			kept_elems[i] = _data[kept_locs[i]];
+		}
+		Clear();
+		_data.Reserve( capacity );
+		for ( size_t i = 0; i < kept_locs.size(); i++ ) {
+			kept_locs[i] = Hit( kept_elems[i] );
+		}
+	}
 	void Clear_Old_Data( vector<size_t> & kept_locs, size_t cleared_size )
 	{
 		assert( 0 < cleared_size && cleared_size <= _data.Size() );
@@ -1121,8 +1173,67 @@ public:
 	void Swap( Large_Hash_Table<T> & other )
 	{
 		_entries.swap( other._entries );
+		_old_entries.swap( other._old_entries );
+		std::swap( _num_migrated, other._num_migrated );
+		std::swap( _num_recycled, other._num_recycled );
 		_data.Swap( other._data );
 	}
+protected:
+	vector<size_t> & Entry( size_t key )  // the entry which holds the elements with key
+	{
+		if ( !_old_entries.empty() ) {
+			size_t old = key % _old_entries.size();
+			if ( old >= _num_migrated ) return _old_entries[old];
+		}
+		return _entries[key % _entries.size()];
+	}
+	template <typename Memory_Counter> void Grow_Entries( Memory_Counter & memory )
+	{
+		/* NOTE:
+		* Rehashing all elements at once pauses the search for seconds when the table is huge. Instead, the old
+		* entries are kept, and each hit migrates a few of them to the new entries (like the dictionaries of Redis).
+		* The elements at least double between two growths, so the old entries have usually migrated before the
+		* next growth; otherwise, the rest of them migrate at that time
+		*/
+		if ( !_old_entries.empty() ) Migrate_Entries( _old_entries.size(), memory );
+		_old_entries.swap( _entries );
+		vector<vector<size_t>> tmp_entries( Prime_Close( _old_entries.size() * 2 ) );
+		_entries.swap( tmp_entries );
+		_num_migrated = _num_recycled = 0;
+		memory += _entries.capacity() * sizeof(vector<size_t>);
+	}
+	template <typename Memory_Counter> void Migrate_Entries( size_t num, Memory_Counter & memory )
+	{
+		for ( ; num > 0 && _num_migrated < _old_entries.size(); num-- ) {
+			vector<size_t> & old_entry = _old_entries[_num_migrated];
+			for ( size_t loc: old_entry ) {
+				Push_Entry( _entries[_data[loc].Key() % _entries.size()], loc, memory );
+			}
+			old_entry.clear();  // the storage is recycled by Push_Entry
+			_num_migrated++;
+		}
+		if ( _num_migrated == _old_entries.size() ) {
+			for ( size_t i = _num_recycled; i < _old_entries.size(); i++ ) {
+				memory -= _old_entries[i].capacity() * sizeof(size_t);
+			}
+			memory -= _old_entries.capacity() * sizeof(vector<size_t>);
+			Discard_Old_Entries();
+		}
+	}
+	template <typename Memory_Counter> void Push_Entry( vector<size_t> & entry, size_t loc, Memory_Counter & memory )
+	{
+		if ( entry.capacity() == 0 && _num_recycled < _num_migrated ) {
+			entry.swap( _old_entries[_num_recycled++] );  /// NOTE: allocating a new entry costs much more than pushing
+		}
+		memory -= entry.capacity() * sizeof(size_t);
+		entry.push_back( loc );
+		memory += entry.capacity() * sizeof(size_t);
+	}
+	void Discard_Old_Entries()  // also for the callers which recompute all entries from _data
+	{
+		vector<vector<size_t>>().swap( _old_entries );
+		_num_migrated = _num_recycled = 0;
+	}
 };
 
 
@@ -2446,6 +2557,17 @@ public:
 		double result = _rand_gen.Random();
 		return result < p;  // This will happen with probability p
 	}
+	void Write( ostream & out ) const  // binary state, used by checkpoints
+	{
+		out.write( (const char *) &_seed, sizeof(_seed) );
+		out.write( (const char *) &_rand_gen, sizeof(_rand_gen) );  /// NOTE: CRandomMersenne has no pointers
+	}
+	bool Read( istream & in )
+	{
+		in.read( (char *) &_seed, sizeof(_seed) );
+		in.read( (char *) &_rand_gen, sizeof(_rand_gen) );
+		return (bool) in;
+	}
 public:
 	static void Debug()
 	{
@@ -1,11 +1,52 @@
 #include "BigNum.h"
+#include "Time_Memory.h"
 #include <fstream>
+#include <vector>
 using namespace std;
 
 
 namespace KCBox {
 
 
+static void * Tracked_GMP_Allocate( size_t size )
+{
+	void * block = malloc( size );
+	if ( block == nullptr ) {
+		cerr << "ERROR[BigNum]: fail for allocating " << size << " bytes of limbs!" << endl;
+		exit( 1 );
+	}
+	Memory_Ledger::Charge( Memory_Limbs, size );
+	return block;
+}
+
+static void * Tracked_GMP_Reallocate( void * block, size_t old_size, size_t new_size )
+{
+	block = realloc( block, new_size );
+	if ( block == nullptr ) {
+		cerr << "ERROR[BigNum]: fail for reallocating " << new_size << " bytes of limbs!" << endl;
+		exit( 1 );
+	}
+	Memory_Ledger::Charge( Memory_Limbs, new_size - old_size );
+	return block;
+}
+
+static void Tracked_GMP_Free( void * block, size_t size )
+{
+	free( block );
+	Memory_Ledger::Release( Memory_Limbs, size );
+}
+
+extern void Track_GMP_Limbs()
+{
+	static bool tracked = false;
+	if ( tracked ) return;
+	mp_set_memory_functions( Tracked_GMP_Allocate, Tracked_GMP_Reallocate, Tracked_GMP_Free );
+	tracked = true;
+}
+
+static struct GMP_Limbs_Tracker { GMP_Limbs_Tracker() { Track_GMP_Limbs(); } } gmp_limbs_tracker;  // before main, and before the library is used
+
+
 extern int sscanf( char str[], BigInt & i )
 {
 	return gmp_sscanf( str, "%Zd", i._xCount );
@@ -53,6 +94,24 @@ double DoubleQuotient( const BigInt & n, const BigInt & d ) // return n / d
     return mpz_get_d( n._xCount ) / mpz_get_d( d._xCount );
 }
 
+void BigInt::Write( ostream & out ) const  // the sign and size, followed by the limbs from the least significant one
+{
+	int size = _xCount->_mp_size;
+	out.write( (const char *) &size, sizeof(int) );
+	out.write( (const char *) _xCount->_mp_d, abs( size ) * sizeof(mp_limb_t) );
+}
+
+bool BigInt::Read( istream & in )
+{
+	int size;
+	if ( !in.read( (char *) &size, sizeof(int) ) ) return false;
+	vector<mp_limb_t> limbs( abs( size ) );
+	if ( size != 0 && !in.read( (char *) limbs.data(), limbs.size() * sizeof(mp_limb_t) ) ) return false;
+	mpz_import( _xCount, limbs.size(), -1, sizeof(mp_limb_t), 0, 0, limbs.data() );
+	if ( size < 0 ) mpz_neg( _xCount, _xCount );
+	return true;
+}
+
 extern int sscanf( char str[], BigFloat & f )
 {
 	return gmp_sscanf( str, "%FE", f._xCount );
@@ -124,5 +183,34 @@ ostream & operator << ( ostream & out, const BigFloat & f )
 	return out;
 }
 
+void BigFloat::Write( ostream & out ) const  // the sign and size, the exponent in limbs, and the limbs from the least significant one
+{
+	int size = _xCount->_mp_size;
+	long exp = _xCount->_mp_exp;
+	out.write( (const char *) &size, sizeof(int) );
+	out.write( (const char *) &exp, sizeof(long) );
+	out.write( (const char *) _xCount->_mp_d, abs( size ) * sizeof(mp_limb_t) );
+}
+
+bool BigFloat::Read( istream & in )  /// NOTE: exact when the precision is the same as that of the writer
+{
+	int size;
+	long exp;
+	if ( !in.read( (char *) &size, sizeof(int) ) || !in.read( (char *) &exp, sizeof(long) ) ) return false;
+	vector<mp_limb_t> limbs( abs( size ) );
+	if ( size != 0 && !in.read( (char *) limbs.data(), limbs.size() * sizeof(mp_limb_t) ) ) return false;
+	mpz_t mantissa;
+	mpz_init( mantissa );
+	mpz_import( mantissa, limbs.size(), -1, sizeof(mp_limb_t), 0, 0, limbs.data() );
+	mpf_set_z( _xCount, mantissa );
+	mpz_clear( mantissa );
+	long shift = ( exp - (long) limbs.size() ) * GMP_NUMB_BITS;
+	if ( size == 0 ) return true;
+	if ( shift >= 0 ) mpf_mul_2exp( _xCount, _xCount, shift );
+	else mpf_div_2exp( _xCount, _xCount, -shift );
+	if ( size < 0 ) mpf_neg( _xCount, _xCount );
+	return true;
+}
+
 
 }
@@ -4,6 +4,7 @@
 #include <gmp.h>
 #include <math.h>
 #include <ostream>
+#include <istream>
 #include <string>
 using namespace std;
 
@@ -49,6 +50,15 @@ public:
 	void Mul_2exp( const int e ) { mpz_mul_2exp(_xCount, _xCount, e); }
 	void Div_2exp( const int e ) { mpz_div_2exp(_xCount, _xCount, e); }
 	bool Divisible_2exp( const int e ) { return mpz_divisible_2exp_p(_xCount, e ); }
+	unsigned Trailing_Zeros() const { return mpz_sgn(_xCount) == 0 ? 0 : mpz_scan1(_xCount, 0); }  // the exponent of the greatest power of two dividing it
+	size_t Key() const  // used in hash tables
+	{
+		size_t key = _xCount->_mp_size;
+		for ( size_t i = 0; i < mpz_size(_xCount); i++ ) {
+			key = ( key ^ _xCount->_mp_d[i] ) * 1099511628211ULL;
+		}
+		return key;
+	}
 	bool LE_2exp( const int e ) const
 	{
 	    mpz_t tmp;
@@ -59,8 +69,9 @@ public:
 	    mpz_clear( tmp );
 	    return result;
 	}
-	typedef int int_type;
-	size_t Memory() const { return sizeof(mpz_t) + _xCount->_mp_alloc * sizeof(mp_limb_t); }
+	size_t Memory() const { return sizeof(mpz_t) + _xCount->_mp_alloc * sizeof(mp_limb_t); }  /// NOTE: no int_type, because the limbs are charged to Memory_Limbs and the caches count only sizeof
+	void Write( ostream & out ) const;  // binary, used by checkpoints
+	bool Read( istream & in );
 protected:
 	mpz_t _xCount;
 };
@@ -180,12 +191,15 @@ public:
 		mpf_add( _xCount, tmp1, tmp2 );
 		mpf_clear( tmp1 ); mpf_clear( tmp2 );
 	}
-	typedef int int_type;
-	size_t Memory() const { return sizeof(mpf_t) + (_xCount->_mp_prec+1) * sizeof(mp_limb_t); }
+	size_t Memory() const { return sizeof(mpf_t) + (_xCount->_mp_prec+1) * sizeof(mp_limb_t); }  /// NOTE: no int_type, as for BigInt
+	void Write( ostream & out ) const;  // binary, used by checkpoints
+	bool Read( istream & in );
 protected:
     mpf_t _xCount;
 };
 
+extern void Track_GMP_Limbs();  // charges Memory_Limbs through mp_set_memory_functions; it runs before main, and the later calls do nothing
+
 
 }
 
@@ -0,0 +1,160 @@
+#ifndef _Checkpoint_h_
+#define _Checkpoint_h_
+
+#include "Basic_Functions.h"
+#include "Time_Memory.h"
+#include "BigNum.h"
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <cstdio>
+
+
+namespace KCBox {
+
+
+/****************************************************************************************************
+*                                                                                                   *
+*                                         Binary I/O                                                *
+*                                                                                                   *
+****************************************************************************************************/
+
+template <typename T> inline void Write_Binary( ostream & out, const T & value )  /// NOTE: only for trivially copyable types
+{
+	out.write( (const char *) &value, sizeof(T) );
+}
+
+template <typename T> inline bool Read_Binary( istream & in, T & value )
+{
+	in.read( (char *) &value, sizeof(T) );
+	return (bool) in;
+}
+
+template <typename T> inline void Write_Binary( ostream & out, const vector<T> & values )
+{
+	Write_Binary( out, (unsigned) values.size() );
+	if ( !values.empty() ) out.write( (const char *) values.data(), values.size() * sizeof(T) );
+}
+
+template <typename T> inline bool Read_Binary( istream & in, vector<T> & values )
+{
+	unsigned size;
+	if ( !Read_Binary( in, size ) ) return false;
+	values.resize( size );
+	if ( size > 0 ) in.read( (char *) values.data(), size * sizeof(T) );
+	return (bool) in;
+}
+
+inline void Write_Binary( ostream & out, const BigInt & value ) { value.Write( out ); }
+
+inline bool Read_Binary( istream & in, BigInt & value ) { return value.Read( in ); }
+
+inline void Write_Binary( ostream & out, const BigFloat & value ) { value.Write( out ); }
+
+inline bool Read_Binary( istream & in, BigFloat & value ) { return value.Read( in ); }
+
+inline uint64_t Fingerprint_Combine( uint64_t hash, uint64_t value )  // FNV-1a over the bytes of value
+{
+	for ( unsigned i = 0; i < 8; i++ ) {
+		hash ^= ( value >> ( 8 * i ) ) & 0xFF;
+		hash *= 1099511628211ULL;
+	}
+	return hash;
+}
+
+
+/****************************************************************************************************
+*                                                                                                   *
+*                                         Checkpoint                                                *
+*                                                                                                   *
+****************************************************************************************************/
+
+enum Checkpoint_Kind
+{
+	Checkpoint_ExactMC = 1,
+	Checkpoint_PartialKC = 2
+};
+
+class Checkpoint_Writer
+{
+protected:
+	string _path;
+	double _interval;  // in seconds
+	StopWatch _watch;
+	std::thread _thread;  // writes the previous snapshot while the search goes on
+	unsigned _num_written;
+public:
+	enum { magic = 0x4B434350, version = 1 };  // magic is "KCCP"
+	Checkpoint_Writer(): _interval( 0 ), _num_written( 0 ) {}
+	~Checkpoint_Writer() { Close(); }
+	void Open( const char * path, double interval )
+	{
+		Close();
+		_path = path;
+		_interval = interval;
+		_num_written = 0;
+		_watch.Start();
+	}
+	bool Opened() const { return !_path.empty(); }
+	unsigned Num_Written() const { return _num_written; }
+	bool Due() { return !_path.empty() && _watch.Get_Elapsed_Seconds() >= _interval; }
+	void Write_Header( ostream & out, Checkpoint_Kind kind, uint64_t fingerprint )
+	{
+		Write_Binary( out, (unsigned) magic );
+		Write_Binary( out, (unsigned) version );
+		Write_Binary( out, (unsigned) kind );
+		Write_Binary( out, fingerprint );
+	}
+	void Write_Async( string & data )  // data is taken over
+	{
+		Wait();
+		_thread = std::thread( Write_File, _path, std::move( data ) );
+		_num_written++;
+		_watch.Start();
+	}
+	void Wait() { if ( _thread.joinable() ) _thread.join(); }
+	void Close()
+	{
+		Wait();
+		_path.clear();
+	}
+	static bool Read_File( const char * path, Checkpoint_Kind kind, uint64_t fingerprint, stringstream & in )
+	{
+		ifstream fin( path, ios::binary );
+		if ( !fin.is_open() ) {
+			cerr << "Warning[Checkpoint]: cannot open " << path << ", and start from scratch!" << endl;
+			return false;
+		}
+		in << fin.rdbuf();
+		fin.close();
+		unsigned file_magic, file_version, file_kind;
+		uint64_t file_fingerprint;
+		if ( !Read_Binary( in, file_magic ) || !Read_Binary( in, file_version ) || !Read_Binary( in, file_kind ) || !Read_Binary( in, file_fingerprint ) \
+			|| file_magic != (unsigned) magic || file_version != (unsigned) version ) {
+			cerr << "Warning[Checkpoint]: " << path << " is not a checkpoint of this version, and start from scratch!" << endl;
+			return false;
+		}
+		if ( file_kind != (unsigned) kind || file_fingerprint != fingerprint ) {
+			cerr << "Warning[Checkpoint]: " << path << " was written for another instance or mode, and start from scratch!" << endl;
+			return false;
+		}
+		return true;
+	}
+protected:
+	static void Write_File( string path, string data )  /// NOTE: write a temporary file and rename it, so that a crash never leaves a truncated checkpoint
+	{
+		string tmp_path = path + ".tmp";
+		ofstream fout( tmp_path, ios::binary | ios::trunc );
+		fout.write( data.data(), data.size() );
+		fout.close();
+		if ( !fout || rename( tmp_path.c_str(), path.c_str() ) != 0 ) {
+			cerr << "Warning[Checkpoint]: failed to write " << path << "!" << endl;
+		}
+	}
+};
+
+
+}
+
+
+#endif
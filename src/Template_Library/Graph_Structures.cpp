@@ -1,4 +1,5 @@
 #include "Graph_Structures.h"
+#include <thread>
 
 
 namespace KCBox {
@@ -654,6 +655,19 @@ unsigned Greedy_Graph::Induced_Width_Min_Fill_Bound( unsigned bound )
 	return inducedwidth;
 }
 
+void Greedy_Graph::Export_Edges( vector<vector<unsigned>> & edges )
+{
+	edges.resize( max_vertex + 1 );
+	for ( unsigned v = 0; v <= max_vertex; v++ ) {
+		edges[v].clear();
+		if ( vertices[v].degree == UNSIGNED_UNDEF ) continue;
+		edges[v].reserve( vertices[v].degree );
+		for ( Neighbour * p = vertices[v].adjacency->next; p->vertex <= max_vertex; p = p->next ) {
+			edges[v].push_back( p->vertex );
+		}
+	}
+}
+
 void Greedy_Graph::Display( ostream & out )
 {
 	out << "Vertices:";
@@ -731,6 +745,316 @@ void Greedy_Graph::Display_Fill_Size( ostream & fout)
 
 //====================================================================================================
 
+Min_Fill_Graph::Min_Fill_Graph( unsigned max, vector<vector<unsigned>> & edges, bool by_degree, unsigned num_threads ):
+	_max_vertex( max ), _by_degree( by_degree )
+{
+	assert( max + 1 == edges.size() );
+	Set_Num_Threads( num_threads );
+	Build( edges );
+}
+
+Min_Fill_Graph::Min_Fill_Graph( Greedy_Graph & graph, bool by_degree, unsigned num_threads ):
+	_max_vertex( graph.Max_Vertex() ), _by_degree( by_degree )
+{
+	vector<vector<unsigned>> edges;
+	graph.Export_Edges( edges );
+	Set_Num_Threads( num_threads );
+	Build( edges );
+}
+
+void Min_Fill_Graph::Set_Num_Threads( unsigned num_threads )
+{
+	if ( num_threads == 0 ) num_threads = std::thread::hardware_concurrency();
+	if ( num_threads == 0 ) num_threads = 1;
+	_num_threads = num_threads;
+	_marks.resize( _num_threads );
+	for ( vector<bool> & marks: _marks ) {
+		marks.assign( _max_vertex + 1, false );
+	}
+}
+
+void Min_Fill_Graph::Build( vector<vector<unsigned>> & edges )
+{
+	unsigned v;
+	size_t total = 0;
+	for ( v = 0; v <= _max_vertex; v++ ) {
+		total += edges[v].size();
+	}
+	_pool.reserve( total + total / 2 );  // slack for fill edges
+	_pool.resize( total );
+	_offsets.resize( _max_vertex + 1 );
+	_degrees.resize( _max_vertex + 1 );
+	_capacities.resize( _max_vertex + 1 );
+	_rows.resize( _max_vertex + 1 );
+	_dense_degree = ( _max_vertex + 1 ) / 32;  /// a bitset row is not larger than the sorted slice
+	if ( _dense_degree < 64 ) _dense_degree = 64;
+	QSorter sorter;
+	size_t offset = 0;
+	for ( v = 0; v <= _max_vertex; v++ ) {
+		sorter.Sort( edges[v] );
+		_offsets[v] = offset;
+		_degrees[v] = _capacities[v] = edges[v].size();
+		std::copy( edges[v].begin(), edges[v].end(), _pool.begin() + offset );
+		offset += edges[v].size();
+		if ( _degrees[v] >= _dense_degree ) Build_Row( v );
+	}
+	_num_vertices = _max_vertex + 1;
+	_adjacent.assign( _max_vertex + 1, false );
+	vector<unsigned> vertices( _max_vertex + 1 );
+	for ( v = 0; v <= _max_vertex; v++ ) {
+		vertices[v] = v;
+	}
+	_keys.resize( _max_vertex + 1 );
+	Compute_Keys_Parallel( vertices, _keys.data() );
+	unsigned num_buckets = _max_vertex + 2 < 0x10000 ? _max_vertex + 2 : 0x10000;
+	_bucket_heads.resize( num_buckets );
+	_bucket_next.resize( _max_vertex + 1 );
+	_bucket_prev.resize( _max_vertex + 1 );
+	Rebuild_Buckets( vertices );
+}
+
+void Min_Fill_Graph::Build_Row( unsigned v )
+{
+	_rows[v].assign( ( _max_vertex >> 6 ) + 1, 0 );
+	for ( const unsigned * p = Neighbours_Begin( v ); p < Neighbours_End( v ); p++ ) {
+		_rows[v][*p >> 6] |= uint64_t(1) << ( *p & 63 );
+	}
+}
+
+void Min_Fill_Graph::Rebuild_Buckets( const vector<unsigned> & vertices )
+{
+	_bucket_heads.assign( _bucket_heads.size(), UNSIGNED_UNDEF );
+	_min_bucket = _bucket_heads.size() - 1;
+	for ( unsigned i = vertices.size() - 1; i != UNSIGNED_UNDEF; i-- ) {  /// the smaller vertices are nearer to the heads
+		Bucket_Insert( vertices[i] );
+	}
+}
+
+void Min_Fill_Graph::Set_Key_Mode( bool by_degree )
+{
+	_by_degree = by_degree;
+	vector<unsigned> vertices;
+	for ( unsigned v = 0; v <= _max_vertex; v++ ) {
+		if ( !Eliminated( v ) ) vertices.push_back( v );
+	}
+	_new_keys.resize( vertices.size() );
+	Compute_Keys_Parallel( vertices, _new_keys.data() );
+	for ( unsigned i = 0; i < vertices.size(); i++ ) {
+		_keys[vertices[i]] = _new_keys[i];
+	}
+	Rebuild_Buckets( vertices );
+}
+
+void Min_Fill_Graph::Shuffle_Buckets( Random_Generator & rand_gen )
+{
+	vector<unsigned> vertices;
+	for ( unsigned v = 0; v <= _max_vertex; v++ ) {
+		if ( !Eliminated( v ) ) vertices.push_back( v );
+	}
+	for ( unsigned i = vertices.size(); i > 1; i-- ) {
+		std::swap( vertices[i - 1], vertices[rand_gen.Generate_Int( 0, i - 1 )] );
+	}
+	Rebuild_Buckets( vertices );
+}
+
+unsigned Min_Fill_Graph::Min_Key_Vertex()
+{
+	assert( _num_vertices > 0 );
+	while ( _bucket_heads[_min_bucket] == UNSIGNED_UNDEF ) _min_bucket++;
+	unsigned v = _bucket_heads[_min_bucket];
+	if ( _min_bucket == _bucket_heads.size() - 1 ) {  // the keys in the last bucket are not equal
+		for ( unsigned u = _bucket_next[v]; u != UNSIGNED_UNDEF; u = _bucket_next[u] ) {
+			if ( _keys[u] < _keys[v] ) v = u;
+		}
+	}
+	return v;
+}
+
+void Min_Fill_Graph::Eliminate_Vertex( unsigned v )
+{
+	assert( v <= _max_vertex && !Eliminated( v ) );
+	Bucket_Erase( v );
+	_neighbours.assign( Neighbours_Begin( v ), Neighbours_End( v ) );
+	for ( unsigned u: _neighbours ) {
+		Remove_Neighbour( u, v );
+	}
+	_degrees[v] = UNSIGNED_UNDEF;
+	vector<uint64_t>().swap( _rows[v] );
+	_num_vertices--;
+	vector<bool> & in_neighbourhood = _marks[0];
+	for ( unsigned u: _neighbours ) {
+		in_neighbourhood[u] = true;
+	}
+	for ( unsigned i = 0; i + 1 < _neighbours.size(); i++ ) {
+		unsigned u = _neighbours[i];
+		bool row = !_rows[u].empty();
+		if ( !row ) {
+			for ( const unsigned * p = Neighbours_Begin( u ); p < Neighbours_End( u ); p++ ) {
+				_adjacent[*p] = true;
+			}
+		}
+		for ( unsigned j = i + 1; j < _neighbours.size(); j++ ) {
+			unsigned w = _neighbours[j];
+			if ( row ? ( _rows[u][w >> 6] >> ( w & 63 ) ) & 1 : _adjacent[w] ) continue;
+			if ( !_by_degree ) Discount_Common_Neighbours( u, w );
+			Add_Neighbour( u, w );
+			Add_Neighbour( w, u );
+			if ( !row ) _adjacent[w] = true;
+		}
+		if ( !row ) {
+			for ( const unsigned * p = Neighbours_Begin( u ); p < Neighbours_End( u ); p++ ) {
+				_adjacent[*p] = false;
+			}
+		}
+	}
+	for ( unsigned u: _neighbours ) {
+		in_neighbourhood[u] = false;
+	}
+	Update_Keys( _neighbours );
+}
+
+void Min_Fill_Graph::Remove_Vertex( unsigned v )
+{
+	assert( v <= _max_vertex && !Eliminated( v ) );
+	Bucket_Erase( v );
+	_neighbours.assign( Neighbours_Begin( v ), Neighbours_End( v ) );
+	for ( unsigned u: _neighbours ) {
+		Remove_Neighbour( u, v );
+	}
+	_degrees[v] = UNSIGNED_UNDEF;
+	vector<uint64_t>().swap( _rows[v] );
+	_num_vertices--;
+	Update_Keys( _neighbours );
+}
+
+void Min_Fill_Graph::Discount_Common_Neighbours( unsigned u, unsigned v )
+{
+	vector<bool> & in_neighbourhood = _marks[0];  /// the neighbours of the eliminated vertex will be recomputed
+	if ( _rows[u].empty() && _rows[v].empty() ) {
+		const unsigned * p = Neighbours_Begin( u ), * p_end = Neighbours_End( u );
+		const unsigned * q = Neighbours_Begin( v ), * q_end = Neighbours_End( v );
+		while ( p < p_end && q < q_end ) {
+			if ( *p < *q ) p++;
+			else if ( *p > *q ) q++;
+			else {
+				if ( !in_neighbourhood[*p] ) {
+					Bucket_Erase( *p );
+					_keys[*p]--;
+					Bucket_Insert( *p );
+				}
+				p++;
+				q++;
+			}
+		}
+		return;
+	}
+	if ( _rows[u].empty() || ( !_rows[v].empty() && _degrees[v] < _degrees[u] ) ) std::swap( u, v );  // u has a row, and v has the shorter list
+	for ( const unsigned * q = Neighbours_Begin( v ); q < Neighbours_End( v ); q++ ) {
+		if ( ( ( _rows[u][*q >> 6] >> ( *q & 63 ) ) & 1 ) && !in_neighbourhood[*q] ) {
+			Bucket_Erase( *q );
+			_keys[*q]--;
+			Bucket_Insert( *q );
+		}
+	}
+}
+
+size_t Min_Fill_Graph::Compute_Key( unsigned v, vector<bool> & marks ) const
+{
+	unsigned degree = _degrees[v];
+	if ( _by_degree ) return degree;
+	if ( degree < 2 ) return 0;
+	const unsigned * begin = Neighbours_Begin( v ), * end = Neighbours_End( v );
+	bool row = !_rows[v].empty();
+	if ( !row ) {
+		for ( const unsigned * p = begin; p < end; p++ ) {
+			marks[*p] = true;
+		}
+	}
+	size_t num_inner = 0;  // twice the number of edges between the neighbours of v
+	for ( const unsigned * p = begin; p < end; p++ ) {
+		unsigned u = *p;
+		if ( !_rows[u].empty() && _degrees[u] > degree ) {
+			const vector<uint64_t> & urow = _rows[u];
+			for ( const unsigned * q = begin; q < end; q++ ) {
+				num_inner += ( urow[*q >> 6] >> ( *q & 63 ) ) & 1;
+			}
+		}
+		else if ( row ) {
+			const vector<uint64_t> & vrow = _rows[v];
+			for ( const unsigned * q = Neighbours_Begin( u ); q < Neighbours_End( u ); q++ ) {
+				num_inner += ( vrow[*q >> 6] >> ( *q & 63 ) ) & 1;
+			}
+		}
+		else {
+			for ( const unsigned * q = Neighbours_Begin( u ); q < Neighbours_End( u ); q++ ) {
+				num_inner += marks[*q];
+			}
+		}
+	}
+	if ( !row ) {
+		for ( const unsigned * p = begin; p < end; p++ ) {
+			marks[*p] = false;
+		}
+	}
+	return size_t( degree ) * ( degree - 1 ) / 2 - num_inner / 2;
+}
+
+void Min_Fill_Graph::Update_Keys( const vector<unsigned> & vertices )
+{
+	_new_keys.resize( vertices.size() );
+	Compute_Keys_Parallel( vertices, _new_keys.data() );
+	for ( unsigned i = 0; i < vertices.size(); i++ ) {
+		unsigned v = vertices[i];
+		if ( _new_keys[i] == _keys[v] ) continue;
+		Bucket_Erase( v );
+		_keys[v] = _new_keys[i];
+		Bucket_Insert( v );
+	}
+}
+
+void Min_Fill_Graph::Compute_Keys_Parallel( const vector<unsigned> & vertices, size_t * keys )
+{
+	unsigned num_threads = _num_threads;
+	if ( _by_degree || vertices.size() < 256 * num_threads ) num_threads = 1;  /// not worth to start threads
+	if ( num_threads == 1 ) {
+		for ( unsigned i = 0; i < vertices.size(); i++ ) {
+			keys[i] = Compute_Key( vertices[i], _marks[0] );
+		}
+		return;
+	}
+	auto compute = [this, &vertices, keys, num_threads]( unsigned id ) {
+		for ( unsigned i = id; i < vertices.size(); i += num_threads ) {
+			keys[i] = Compute_Key( vertices[i], _marks[id] );
+		}
+	};
+	vector<std::thread> workers;
+	for ( unsigned id = 1; id < num_threads; id++ ) {
+		workers.push_back( std::thread( compute, id ) );
+	}
+	compute( 0 );
+	for ( std::thread & worker: workers ) {
+		worker.join();
+	}
+}
+
+void Min_Fill_Graph::Verify_Keys()
+{
+	for ( unsigned v = 0; v <= _max_vertex; v++ ) {
+		if ( Eliminated( v ) ) continue;
+		for ( const unsigned * p = Neighbours_Begin( v ); p < Neighbours_End( v ); p++ ) {
+			assert( !Eliminated( *p ) && *p != v );
+			assert( p == Neighbours_Begin( v ) || *(p - 1) < *p );
+			assert( std::binary_search( Neighbours_Begin( *p ), Neighbours_End( *p ), v ) );
+		}
+		if ( _keys[v] != Compute_Key( v, _marks[0] ) ) {
+			cerr << "ERROR[Min_Fill_Graph]: the key of vertex " << v << " is " << _keys[v] << " rather than " << Compute_Key( v, _marks[0] ) << "!" << endl;
+			assert( false );
+		}
+	}
+}
+
+//====================================================================================================
+
 Simple_TreeD::Simple_TreeD( Greedy_Graph & graph ): _max_vertex( graph.Max_Vertex() ), _clusters( 2 )
 {
 	Allocate_and_Init_Auxiliary_Memory();
@@ -1013,6 +1337,109 @@ Simple_TreeD::Simple_TreeD( Greedy_Graph & graph, unsigned bound, bool opt ): _m
 	}
 }
 
+Simple_TreeD::Simple_TreeD( Min_Fill_Graph & graph, unsigned bound ): _max_vertex( graph.Max_Vertex() ), _clusters( 2 )
+{
+	Allocate_and_Init_Auxiliary_Memory();
+	Generate_Clusters( graph, nullptr, bound );
+}
+
+Simple_TreeD::Simple_TreeD( Min_Fill_Graph & graph, const vector<unsigned> & order ): _max_vertex( graph.Max_Vertex() ), _clusters( 2 )
+{
+	Allocate_and_Init_Auxiliary_Memory();
+	Generate_Clusters( graph, &order, UNSIGNED_UNDEF );
+}
+
+void Simple_TreeD::Generate_Clusters( Min_Fill_Graph & graph, const vector<unsigned> * order, unsigned bound )
+{
+	unsigned var;
+	for ( var = 0; var <= _max_vertex; var++ ) {
+		if ( !graph.Eliminated( var ) && graph.Degree( var ) == 0 ) graph.Remove_Vertex( var );
+	}
+	if ( graph.Num_Vertices() == 0 ) {
+        Simple_TreeD_Cluster first_cluster;
+        first_cluster.vars = new unsigned [1];
+        first_cluster.num_vars = 1;
+        first_cluster.vars[0] = 1;
+        Add_First_Cluster( first_cluster );
+        return;
+	}
+	vector<Simple_TreeD_Cluster> tmp_clusters;
+	vector<unsigned>::const_iterator itr;
+	if ( order != nullptr ) itr = order->begin();
+	while ( true ) {
+		if ( order == nullptr ) var = graph.Min_Key_Vertex();
+		else {
+			while ( itr < order->end() && graph.Eliminated( *itr ) ) itr++;
+			assert( itr < order->end() );  /// NOTE: order must contain all non-isolated vertices
+			var = *itr;
+		}
+		if ( graph.Degree( var ) > bound ) {  /// exceed bound
+			Generate_Singleton_Cluster();
+			for ( unsigned i = tmp_clusters.size() - 1; i != UNSIGNED_UNDEF; i-- ) {
+				delete [] tmp_clusters[i].vars;
+			}
+			return;
+		}
+		if ( graph.Degree( var ) + 1 >= graph.Num_Vertices() ) break;  /// the rest of the vertices form a clique
+		Simple_TreeD_Cluster cluster;
+		cluster.vars = new unsigned [graph.Degree( var ) + 1];
+		cluster.num_vars = 0;
+		const unsigned * p;
+		for ( p = graph.Neighbours_Begin( var ); p < graph.Neighbours_End( var ) && *p < var; p++ ) {
+			cluster.vars[cluster.num_vars++] = *p;
+		}
+		cluster.infor = cluster.num_vars;  /// record the position of var
+		cluster.vars[cluster.num_vars++] = var;
+		for ( ; p < graph.Neighbours_End( var ); p++ ) {
+			cluster.vars[cluster.num_vars++] = *p;
+		}
+		tmp_clusters.push_back( cluster );
+		graph.Eliminate_Vertex( var );
+	}
+	Simple_TreeD_Cluster first_cluster;
+	first_cluster.vars = new unsigned [graph.Degree( var ) + 1];
+	first_cluster.num_vars = 0;
+	const unsigned * p;
+	for ( p = graph.Neighbours_Begin( var ); p < graph.Neighbours_End( var ) && *p < var; p++ ) {
+		first_cluster.vars[first_cluster.num_vars++] = *p;
+	}
+	first_cluster.vars[first_cluster.num_vars++] = var;
+	for ( ; p < graph.Neighbours_End( var ); p++ ) {
+		first_cluster.vars[first_cluster.num_vars++] = *p;
+	}
+	Add_First_Cluster( first_cluster );
+	/* NOTE:
+	* The cluster of an eliminated vertex v is hung below the cluster of the neighbour of v eliminated next,
+	* which contains all the other vertices of the cluster of v, so we need not search all clusters
+	*/
+	vector<unsigned> positions( _max_vertex + 1, tmp_clusters.size() );  // the vertices in the first cluster
+	vector<unsigned> owners( _max_vertex + 1, 0 );
+	for ( unsigned i = 0; i < tmp_clusters.size(); i++ ) {
+		positions[tmp_clusters[i].vars[tmp_clusters[i].infor]] = i;
+	}
+	for ( unsigned i = tmp_clusters.size() - 1; i != UNSIGNED_UNDEF; i-- ) {
+		Simple_TreeD_Cluster & cluster = tmp_clusters[i];
+		unsigned parent = 0;  // NOTE: a vertex isolated by the previous eliminations is hung below the first cluster
+		if ( cluster.num_vars > 1 ) {
+			unsigned next = cluster.vars[cluster.infor == 0];
+			for ( unsigned j = 0; j < cluster.num_vars; j++ ) {
+				if ( j != cluster.infor && positions[cluster.vars[j]] < positions[next] ) next = cluster.vars[j];
+			}
+			parent = owners[next];
+		}
+		if ( _clusters[parent].num_vars == cluster.num_vars - 1 ) {
+			delete [] _clusters[parent].vars;
+			_clusters[parent].num_vars = cluster.num_vars;
+			_clusters[parent].vars = cluster.vars;
+			owners[cluster.vars[cluster.infor]] = parent;
+		}
+		else {
+			Add_Cluster( cluster, parent );
+			owners[cluster.vars[cluster.infor]] = _clusters.size() - 2;
+		}
+	}
+}
+
 void Simple_TreeD::Add_First_Cluster( Simple_TreeD_Cluster & cluster )
 {
 	assert( cluster.adj == nullptr );
@@ -1829,5 +2256,138 @@ void Simple_TreeD::DFS_With_Vertex_Appearance( Simple_TreeD_Cluster & source, un
 	delete [] c_stack;
 }
 
+//====================================================================================================
+
+Anytime_TreeD::Anytime_TreeD( Min_Fill_Graph & graph ): _graph( graph ), _best_width( UNSIGNED_UNDEF ), \
+	_num_rounds( 0 ), _num_stalled_rounds( 0 ), _stop( false ), _time_budget( 0 ), _stall_rounds( 0 )
+{
+	_graph.Set_Num_Threads( 1 );  /// the rounds run in parallel instead
+	Compute_Lower_Bound();
+}
+
+void Anytime_TreeD::Compute_Lower_Bound()
+{
+	/* NOTE:
+	* The degeneracy (the maximum over the minimum degrees when removing a vertex with the minimum degree repeatedly)
+	* is a lower bound of treewidth
+	*/
+	unsigned v, max_vertex = _graph.Max_Vertex(), max_degree = 0;
+	vector<unsigned> degrees( max_vertex + 1, 0 );
+	vector<bool> removed( max_vertex + 1, false );
+	unsigned num_removed = 0;
+	for ( v = 0; v <= max_vertex; v++ ) {
+		if ( _graph.Eliminated( v ) ) {
+			removed[v] = true;
+			num_removed++;
+			continue;
+		}
+		degrees[v] = _graph.Degree( v );
+		if ( degrees[v] > max_degree ) max_degree = degrees[v];
+	}
+	vector<vector<unsigned>> buckets( max_degree + 1 );
+	for ( v = 0; v <= max_vertex; v++ ) {
+		if ( !removed[v] ) buckets[degrees[v]].push_back( v );
+	}
+	_lower_bound = 0;
+	unsigned d = 0;
+	while ( num_removed <= max_vertex ) {
+		while ( buckets[d].empty() ) d++;
+		v = buckets[d].back();
+		buckets[d].pop_back();
+		if ( removed[v] || degrees[v] != d ) continue;  // out-of-date entry
+		removed[v] = true;
+		num_removed++;
+		if ( d > _lower_bound ) _lower_bound = d;
+		for ( const unsigned * p = _graph.Neighbours_Begin( v ); p < _graph.Neighbours_End( v ); p++ ) {
+			unsigned u = *p;
+			if ( removed[u] ) continue;
+			degrees[u]--;
+			buckets[degrees[u]].push_back( u );
+			if ( degrees[u] < d ) d = degrees[u];
+		}
+	}
+}
+
+void Anytime_TreeD::Search( double time_budget, unsigned num_threads, unsigned stall_rounds, int seed )
+{
+	_time_budget = time_budget;
+	_stall_rounds = stall_rounds;
+	_stop = false;
+	if ( num_threads == 0 ) num_threads = std::thread::hardware_concurrency();
+	if ( num_threads == 0 ) num_threads = 1;
+	_watch.Start();
+	vector<std::thread> workers;
+	for ( unsigned i = 1; i < num_threads; i++ ) {
+		workers.push_back( std::thread( &Anytime_TreeD::Run_Worker, this, i, seed ) );
+	}
+	Run_Worker( 0, seed );
+	for ( std::thread & worker: workers ) {
+		worker.join();
+	}
+}
+
+void Anytime_TreeD::Run_Worker( unsigned id, int seed )
+{
+	Random_Generator rand_gen( seed + id );
+	vector<unsigned> order;
+	for ( unsigned round = 0; ( id == 0 && round == 0 ) || !Terminated(); round++ ) {  // the first round always completes
+		unsigned strategy = ( id == 0 && round == 0 ) ? 0 : 1 + ( id + round ) % 2;
+		unsigned bound;
+		_mutex.lock();
+		bound = _best_width;
+		_mutex.unlock();
+		unsigned width = Eliminate( rand_gen, strategy, bound, order );
+		Update( width, order );
+	}
+}
+
+unsigned Anytime_TreeD::Eliminate( Random_Generator & rand_gen, unsigned strategy, unsigned bound, vector<unsigned> & order )
+{
+	/* NOTE:
+	* strategy 0: min-fill with the first minimum, which is the same as Simple_TreeD( graph )
+	* strategy 1: min-fill with random tie-breaking
+	* strategy 2: min-degree with random tie-breaking
+	*/
+	Min_Fill_Graph graph( _graph );
+	if ( strategy == 2 ) graph.Set_Key_Mode( true );
+	if ( strategy != 0 ) graph.Shuffle_Buckets( rand_gen );
+	order.clear();
+	unsigned width = 0;
+	while ( graph.Num_Vertices() > 0 ) {
+		if ( ( order.size() & 0x3FF ) == 0 && bound != UNSIGNED_UNDEF && Terminated() ) return UNSIGNED_UNDEF;
+		unsigned v = graph.Min_Key_Vertex();
+		if ( graph.Degree( v ) > width ) width = graph.Degree( v );
+		if ( width >= bound ) return UNSIGNED_UNDEF;
+		if ( graph.Degree( v ) + 1 == graph.Num_Vertices() ) {  // the rest of the vertices form a clique
+			order.push_back( v );
+			order.insert( order.end(), graph.Neighbours_Begin( v ), graph.Neighbours_End( v ) );
+			break;
+		}
+		order.push_back( v );
+		graph.Eliminate_Vertex( v );
+	}
+	return width;
+}
+
+bool Anytime_TreeD::Terminated()
+{
+	if ( _stop ) return true;
+	if ( _watch.Timeout( _time_budget ) ) _stop = true;
+	return _stop;
+}
+
+void Anytime_TreeD::Update( unsigned width, vector<unsigned> & order )
+{
+	std::lock_guard<std::mutex> guard( _mutex );
+	_num_rounds++;
+	if ( width < _best_width ) {
+		_best_width = width;
+		_best_order.swap( order );
+		_num_stalled_rounds = 0;
+	}
+	else _num_stalled_rounds++;
+	if ( _best_width <= _lower_bound || _num_stalled_rounds >= _stall_rounds ) _stop = true;
+}
+
 
 }
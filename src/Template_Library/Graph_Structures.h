@@ -2,7 +2,10 @@
 #define _Graph_Structures_h_
 
 #include "Basic_Functions.h"
+#include "Time_Memory.h"
 #include "../Primitive_Types/CNF_Formula.h"
+#include <mutex>
+#include <atomic>
 
 
 namespace KCBox {
@@ -144,6 +147,7 @@ struct Vertex
 class Greedy_Graph
 {
 	friend class Simple_TreeD;
+	friend class Anytime_TreeD;
 protected:
 	/*NOTE:
 	The actual number of vertices may be less than max_vertex due to the removal of vertices
@@ -193,6 +197,7 @@ public:
 	void Induced_Order_Min_Fill_Opt( unsigned * chain );
 	unsigned Induced_Width_Min_Fill_Opt();
 	unsigned Induced_Width_Min_Fill_Bound( unsigned bound );  // if output <= bound, then it is the true width, else it is not
+	void Export_Edges( vector<vector<unsigned>> & edges );  // all neighbours of i are stored in edges[i]
 	void Strongly_Connected_Components( vector<vector<unsigned>> & components );  /// Tarjan's strongly connected components algorithm
 	void Strongly_Connected_Component( unsigned v, vector<unsigned> & component );  /// Tarjan's strongly connected components algorithm
 	void Display( ostream & fout );
@@ -525,6 +530,127 @@ inline void Greedy_Graph::Free_Neighbour( Neighbour * n )
 //====================================================================================================
 
 
+/* NOTE:
+* Min_Fill_Graph is a compact counterpart of Greedy_Graph for greedy elimination on large graphs.
+* The sorted adjacency of each vertex is a slice of one pool (compressed sparse rows with slack), and a vertex whose
+* degree reaches _dense_degree additionally keeps a bitset row for constant-time adjacency tests.
+* The vertices not eliminated yet are kept in a bucket priority queue keyed by fill size (or by degree), and eliminating
+* a vertex only updates the keys around it: the common neighbours of each fill edge lose one fill,
+* and the fill sizes of the neighbours are recomputed, on several threads if there are many of them.
+*/
+class Min_Fill_Graph
+{
+protected:
+	unsigned _max_vertex;
+	unsigned _num_vertices;  // the number of vertices not eliminated yet
+	bool _by_degree;  // the keys are degrees instead of fill sizes
+	vector<unsigned> _pool;  // the neighbours of v are _pool[_offsets[v], _offsets[v] + _degrees[v])
+	vector<size_t> _offsets;
+	vector<unsigned> _degrees;  // UNSIGNED_UNDEF denotes an eliminated vertex
+	vector<unsigned> _capacities;
+	unsigned _dense_degree;
+	vector<vector<uint64_t>> _rows;  // empty for the vertices without bitset row
+	vector<size_t> _keys;
+	vector<unsigned> _bucket_heads;  // the last bucket holds all keys not less than it
+	vector<unsigned> _bucket_next;
+	vector<unsigned> _bucket_prev;
+	unsigned _min_bucket;
+	unsigned _num_threads;
+protected:  // auxiliary memory
+	vector<vector<bool>> _marks;  // one per thread
+	vector<bool> _adjacent;
+	vector<unsigned> _neighbours;
+	vector<size_t> _new_keys;
+public:
+	Min_Fill_Graph( unsigned max, vector<vector<unsigned>> & edges, bool by_degree = false, unsigned num_threads = 1 ); // all neighbours of i are stored in edges[i]
+	Min_Fill_Graph( Greedy_Graph & graph, bool by_degree = false, unsigned num_threads = 1 );
+	unsigned Max_Vertex() const { return _max_vertex; }
+	unsigned Num_Vertices() const { return _num_vertices; }
+	bool Eliminated( unsigned v ) const { return _degrees[v] == UNSIGNED_UNDEF; }
+	unsigned Degree( unsigned v ) const { return _degrees[v]; }
+	size_t Key( unsigned v ) const { return _keys[v]; }
+	const unsigned * Neighbours_Begin( unsigned v ) const { return _pool.data() + _offsets[v]; }
+	const unsigned * Neighbours_End( unsigned v ) const { return _pool.data() + _offsets[v] + _degrees[v]; }
+	inline bool Adjacent( unsigned u, unsigned v ) const;
+	void Set_Key_Mode( bool by_degree );
+	void Set_Num_Threads( unsigned num_threads );  /// num_threads == 0 means the number of hardware threads
+	void Shuffle_Buckets( Random_Generator & rand_gen );  /// randomize the ties of the priority queue
+	unsigned Min_Key_Vertex();  /// the vertex with the minimum key, which is not removed from the queue
+	void Eliminate_Vertex( unsigned v );  /// connect the neighbours of v pairwise and remove v
+	void Remove_Vertex( unsigned v );  /// remove v without connecting its neighbours
+	void Verify_Keys();
+protected:
+	void Build( vector<vector<unsigned>> & edges );
+	void Build_Row( unsigned v );
+	inline void Add_Neighbour( unsigned u, unsigned v );
+	inline void Remove_Neighbour( unsigned u, unsigned v );
+	size_t Compute_Key( unsigned v, vector<bool> & marks ) const;
+	void Discount_Common_Neighbours( unsigned u, unsigned v );  /// u and v become adjacent, so their common neighbours lose one fill
+	void Update_Keys( const vector<unsigned> & vertices );
+	void Compute_Keys_Parallel( const vector<unsigned> & vertices, size_t * keys );
+	void Rebuild_Buckets( const vector<unsigned> & vertices );
+	inline void Bucket_Insert( unsigned v );
+	inline void Bucket_Erase( unsigned v );
+	unsigned Bucket_Of( size_t key ) const { return key < _bucket_heads.size() - 1 ? key : _bucket_heads.size() - 1; }
+};
+
+inline bool Min_Fill_Graph::Adjacent( unsigned u, unsigned v ) const
+{
+	if ( !_rows[u].empty() ) return ( _rows[u][v >> 6] >> ( v & 63 ) ) & 1;
+	if ( !_rows[v].empty() ) return ( _rows[v][u >> 6] >> ( u & 63 ) ) & 1;
+	if ( _degrees[u] > _degrees[v] ) std::swap( u, v );
+	return std::binary_search( Neighbours_Begin( u ), Neighbours_End( u ), v );
+}
+
+inline void Min_Fill_Graph::Add_Neighbour( unsigned u, unsigned v )
+{
+	if ( _degrees[u] == _capacities[u] ) {  // move the slice to the end of the pool
+		size_t new_offset = _pool.size();
+		_capacities[u] = _capacities[u] < 2 ? 4 : 2 * _capacities[u];
+		_pool.resize( new_offset + _capacities[u] );
+		std::copy( _pool.begin() + _offsets[u], _pool.begin() + _offsets[u] + _degrees[u], _pool.begin() + new_offset );
+		_offsets[u] = new_offset;
+	}
+	unsigned * begin = _pool.data() + _offsets[u];
+	unsigned * pos = std::upper_bound( begin, begin + _degrees[u], v );
+	std::copy_backward( pos, begin + _degrees[u], begin + _degrees[u] + 1 );
+	*pos = v;
+	_degrees[u]++;
+	if ( !_rows[u].empty() ) _rows[u][v >> 6] |= uint64_t(1) << ( v & 63 );
+	else if ( _degrees[u] >= _dense_degree ) Build_Row( u );
+}
+
+inline void Min_Fill_Graph::Remove_Neighbour( unsigned u, unsigned v )
+{
+	unsigned * begin = _pool.data() + _offsets[u];
+	unsigned * pos = std::lower_bound( begin, begin + _degrees[u], v );
+	assert( pos < begin + _degrees[u] && *pos == v );
+	std::copy( pos + 1, begin + _degrees[u], pos );
+	_degrees[u]--;
+	if ( !_rows[u].empty() ) _rows[u][v >> 6] &= ~( uint64_t(1) << ( v & 63 ) );
+}
+
+inline void Min_Fill_Graph::Bucket_Insert( unsigned v )
+{
+	unsigned b = Bucket_Of( _keys[v] );
+	_bucket_prev[v] = UNSIGNED_UNDEF;
+	_bucket_next[v] = _bucket_heads[b];
+	if ( _bucket_heads[b] != UNSIGNED_UNDEF ) _bucket_prev[_bucket_heads[b]] = v;
+	_bucket_heads[b] = v;
+	if ( b < _min_bucket ) _min_bucket = b;
+}
+
+inline void Min_Fill_Graph::Bucket_Erase( unsigned v )
+{
+	if ( _bucket_prev[v] != UNSIGNED_UNDEF ) _bucket_next[_bucket_prev[v]] = _bucket_next[v];
+	else _bucket_heads[Bucket_Of( _keys[v] )] = _bucket_next[v];
+	if ( _bucket_next[v] != UNSIGNED_UNDEF ) _bucket_prev[_bucket_next[v]] = _bucket_prev[v];
+}
+
+
+//====================================================================================================
+
+
 struct TreeD_Cluster_Adjacency
 {
 	unsigned ordinal;  // point the adjacent cluster
@@ -593,6 +719,8 @@ public:
 	Simple_TreeD( Greedy_Graph & graph );  // using min-fill to generate tree decomposition from graph
 	Simple_TreeD( Greedy_Graph & graph, unsigned bound );  /// using min-fill to generate tree decomposition from graph, and if the treewidth exceeds bound, then terminate
 	Simple_TreeD( Greedy_Graph & graph, unsigned bound, bool opt );  /// using min-fill to generate tree decomposition from graph, and if the treewidth exceeds bound, then terminate
+	Simple_TreeD( Min_Fill_Graph & graph, unsigned bound = UNSIGNED_UNDEF );  /// the same as the above one with opt, but scales to large graphs
+	Simple_TreeD( Min_Fill_Graph & graph, const vector<unsigned> & order );  /// generate tree decomposition from graph by eliminating the vertices in order
 	Simple_TreeD( istream & in );
 	~Simple_TreeD();
 	Chain Transform_Chain( double * weight );
@@ -610,6 +738,7 @@ protected:
 	void Allocate_and_Init_Auxiliary_Memory();
 	void Free_Auxiliary_Memory();
     void Generate_Clusters( Greedy_Graph & graph );
+    void Generate_Clusters( Min_Fill_Graph & graph, const vector<unsigned> * order, unsigned bound );
     void Generate_Singleton_Cluster();
 	void Add_First_Cluster( Simple_TreeD_Cluster & cluster );
 	void Add_Cluster( Simple_TreeD_Cluster & cluster, unsigned neighbour );
@@ -644,6 +773,45 @@ public:
 
 
 
+//====================================================================================================
+
+
+/* NOTE:
+* Anytime_TreeD runs randomized greedy elimination (min-fill and min-degree with random tie-breaking) on several
+* threads, and each round works on its own copy of the graph. A round whose width reaches the best width found so far
+* is cut off. The search stops when the time budget is used up, when the best width has not improved for a number of
+* rounds, or when it meets the degeneracy lower bound.
+*/
+class Anytime_TreeD
+{
+protected:
+	Min_Fill_Graph _graph;  // each round eliminates a copy of it
+	unsigned _lower_bound;  // degeneracy of the graph
+	vector<unsigned> _best_order;
+	unsigned _best_width;
+	unsigned _num_rounds;
+	unsigned _num_stalled_rounds;
+	std::mutex _mutex;  // protects the best order and the round counters
+	std::atomic<bool> _stop;
+	StopWatch _watch;
+	double _time_budget;
+	unsigned _stall_rounds;
+public:
+	Anytime_TreeD( Min_Fill_Graph & graph );
+	void Search( double time_budget, unsigned num_threads, unsigned stall_rounds, int seed );  /// num_threads == 0 means the number of hardware threads
+	unsigned Width() const { return _best_width; }
+	unsigned Lower_Bound() const { return _lower_bound; }
+	unsigned Num_Rounds() const { return _num_rounds; }
+	const vector<unsigned> & Elimination_Order() const { return _best_order; }
+protected:
+	void Compute_Lower_Bound();
+	void Run_Worker( unsigned id, int seed );
+	unsigned Eliminate( Random_Generator & rand_gen, unsigned strategy, unsigned bound, vector<unsigned> & order );  /// return UNSIGNED_UNDEF if the width reaches bound
+	bool Terminated();
+	void Update( unsigned width, vector<unsigned> & order );
+};
+
+
 }
 
 
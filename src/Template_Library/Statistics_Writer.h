@@ -0,0 +1,150 @@
+#ifndef _Statistics_Writer_h_
+#define _Statistics_Writer_h_
+
+#include "Basic_Functions.h"
+#include "Time_Memory.h"
+#include <fstream>
+#include <cstdio>
+#include <cmath>
+
+
+namespace KCBox {
+
+
+/****************************************************************************************************
+*                                                                                                   *
+*                                         JSON                                                      *
+*                                                                                                   *
+****************************************************************************************************/
+
+class JSON_Writer  // writes one JSON object whose values are numbers, strings or nested objects
+{
+protected:
+	ostream & _out;
+	vector<bool> _firsts;  // whether no member has been written in each open object
+public:
+	JSON_Writer( ostream & out ): _out( out )
+	{
+		_out.precision( 10 );
+		_out << "{";
+		_firsts.push_back( true );
+	}
+	~JSON_Writer() { while ( !_firsts.empty() ) End_Object(); }
+	void Begin_Object( const char * name )
+	{
+		Key( name );
+		_out << "{";
+		_firsts.push_back( true );
+	}
+	void End_Object()
+	{
+		_firsts.pop_back();
+		_out << "}";
+		if ( _firsts.empty() ) _out << endl;
+	}
+	template <typename T> void Field( const char * name, T value )
+	{
+		Key( name );
+		_out << value;
+	}
+	void Field( const char * name, double value )
+	{
+		Key( name );
+		if ( std::isfinite( value ) ) _out << value;
+		else _out << "null";
+	}
+	void Field( const char * name, float value )
+	{
+		std::streamsize old_precision = _out.precision( 7 );  // no digits beyond the precision of float
+		Field( name, (double) value );
+		_out.precision( old_precision );
+	}
+	void Field( const char * name, bool value )
+	{
+		Key( name );
+		_out << ( value ? "true" : "false" );
+	}
+	void Field( const char * name, const char * value )
+	{
+		Key( name );
+		if ( value == nullptr ) {
+			_out << "null";
+			return;
+		}
+		_out << '"';
+		for ( ; *value != '\0'; value++ ) {
+			if ( *value == '"' || *value == '\\' ) _out << '\\' << *value;
+			else if ( (unsigned char) *value < 0x20 ) _out << ' ';
+			else _out << *value;
+		}
+		_out << '"';
+	}
+protected:
+	void Key( const char * name )
+	{
+		if ( !_firsts.back() ) _out << ",";
+		_firsts.back() = false;
+		_out << '"' << name << "\":";
+	}
+};
+
+
+/****************************************************************************************************
+*                                                                                                   *
+*                                         Statistics snapshots                                      *
+*                                                                                                   *
+****************************************************************************************************/
+
+template <typename Engine> bool Write_Statistics_File( Engine & engine, const char * path )  /// NOTE: Engine provides Write_Statistics_JSON( JSON_Writer & )
+{
+	string tmp_path = string( path ) + ".tmp";  // a reader never sees a half-written document
+	ofstream fout( tmp_path );
+	if ( !fout ) {
+		cerr << "Warning[Write_Statistics_File]: cannot open " << tmp_path << endl;
+		return false;
+	}
+	{
+		JSON_Writer writer( fout );
+		engine.Write_Statistics_JSON( writer );
+	}
+	fout.close();
+	if ( !fout || rename( tmp_path.c_str(), path ) != 0 ) {
+		cerr << "Warning[Write_Statistics_File]: cannot write " << path << endl;
+		return false;
+	}
+	return true;
+}
+
+class Statistics_Snapshots  // rewrites the statistics file periodically during a long run
+{
+protected:
+	string _path;
+	double _interval;  // in seconds
+	StopWatch _watch;
+	unsigned _num_written;
+public:
+	Statistics_Snapshots(): _interval( 0 ), _num_written( 0 ) {}
+	void Open( const char * path, double interval )  // no snapshots when path is nullptr or interval is nonpositive
+	{
+		if ( path == nullptr || interval <= 0 ) _path.clear();
+		else _path = path;
+		_interval = interval;
+		_num_written = 0;
+		_watch.Start();
+	}
+	void Close() { _path.clear(); }
+	unsigned Num_Written() const { return _num_written; }
+	bool Due() { return !_path.empty() && _watch.Get_Elapsed_Seconds() >= _interval; }
+	template <typename Engine> void Write( Engine & engine )
+	{
+		Write_Statistics_File( engine, _path.c_str() );
+		_num_written++;
+		_watch.Start();
+	}
+};
+
+
+}
+
+
+#endif
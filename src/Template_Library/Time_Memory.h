@@ -4,6 +4,11 @@
 #include "Basic_Functions.h"
 #include <unistd.h>
 #include <asm/param.h>
+#include <sys/resource.h>
+#include <ctime>
+#include <cstdio>
+#include <csignal>
+#include <atomic>
 
 
 namespace KCBox {
@@ -53,61 +58,186 @@ private:
 *                                                                                                   *
 ****************************************************************************************************/
 
-inline size_t Total_Used_Memory()  // idea from Mate Soos
+inline size_t Total_Used_Memory()  // the resident set, read from statm which is shorter to parse than stat
 {
-	using std::ios_base;
-	using std::ifstream;
-	using std::string;
-
-	// 'file' stat seems to give the most reliable results
-	ifstream stat_stream("/proc/self/stat", ios_base::in);
-
-	// dummy vars for leading entries in stat that we don't care about
-	string pid, comm, state, ppid, pgrp, session, tty_nr;
-	string tpgid, flags, minflt, cminflt, majflt, cmajflt;
-	string utime, stime, cutime, cstime, priority, nice;
-	string O, itrealvalue, starttime, vsize;
-	// the field we want
-	size_t rss;
-
-	stat_stream >> pid >> comm >> state >> ppid >> pgrp >> session >> tty_nr
-			   >> tpgid >> flags >> minflt >> cminflt >> majflt >> cmajflt
-			   >> utime >> stime >> cutime >> cstime >> priority >> nice
-			   >> O >> itrealvalue >> starttime >> vsize >> rss; // don't care about the rest
-
-	stat_stream.close();
-
-	size_t page_size_kb = sysconf(_SC_PAGE_SIZE); // in case x86-64 is configured to use 2MB pages
-	size_t resident_set = rss * page_size_kb;
-	return resident_set;
+	FILE * fin = fopen( "/proc/self/statm", "r" );
+	if ( fin == nullptr ) return 0;
+	size_t size, resident = 0;
+	if ( fscanf( fin, "%zu %zu", &size, &resident ) != 2 ) resident = 0;
+	fclose( fin );
+	return resident * sysconf( _SC_PAGE_SIZE );
 }
 
-inline float Total_Elapsed_Seconds()
+inline size_t Peak_Used_Memory()  // the high-water mark of the resident set
 {
-	using std::ios_base;
-	using std::ifstream;
-	using std::string;
+	rusage usage;
+	if ( getrusage( RUSAGE_SELF, &usage ) != 0 ) return 0;
+	return (size_t) usage.ru_maxrss * 1024;  // ru_maxrss is in kilobytes on Linux
+}
+
+enum Memory_Subsystem
+{
+	Memory_Cache = 0,  // the component caches
+	Memory_Nodes,  // the node tables of the decision diagrams
+	Memory_Clauses,  // the literals of the clauses
+	Memory_Models,  // the model pools
+	Memory_Limbs,  // the limbs of the GMP numbers, wherever they live
+	Memory_Num_Subsystems
+};
 
-	// 'file' stat seems to give the most reliable results
-	ifstream stat_stream("/proc/self/stat", ios_base::in);
+class Memory_Ledger  // the bytes held by each subsystem of the process, charged and released where they are allocated
+{
+	/* NOTE:
+	* A query costs a few relaxed loads, so the limits are checked against it rather than against the resident
+	* set in /proc or a walk over the tables. The counters are shared by all threads, and a release may run
+	* ahead of its charge or come from a GMP number allocated before the tracking starts, so a counter that
+	* wraps below zero is read as zero
+	*/
+public:
+	static void Charge( Memory_Subsystem subsystem, size_t bytes ) { Counter( subsystem ).fetch_add( bytes, std::memory_order_relaxed ); }
+	static void Release( Memory_Subsystem subsystem, size_t bytes ) { Counter( subsystem ).fetch_sub( bytes, std::memory_order_relaxed ); }
+	static size_t Used( Memory_Subsystem subsystem )
+	{
+		size_t bytes = Counter( subsystem ).load( std::memory_order_relaxed );
+		return bytes <= SIZET_UNDEF / 2 ? bytes : 0;
+	}
+	static size_t Total()
+	{
+		size_t bytes = 0;
+		for ( unsigned i = 0; i < Memory_Num_Subsystems; i++ ) {
+			bytes += Used( Memory_Subsystem( i ) );
+		}
+		return bytes;
+	}
+	static const char * Name( Memory_Subsystem subsystem )
+	{
+		static const char * names[Memory_Num_Subsystems] = { "cache", "nodes", "clauses", "models", "limbs" };
+		return names[subsystem];
+	}
+protected:
+	static std::atomic<size_t> & Counter( Memory_Subsystem subsystem )
+	{
+		static std::atomic<size_t> counters[Memory_Num_Subsystems];  // zero-initialized as statics
+		return counters[subsystem];
+	}
+};
 
-	// dummy vars for leading entries in stat that we don't care about
-	string pid, comm, state, ppid, pgrp, session, tty_nr;
-	string tpgid, flags, minflt, cminflt, majflt, cmajflt;
-	long utime, stime;  // the field we want
-	string cutime, cstime, priority, nice;
-	string O, itrealvalue, starttime, vsize, rss;
+template <Memory_Subsystem S> class Memory_Account  // a byte count that keeps the ledger of its subsystem in step
+{
+protected:
+	size_t _bytes;
+public:
+	Memory_Account( size_t bytes = 0 ): _bytes( bytes ) { Memory_Ledger::Charge( S, bytes ); }
+	Memory_Account( const Memory_Account & other ): _bytes( other._bytes ) { Memory_Ledger::Charge( S, _bytes ); }
+	~Memory_Account() { Memory_Ledger::Release( S, _bytes ); }
+	Memory_Account & operator = ( const Memory_Account & other ) { return *this = other._bytes; }
+	Memory_Account & operator = ( size_t bytes )
+	{
+		Memory_Ledger::Charge( S, bytes - _bytes );  // wraps around when shrinking, which the atomic addition undoes
+		_bytes = bytes;
+		return *this;
+	}
+	Memory_Account & operator += ( size_t bytes ) { Memory_Ledger::Charge( S, bytes );  _bytes += bytes;  return *this; }
+	Memory_Account & operator -= ( size_t bytes ) { Memory_Ledger::Release( S, bytes );  _bytes -= bytes;  return *this; }
+	operator size_t () const { return _bytes; }
+};
 
-	stat_stream >> pid >> comm >> state >> ppid >> pgrp >> session >> tty_nr
-			   >> tpgid >> flags >> minflt >> cminflt >> majflt >> cmajflt
-			   >> utime >> stime >> cutime >> cstime >> priority >> nice
-			   >> O >> itrealvalue >> starttime >> vsize >> rss; // don't care about the rest
+inline float Total_Elapsed_Seconds()  // the CPU time of the process, without opening any file
+{
+	timespec ts;
+	if ( clock_gettime( CLOCK_PROCESS_CPUTIME_ID, &ts ) != 0 ) return 0;
+	return ts.tv_sec + ts.tv_nsec / 1000000000.0;
+}
 
-	stat_stream.close();
 
-	return (float)(utime + stime) / HZ;
+/****************************************************************************************************
+*                                                                                                   *
+*                                         Budget                                                    *
+*                                                                                                   *
+****************************************************************************************************/
+
+enum Run_Status
+{
+	Run_Done = 0,
+	Run_Cancelled,
+	Run_Timeout,
+	Run_Memory_Out
+};
+
+class Run_Budget  // the limits of one run, polled by the search loop of an engine
+{
+public:
+	double time_limit;  // in seconds, and unlimited if nonpositive
+	size_t memory_limit;  // in bytes, and unlimited if zero
+	const std::atomic<bool> * cancel;  // another thread interrupts the run by setting it
+protected:
+	bool _active;
+	unsigned _num_polls;
+	Run_Status _status;
+	StopWatch _watch;
+public:
+	Run_Budget(): time_limit( 0 ), memory_limit( 0 ), cancel( nullptr ), _active( false ), _num_polls( 0 ), _status( Run_Done ) {}
+	void Start()
+	{
+		_active = time_limit > 0 || memory_limit > 0 || cancel != nullptr;
+		_num_polls = 0;
+		_status = Run_Done;
+		_watch.Start();
+	}
+	bool Active() const { return _active; }
+	Run_Status Status() const { return _status; }
+	bool Interrupted() const { return _status != Run_Done; }
+	void Stop( Run_Status status ) { _status = status; }  // when a helper engine has stopped on its own budget
+	double Remaining_Seconds() { return time_limit - _watch.Get_Elapsed_Seconds(); }  /// NOTE: meaningful only with a time limit
+	Run_Budget Share()  // for the helper engines running in parallel, whose memory is in the same ledger
+	{
+		Run_Budget helper = *this;
+		if ( time_limit > 0 ) helper.time_limit = std::max( Remaining_Seconds(), 0.001 );
+		return helper;
+	}
+	bool Exhausted( unsigned poll_mask = 0xFF )  /// NOTE: the flag is read on every call, but the clock and the ledger only on every 256th by default
+	{
+		if ( _status != Run_Done ) return true;
+		if ( cancel != nullptr && cancel->load( std::memory_order_relaxed ) ) _status = Run_Cancelled;
+		else if ( ( ++_num_polls & poll_mask ) == 0 ) {
+			if ( time_limit > 0 && _watch.Get_Elapsed_Seconds() >= time_limit ) _status = Run_Timeout;
+			else if ( memory_limit > 0 && Memory_Ledger::Total() > memory_limit ) _status = Run_Memory_Out;
+		}
+		return _status != Run_Done;
+	}
+};
+
+inline std::atomic<bool> & Interrupt_Signal()  // set by the first SIGINT after Catch_Interrupt_Signal
+{
+	static std::atomic<bool> flag( false );
+	return flag;
+}
+
+inline void Handle_Interrupt_Signal( int )
+{
+	Interrupt_Signal().store( true );
+	signal( SIGINT, SIG_DFL );  // a second one terminates the process as usual
 }
 
+inline void Catch_Interrupt_Signal()
+{
+	Interrupt_Signal();  // initialized before the handler may run
+	signal( SIGINT, Handle_Interrupt_Signal );
+}
+
+inline const char * Run_Status_Name( Run_Status status )
+{
+	switch ( status ) {
+	case Run_Done:
+		return "done";
+	case Run_Cancelled:
+		return "cancelled";
+	case Run_Timeout:
+		return "timeout";
+	default:
+		return "memory out";
+	}
+}
 
 }
 
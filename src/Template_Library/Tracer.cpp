@@ -0,0 +1,103 @@
+#include "Tracer.h"
+#include <fstream>
+
+
+namespace KCBox {
+
+
+const char * trace_phase_names[Trace_Num_Phases] = { "ibcp", "sat_imp", "decompose", "cache_lookup", "cache_clear", "kernelize", "var_order" };
+
+bool Tracer::enabled = false;
+
+uint64_t Tracer::min_event_ticks = 0;
+
+unsigned Tracer::sample_period = 1;
+
+size_t Tracer::max_events = 0;
+
+thread_local Trace_Buffer * Tracer::_thread_buffer = nullptr;
+
+std::mutex Tracer::_mutex;
+
+vector<Trace_Buffer *> Tracer::_buffers;
+
+uint64_t Tracer::_start_ticks = 0;
+
+uint64_t Tracer::_start_ns = 0;
+
+void Tracer::Start( unsigned period, double min_event_us, size_t max_events_per_thread )
+{
+	_start_ns = Monotonic_Nanoseconds();
+	_start_ticks = Trace_Ticks();
+	uint64_t ns = _start_ns;
+	while ( Monotonic_Nanoseconds() < ns + 10000000 ) {}  // estimate the tick rate over 10 ms for the threshold
+	double ticks_per_us = Ticks_Per_Microsecond();
+	sample_period = period > 0 ? period : 1;
+	min_event_ticks = min_event_us * ticks_per_us;
+	max_events = max_events_per_thread;
+	enabled = true;
+}
+
+double Tracer::Ticks_Per_Microsecond()
+{
+	uint64_t ticks = Trace_Ticks() - _start_ticks;
+	uint64_t ns = Monotonic_Nanoseconds() - _start_ns;
+	if ( ns == 0 ) return 1;
+	return ticks * 1000.0 / ns;
+}
+
+Trace_Buffer * Tracer::Register_Thread()
+{
+	std::lock_guard<std::mutex> lock( _mutex );
+	Trace_Buffer * buffer = new Trace_Buffer( _buffers.size() + 1 );
+	_buffers.push_back( buffer );
+	return buffer;
+}
+
+bool Tracer::Export( const char * path )
+{
+	/* NOTE:
+	* The buffers outlive their threads, so the workers joined before are exported too; they are not freed,
+	* since a pooled worker may still hold its own. The totals of every phase over all threads are stored
+	* in otherData, including the scopes omitted from the timeline
+	*/
+	enabled = false;
+	double ticks_per_us = Ticks_Per_Microsecond();
+	std::lock_guard<std::mutex> lock( _mutex );
+	ofstream fout( path );
+	if ( !fout ) {
+		cerr << "Warning[Tracer]: cannot open " << path << endl;
+		return false;
+	}
+	fout << std::fixed;
+	fout.precision( 3 );
+	fout << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[" << endl;
+	bool first = true;
+	for ( Trace_Buffer * buffer: _buffers ) {
+		if ( !first ) fout << "," << endl;
+		first = false;
+		fout << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->tid;
+		fout << ",\"args\":{\"name\":\"" << ( buffer->tid == 1 ? "main" : "worker" ) << " " << buffer->tid << "\"}}";
+		for ( const Trace_Event & event: buffer->events ) {
+			fout << "," << endl;
+			fout << "{\"name\":\"" << trace_phase_names[event.phase] << "\",\"cat\":\"kcbox\",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->tid;
+			fout << ",\"ts\":" << ( event.begin - _start_ticks ) / ticks_per_us << ",\"dur\":" << ( event.end - event.begin ) / ticks_per_us << "}";
+		}
+	}
+	fout << endl << "],\"otherData\":{";
+	for ( unsigned i = 0; i < Trace_Num_Phases; i++ ) {
+		uint64_t count = 0, ticks = 0;
+		for ( Trace_Buffer * buffer: _buffers ) {
+			count += buffer->counts[i];
+			ticks += buffer->ticks[i];
+		}
+		if ( i > 0 ) fout << ",";
+		fout << "\"" << trace_phase_names[i] << "\":{\"count\":" << count << ",\"seconds\":" << ticks / ticks_per_us / 1000000 << "}";
+	}
+	fout << "}}" << endl;
+	fout.close();
+	return (bool) fout;
+}
+
+
+}
@@ -0,0 +1,144 @@
+#ifndef _Tracer_h_
+#define _Tracer_h_
+
+#include "Basic_Functions.h"
+#include <mutex>
+#include <ctime>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+
+namespace KCBox {
+
+
+/****************************************************************************************************
+*                                                                                                   *
+*                                         Clocks                                                    *
+*                                                                                                   *
+****************************************************************************************************/
+
+inline uint64_t Monotonic_Nanoseconds()
+{
+	timespec ts;
+	clock_gettime( CLOCK_MONOTONIC_RAW, &ts );
+	return (uint64_t) ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+inline uint64_t Trace_Ticks()  // the time stamp counter where available, and nanoseconds otherwise
+{
+#if defined(__x86_64__) || defined(__i386__)
+	return __rdtsc();
+#else
+	return Monotonic_Nanoseconds();
+#endif
+}
+
+
+/****************************************************************************************************
+*                                                                                                   *
+*                                         Tracer                                                    *
+*                                                                                                   *
+****************************************************************************************************/
+
+enum Trace_Phase
+{
+	Trace_IBCP = 0,
+	Trace_SAT_Imp,
+	Trace_Decompose,
+	Trace_Cache_Lookup,
+	Trace_Cache_Clear,
+	Trace_Kernelize,
+	Trace_Var_Order,
+	Trace_Num_Phases
+};
+
+extern const char * trace_phase_names[Trace_Num_Phases];
+
+struct Trace_Event
+{
+	uint64_t begin;
+	uint64_t end;
+	unsigned phase;
+};
+
+struct Trace_Buffer  // the counters and the recorded events of one thread
+{
+	unsigned tid;
+	uint64_t counts[Trace_Num_Phases];
+	uint64_t ticks[Trace_Num_Phases];
+	vector<Trace_Event> events;
+	Trace_Buffer( unsigned id ): tid( id )
+	{
+		for ( unsigned i = 0; i < Trace_Num_Phases; i++ ) {
+			counts[i] = ticks[i] = 0;
+		}
+	}
+	inline void Add( unsigned phase, uint64_t begin, uint64_t end );
+};
+
+class Tracer
+{
+	/* NOTE:
+	* Every scope of a phase is counted and timed in ticks of its own thread, without locks. The timeline
+	* keeps only the scopes longer than the threshold and one in sample_period of the others, up to
+	* max_events per thread, so a long run yields a trace of bounded size. Ticks are converted into time
+	* at export, by the ratio measured between Start and Export
+	*/
+public:
+	static bool enabled;
+	static uint64_t min_event_ticks;
+	static unsigned sample_period;
+	static size_t max_events;
+protected:
+	static thread_local Trace_Buffer * _thread_buffer;
+	static std::mutex _mutex;
+	static vector<Trace_Buffer *> _buffers;
+	static uint64_t _start_ticks;
+	static uint64_t _start_ns;
+public:
+	static void Start( unsigned period, double min_event_us, size_t max_events_per_thread = 1 << 22 );
+	static bool Export( const char * path );  // in the trace event format of Chrome, which Perfetto reads
+	static Trace_Buffer & Thread_Buffer()
+	{
+		if ( _thread_buffer == nullptr ) _thread_buffer = Register_Thread();
+		return *_thread_buffer;
+	}
+protected:
+	static Trace_Buffer * Register_Thread();
+	static double Ticks_Per_Microsecond();
+};
+
+inline void Trace_Buffer::Add( unsigned phase, uint64_t begin, uint64_t end )
+{
+	counts[phase]++;
+	ticks[phase] += end - begin;
+	if ( events.size() < Tracer::max_events ) {
+		if ( end - begin >= Tracer::min_event_ticks || counts[phase] % Tracer::sample_period == 0 ) {
+			Trace_Event event = { begin, end, phase };
+			events.push_back( event );
+		}
+	}
+}
+
+class Trace_Scope  /// NOTE: costs one branch when tracing is off
+{
+protected:
+	unsigned _phase;
+	uint64_t _begin;
+public:
+	Trace_Scope( Trace_Phase phase ): _phase( phase ), _begin( 0 )
+	{
+		if ( Tracer::enabled ) _begin = Trace_Ticks();
+	}
+	~Trace_Scope()
+	{
+		if ( Tracer::enabled && _begin != 0 ) Tracer::Thread_Buffer().Add( _phase, _begin, Trace_Ticks() );
+	}
+};
+
+
+}
+
+
+#endif
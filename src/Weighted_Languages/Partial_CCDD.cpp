@@ -1,4 +1,6 @@
 #include "Partial_CCDD.h"
+#include "../Template_Library/Checkpoint.h"
+#include <unordered_map>
 
 
 namespace KCBox {
@@ -518,7 +520,9 @@ NodeID Partial_CCDD_Manager::Add_Decision_Node( Partial_Decision_Node & bnode, u
 		BigFloat count = _nodes[bnode.Low()].weight;
 		count += _nodes[bnode.High()].weight;
 		count.Div_2exp( 1 );
-		return Add_Known_Node( count, cloc );
+		NodeID known = Add_Known_Node( count, cloc );
+		_nodes[known].frozen = Is_Node_Frozen( bnode.Low() ) || Is_Node_Frozen( bnode.High() );
+		return known;
 	}
 	else return Push_Node( bnode, cloc );
 }
@@ -547,6 +551,26 @@ bool Partial_CCDD_Manager::Is_Node_Known( NodeID n )
 	return path_len == 0;
 }
 
+bool Partial_CCDD_Manager::Is_Node_Frozen( NodeID n )
+{
+	_path[0] = n;
+	_path_mark[0] = 0;
+	unsigned path_len = 1;
+	while ( path_len > 0 ) {
+		NodeID top = _path[path_len - 1];
+		Partial_CDD_Node & topn = _nodes[top];
+		if ( topn.frozen ) return true;
+		if ( topn.sym == SEARCH_KNOWN || topn.sym <= _max_var ) path_len--;  // only decomposition and kernelization nodes are expanded
+		else if ( _path_mark[path_len - 1] < topn.ch_size ) {
+			NodeID child = topn.ch[_path_mark[path_len - 1]++];
+			_path[path_len] = child;
+			_path_mark[path_len++] = 0;
+		}
+		else path_len--;
+	}
+	return false;
+}
+
 NodeID Partial_CCDD_Manager::Add_Decision_Node( Rough_Partial_CDD_Node & rnode, unsigned cloc )
 {
 	assert( rnode.sym <= _max_var && rnode.ch.size() == 2 && rnode.imp.empty() > 0 );
@@ -592,7 +616,10 @@ NodeID Partial_CCDD_Manager::Update_Decision_Child( NodeID parent, bool sign, No
 		BigFloat count = _nodes[old_node.ch[!sign]].weight;
 		count += _nodes[new_child].weight;
 		count.Div_2exp( 1 );
-		return Add_Known_Node( count, old_node.caching_loc );
+		bool frozen = Is_Node_Frozen( old_node.ch[!sign] ) || Is_Node_Frozen( new_child );
+		NodeID known = Add_Known_Node( count, old_node.caching_loc );
+		_nodes[known].frozen = frozen;
+		return known;
 	}
 	Partial_Decision_Node dnode( Variable(old_node.sym), old_node.ch[0], old_node.ch[1], old_node.estimate );
 	Partial_CDD_Node new_node( dnode, old_node.caching_loc );
@@ -670,6 +697,7 @@ void Partial_CCDD_Manager::Remove_Redundant_Nodes( vector<NodeID> & kept_nodes )
 			_nodes[i - num_remove].estimate = _nodes[i].estimate;
 			_nodes[i - num_remove].weight = _nodes[i].weight;
 			_nodes[i - num_remove].models = _nodes[i].models;
+			_nodes[i - num_remove].frozen = _nodes[i].frozen;
 			for ( unsigned j = 0; j < _nodes[i].ch_size; j++ ) {
 				_nodes[i - num_remove].ch[j] = _nodes[_nodes[i].ch[j]].infor.mark;
 			}
@@ -702,6 +730,158 @@ void Partial_CCDD_Manager::Reset_Frequencies()
 	}
 }
 
+unsigned Partial_CCDD_Manager::Freeze_Cold_Nodes( NodeID root, double ratio )
+{
+	assert( _counting_mode && 0 < ratio && ratio < 1 );
+	if ( Is_Fixed( root ) ) return 0;
+	vector<bool> reachable;
+	Mark_Reachable_Nodes( vector<NodeID>( 1, root ), reachable );
+	vector<NodeID> decisions;
+	for ( unsigned i = _num_fixed_nodes; i < _nodes.Size(); i++ ) {
+		if ( reachable[i] && _nodes[i].sym <= _max_var ) decisions.push_back( i );
+	}
+	/// NOTE: the least visited nodes go first, and a larger ID means a more recent update because nodes are persistent
+	auto colder = [this]( NodeID a, NodeID b ) {
+		unsigned freq_a = _nodes[a].freq[0] + _nodes[a].freq[1];
+		unsigned freq_b = _nodes[b].freq[0] + _nodes[b].freq[1];
+		return freq_a < freq_b || ( freq_a == freq_b && a < b );
+	};
+	unsigned num_frozen = decisions.size() * ratio;
+	if ( num_frozen == 0 ) return 0;
+	std::nth_element( decisions.begin(), decisions.begin() + num_frozen - 1, decisions.end(), colder );
+	for ( unsigned i = 0; i < num_frozen; i++ ) {
+		Partial_CDD_Node & node = _nodes[decisions[i]];
+		_main_memory -= node.Memory();
+		delete [] node.ch;
+		node.sym = SEARCH_KNOWN;
+		node.ch_size = 1;
+		node.ch = new NodeID [1];
+		node.ch[0] = NodeID::top;
+		node.frozen = true;  // the weight is kept as the estimate of the evicted subgraph
+		_main_memory += node.Memory();
+	}
+	return num_frozen;
+}
+
+void Partial_CCDD_Manager::Mark_Reachable_Nodes( const vector<NodeID> & roots, vector<bool> & reachable )
+{
+	reachable.assign( _nodes.Size(), false );
+	for ( NodeID root: roots ) {
+		if ( root != NodeID::undef ) reachable[root] = true;
+	}
+	for ( unsigned i = _nodes.Size() - 1; i >= _num_fixed_nodes; i-- ) {  // NOTE: a child is always older than its parents
+		if ( !reachable[i] ) continue;
+		for ( unsigned j = 0; j < _nodes[i].ch_size; j++ ) {
+			reachable[_nodes[i].ch[j]] = true;
+		}
+	}
+}
+
+void Partial_CCDD_Manager::Free_Unreachable_Models( const vector<bool> & reachable, Model_Pool * pool )
+{
+	for ( unsigned i = _num_fixed_nodes; i < _nodes.Size(); i++ ) {
+		if ( reachable[i] || _nodes[i].sym != SEARCH_UNKNOWN ) continue;
+		for ( Model * model: _nodes[i].models ) {
+			pool->Free( model );
+		}
+		_main_memory -= _nodes[i].models.capacity() * sizeof(Model *);
+		_nodes[i].models.clear();
+		_nodes[i].models.shrink_to_fit();
+	}
+}
+
+void Partial_CCDD_Manager::Write_Checkpoint( ostream & out )
+{
+	unordered_map<Model *, unsigned> model_ids;  // a model shared by several nodes is written once
+	vector<Model *> models;
+	for ( unsigned i = _num_fixed_nodes; i < _nodes.Size(); i++ ) {
+		for ( Model * model: _nodes[i].models ) {
+			if ( model_ids.insert( make_pair( model, models.size() ) ).second ) models.push_back( model );
+		}
+	}
+	Write_Binary( out, _num_fixed_nodes );
+	Write_Binary( out, (unsigned) models.size() );
+	for ( Model * model: models ) {
+		model->Write_Binary( _max_var, out );
+	}
+	Write_Binary( out, (unsigned) _nodes.Size() );
+	for ( unsigned i = _num_fixed_nodes; i < _nodes.Size(); i++ ) {
+		const Partial_CDD_Node & node = _nodes[i];
+		Write_Binary( out, node.sym );
+		Write_Binary( out, node.imp_size );
+		for ( unsigned j = 0; j < node.imp_size; j++ ) {
+			Write_Binary( out, node.imp[j] );
+		}
+		Write_Binary( out, node.ch_size );
+		for ( unsigned j = 0; j < node.ch_size; j++ ) {
+			Write_Binary( out, node.ch[j] );
+		}
+		Write_Binary( out, node.caching_loc );
+		Write_Binary( out, node.freq[0] );
+		Write_Binary( out, node.freq[1] );
+		Write_Binary( out, node.estimate );
+		Write_Binary( out, node.weight );
+		Write_Binary( out, node.frozen );
+		Write_Binary( out, (unsigned) node.models.size() );
+		for ( Model * model: node.models ) {
+			Write_Binary( out, model_ids[model] );
+		}
+	}
+}
+
+bool Partial_CCDD_Manager::Read_Checkpoint( istream & in, Model_Pool * pool )
+{
+	assert( _nodes.Size() == _num_fixed_nodes );
+	unsigned num_fixed, num_models, num_nodes;
+	if ( !Read_Binary( in, num_fixed ) || num_fixed != _num_fixed_nodes ) return false;
+	if ( !Read_Binary( in, num_models ) ) return false;
+	vector<Model *> models( num_models );
+	vector<bool> model_used( num_models, false );
+	for ( unsigned i = 0; i < num_models; i++ ) {
+		models[i] = pool->Allocate();
+		if ( !models[i]->Read_Binary( _max_var, in ) ) {
+			models.resize( i + 1 );  // the unused ones are freed below
+			break;
+		}
+	}
+	bool success = (bool) in && Read_Binary( in, num_nodes );
+	for ( unsigned i = _num_fixed_nodes; success && i < num_nodes; i++ ) {
+		unsigned sym, imp_size, ch_size, num_node_models;
+		success = Read_Binary( in, sym ) && Read_Binary( in, imp_size );
+		if ( !success || imp_size > 2 * NumVars( _max_var ) ) break;
+		vector<Literal> imp( imp_size );
+		for ( unsigned j = 0; success && j < imp_size; j++ ) {
+			success = Read_Binary( in, imp[j] );
+		}
+		success = success && Read_Binary( in, ch_size ) && ch_size <= NumVars( _max_var );
+		if ( !success ) break;
+		Partial_CDD_Node node( imp_size, ch_size );
+		node.sym = sym;
+		for ( unsigned j = 0; j < imp_size; j++ ) {
+			node.imp[j] = imp[j];
+		}
+		for ( unsigned j = 0; success && j < ch_size; j++ ) {
+			success = Read_Binary( in, node.ch[j] ) && node.ch[j] < i;  // a child is always older than its parents
+		}
+		success = success && Read_Binary( in, node.caching_loc ) && Read_Binary( in, node.freq[0] ) && Read_Binary( in, node.freq[1] );
+		success = success && Read_Binary( in, node.estimate ) && Read_Binary( in, node.weight ) && Read_Binary( in, node.frozen );
+		success = success && Read_Binary( in, num_node_models );
+		for ( unsigned j = 0; success && j < num_node_models; j++ ) {
+			unsigned id;
+			success = Read_Binary( in, id ) && id < models.size();
+			if ( !success ) break;
+			if ( model_used[id] ) models[id]->Copy();
+			model_used[id] = true;
+			node.models.push_back( models[id] );
+		}
+		Push_Node( node );  /// NOTE: the node is pushed even if incomplete, so that Clear frees its memory
+	}
+	for ( unsigned i = 0; i < models.size(); i++ ) {
+		if ( !model_used[i] ) pool->Free( models[i] );
+	}
+	return success;
+}
+
 void Partial_CCDD_Manager::Display( ostream & out )
 {
 	out << "Maximum variable: " << ExtVar( _max_var ) << endl;
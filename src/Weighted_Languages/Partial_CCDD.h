@@ -96,6 +96,7 @@ public:
 	double estimate;  // the estimate of the marginal distribution of sym for a decision node
 	BigFloat weight;
 	vector<Model *> models;  // record some models of unknown node
+	bool frozen = false;  // a known node whose weight is the last estimate of an evicted subgraph rather than an exact count
 public:
 	Partial_CDD_Node() {}
 	Partial_CDD_Node( unsigned num_imp, unsigned num_ch ): Search_Node( num_imp, num_ch ) {} // allocate memory
@@ -118,7 +119,8 @@ public:
 		 + 2 * sizeof(unsigned)  // freq
 		 + sizeof(double)  // estimate
 		 + sizeof(BigFloat)  // weight
-		 + models.capacity() * sizeof(Model *);
+		 + models.capacity() * sizeof(Model *)
+		 + sizeof(bool);  // frozen
 	}
 	void Display( ostream & out, NodeID id ) const
 	{
@@ -132,6 +134,7 @@ public:
 		else if ( sym == SEARCH_EMPTY ) out << "Empty";
 		else if ( sym == SEARCH_KNOWN ) {
 			out << "Known: " << ch[0] << ", cache " << caching_loc;
+			if ( frozen ) out << ", frozen";
 		}
 		else if ( sym == SEARCH_UNKNOWN ) {
 			out << "Unknown";
@@ -182,7 +185,7 @@ protected:
 	BlockVector<Partial_CDD_Node> _nodes;
 protected: //auxiliary memory
 	Lit_Equivalency _lit_equivalency;
-	size_t _main_memory;
+	Memory_Account<Memory_Nodes> _main_memory;
 	bool _counting_mode;
 public:
 	Partial_CCDD_Manager( Variable max_var, unsigned estimated_num_node = LARGE_HASH_TABLE );
@@ -196,6 +199,11 @@ public:
 	void Open_Counting_Mode() { assert( _nodes.Size() == _num_fixed_nodes );  _counting_mode = true; }
 	void Remove_Redundant_Nodes( vector<NodeID> & kept_nodes );
 	void Reset_Frequencies();
+	unsigned Freeze_Cold_Nodes( NodeID root, double ratio );  // turn the least visited decision nodes below root into frozen known nodes, and return their number
+	void Mark_Reachable_Nodes( const vector<NodeID> & roots, vector<bool> & reachable );
+	void Free_Unreachable_Models( const vector<bool> & reachable, Model_Pool * pool );
+	void Write_Checkpoint( ostream & out );  // the unfixed nodes with their estimates and models, in binary
+	bool Read_Checkpoint( istream & in, Model_Pool * pool );  /// NOTE: only for a manager with only fixed nodes
 	void Display( ostream & out );
 	void Display_Nodes( ostream & out );
 	void Display_Stat( ostream & out );
@@ -239,6 +247,7 @@ public: // transformation
 	bool Sample_Adaptive( Random_Generator & rand_gen, NodeID n, double prob );
 protected:
 	bool Is_Node_Known( NodeID n );
+	bool Is_Node_Frozen( NodeID n );  // whether some frozen node appears in a known node
 protected: // simple inline functions
 	bool Is_False( NodeID n ) const { return n == NodeID::bot; }
 	bool Is_True( NodeID n ) const { return n == NodeID::top; }
@@ -22,6 +22,7 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 
 #include <signal.h>
 #include <zlib.h>
+#include <mutex>
 
 #include "minisat/utils/System.h"
 #include "minisat/utils/ParseUtils.h"
@@ -52,7 +53,30 @@ void printStats(Solver& solver)
 }
 
 
-static Solver* solver = NULL;
+static thread_local Solver* solver = NULL;  // thread_local for the concurrent engines
+
+// Keeps the handlers of the caller: they are restored on return, since the handlers below refer to a solver on the
+// stack, and they stay installed during the call if the caller catches SIGINT itself (a stop request is its business).
+class Signal_Handlers_Keeper
+{
+    struct sigaction old_int, old_term, old_xcpu;
+    bool             caller_owned;
+public:
+    Signal_Handlers_Keeper() {
+        sigaction(SIGINT, NULL, &old_int);
+        sigaction(SIGTERM, NULL, &old_term);
+        sigaction(SIGXCPU, NULL, &old_xcpu);
+        caller_owned = old_int.sa_handler != SIG_DFL; }
+    ~Signal_Handlers_Keeper() {
+        sigaction(SIGINT, &old_int, NULL);
+        sigaction(SIGTERM, &old_term, NULL);
+        sigaction(SIGXCPU, &old_xcpu, NULL); }
+    void install(void handler(int), bool term = false) {
+        if (caller_owned) return;
+        if (term) sigTerm(handler);
+        else { signal(SIGINT, handler); signal(SIGXCPU, handler); } }
+};
+static mutex options_mutex;
 // Terminate by notifying the solver and back out gracefully. This is mainly to have a test-case
 // for this feature of the Solver as it may take longer than an immediate call to '_exit()'.
 static void SIGINT_interrupt(int signum) { solver->interrupt(); }
@@ -95,6 +119,7 @@ static void Solver_AddClauses(vector<vector<int>>& clauses)
 extern int8_t Ext_Solve( vector<vector<int>>& clauses, Extra_Output & output )
 {
     try {
+        unique_lock<mutex> options_lock( options_mutex );  // MiniSat registers options in a global list
         int paramc = 1;
         char* params[1];
         params[0] = "minisat";
@@ -114,17 +139,18 @@ extern int8_t Ext_Solve( vector<vector<int>>& clauses, Extra_Output & output )
         BoolOption   strictp("MAIN", "strict", "Validate DIMACS header during parsing.", false);
 
         parseOptions(paramc, params, true);//{{{printf("here.3\n");fflush(stdin);}}}
+        options_lock.unlock();
 
         CustomizedSolver S;
         double initial_time = cpuTime();
 
         S.verbosity = verb;
 
+        Signal_Handlers_Keeper keeper;
         solver = &S;
         // Use signal handlers that forcibly quit until the solver will be able to respond to
         // interrupts:
-        signal(SIGINT, SIGINT_exit);
-        signal(SIGXCPU,SIGINT_exit);
+        keeper.install(SIGINT_exit);
 
         // Set limit on CPU-time:
         if (cpu_lim != INT32_MAX){
@@ -176,8 +202,7 @@ extern int8_t Ext_Solve( vector<vector<int>>& clauses, Extra_Output & output )
 
         // Change to signal-handlers that will only notify the solver and allow it to terminate
         // voluntarily:
-        signal(SIGINT, SIGINT_interrupt);
-        signal(SIGXCPU,SIGINT_interrupt);
+        keeper.install(SIGINT_interrupt);
 
         if (!solver->simplify()){
             if (solver->verbosity > 0){
@@ -284,6 +309,7 @@ static void Mark_Models( vec<bool> & model_seen, vector<vector<int8_t>> & extmod
 extern bool Ext_Backbone( vector<vector<int>>& clauses, Extra_Output & output )
 {
     try {
+        unique_lock<mutex> options_lock( options_mutex );  // MiniSat registers options in a global list
         int paramc = 1;
         char* params[1];
         params[0] = "minisat";
@@ -303,17 +329,18 @@ extern bool Ext_Backbone( vector<vector<int>>& clauses, Extra_Output & output )
         BoolOption   strictp("MAIN", "strict", "Validate DIMACS header during parsing.", false);
 
         parseOptions(paramc, params, true);//{{{printf("here.3\n");fflush(stdin);}}}
+        options_lock.unlock();
 
         CustomizedSolver S;
         double initial_time = cpuTime();
 
         S.verbosity = verb;
 
+        Signal_Handlers_Keeper keeper;
         solver = &S;
         // Use signal handlers that forcibly quit until the solver will be able to respond to
         // interrupts:
-        signal(SIGINT, SIGINT_exit);
-        signal(SIGXCPU,SIGINT_exit);
+        keeper.install(SIGINT_exit);
 
         // Set limit on CPU-time:
         if (cpu_lim != INT32_MAX){
@@ -365,8 +392,7 @@ extern bool Ext_Backbone( vector<vector<int>>& clauses, Extra_Output & output )
 
         // Change to signal-handlers that will only notify the solver and allow it to terminate
         // voluntarily:
-        signal(SIGINT, SIGINT_interrupt);
-        signal(SIGXCPU,SIGINT_interrupt);
+        keeper.install(SIGINT_interrupt);
 
         if (!solver->simplify()){
             if (solver->verbosity > 0){
@@ -425,6 +451,7 @@ extern bool Ext_Backbone( vector<vector<int>>& clauses, Extra_Output & output )
 extern bool Ext_Block_Literals( vector<vector<int>>& focused, vector<vector<int>>& others, Extra_Output & output )
 {
     try {
+        unique_lock<mutex> options_lock( options_mutex );  // MiniSat registers options in a global list
         int paramc = 1;
         char* params[1];
         params[0] = "minisat";
@@ -444,16 +471,17 @@ extern bool Ext_Block_Literals( vector<vector<int>>& focused, vector<vector<int>
         BoolOption   strictp("MAIN", "strict", "Validate DIMACS header during parsing.", false);
 
         parseOptions(paramc, params, true);//{{{printf("here.3\n");fflush(stdin);}}}
+        options_lock.unlock();
 
         CustomizedSolver S;
 
         S.verbosity = verb;
 
+        Signal_Handlers_Keeper keeper;
         solver = &S;
         // Use signal handlers that forcibly quit until the solver will be able to respond to
         // interrupts:
-        signal(SIGINT, SIGINT_exit);
-        signal(SIGXCPU,SIGINT_exit);
+        keeper.install(SIGINT_exit);
 
         S.Add_Clauses( focused );
         S.Add_Clauses( others );
@@ -461,8 +489,7 @@ extern bool Ext_Block_Literals( vector<vector<int>>& focused, vector<vector<int>
 
         // Change to signal-handlers that will only notify the solver and allow it to terminate
         // voluntarily:
-        signal(SIGINT, SIGINT_interrupt);
-        signal(SIGXCPU,SIGINT_interrupt);
+        keeper.install(SIGINT_interrupt);
 
         if (!solver->simplify()){
             focused.clear();
@@ -510,6 +537,7 @@ extern bool Ext_Block_Literals( vector<vector<int>>& focused, vector<vector<int>
 extern int8_t Ext_SimpSolve( vector<vector<int>> & clauses, Extra_Output & output )
 {
     try {
+        unique_lock<mutex> options_lock( options_mutex );  // MiniSat registers options in a global list
         int paramc = 1;
         char* params[1];
         params[0] = "minisat";
@@ -533,6 +561,7 @@ extern int8_t Ext_SimpSolve( vector<vector<int>> & clauses, Extra_Output & outpu
         BoolOption   strictp("MAIN", "strict", "Validate DIMACS header during parsing.", false);
 
         parseOptions(paramc, params, true);
+        options_lock.unlock();
 
         CustomizedSimpSolver  S;
         double      initial_time = cpuTime();
@@ -541,10 +570,11 @@ extern int8_t Ext_SimpSolve( vector<vector<int>> & clauses, Extra_Output & outpu
 
         S.verbosity = verb;
 
+        Signal_Handlers_Keeper keeper;
         solver = &S;
         // Use signal handlers that forcibly quit until the solver will be able to respond to
         // interrupts:
-        sigTerm(SIGINT_exit);
+        keeper.install(SIGINT_exit, true);
 
         // Try to set resource limits:
         if (cpu_lim != 0) limitTime(cpu_lim);
@@ -574,7 +604,7 @@ extern int8_t Ext_SimpSolve( vector<vector<int>> & clauses, Extra_Output & outpu
 
         // Change to signal-handlers that will only notify the solver and allow it to terminate
         // voluntarily:
-        sigTerm(SIGINT_interrupt);
+        keeper.install(SIGINT_interrupt, true);
 
         S.eliminate(true);
         double simplified_time = cpuTime();
@@ -626,6 +656,7 @@ extern int8_t Ext_SimpSolve( vector<vector<int>> & clauses, Extra_Output & outpu
 extern bool Ext_SimpBackbone( vector<vector<int>>& clauses, Extra_Output & output ) // it has some unknown bug
 {
     try {
+        unique_lock<mutex> options_lock( options_mutex );  // MiniSat registers options in a global list
         int paramc = 1;
         char* params[1];
         params[0] = "minisat";
@@ -649,6 +680,7 @@ extern bool Ext_SimpBackbone( vector<vector<int>>& clauses, Extra_Output & outpu
         BoolOption   strictp("MAIN", "strict", "Validate DIMACS header during parsing.", false);
 
         parseOptions(paramc, params, true);
+        options_lock.unlock();
 
         CustomizedSimpSolver  S;
         double      initial_time = cpuTime();
@@ -657,10 +689,11 @@ extern bool Ext_SimpBackbone( vector<vector<int>>& clauses, Extra_Output & outpu
 
         S.verbosity = verb;
 
+        Signal_Handlers_Keeper keeper;
         solver = &S;
         // Use signal handlers that forcibly quit until the solver will be able to respond to
         // interrupts:
-        sigTerm(SIGINT_exit);
+        keeper.install(SIGINT_exit, true);
 
         // Try to set resource limits:
         if (cpu_lim != 0) limitTime(cpu_lim);
@@ -690,7 +723,7 @@ extern bool Ext_SimpBackbone( vector<vector<int>>& clauses, Extra_Output & outpu
 
         // Change to signal-handlers that will only notify the solver and allow it to terminate
         // voluntarily:
-        sigTerm(SIGINT_interrupt);
+        keeper.install(SIGINT_interrupt, true);
 
         S.eliminate(true);
         double simplified_time = cpuTime();